@@ -1,4 +1,18 @@
 #!/usr/bin/env bash
 set -euo pipefail
 
-echo "Define benchmark commands for this repo in run_perf.sh"
+# Engine performance: in-process phase microbenchmarks + whole-process smoke,
+# each checked against its budget file.
+cmake -S services/engine-cpp -B services/engine-cpp/build -DCMAKE_BUILD_TYPE=Release
+cmake --build services/engine-cpp/build --target scheduler_engine solver_bench
+
+report_dir="$(mktemp -d)"
+trap 'rm -rf "${report_dir}"' EXIT
+
+services/engine-cpp/build/solver_bench --output "${report_dir}/solver-bench.json"
+node scripts/check-engine-benchmark.mjs --input "${report_dir}/solver-bench.json" \
+  --budget docs/benchmarks/solver-bench-budgets.json
+
+node scripts/benchmark-engine.mjs --output "${report_dir}/engine-smoke.json"
+node scripts/check-engine-benchmark.mjs --input "${report_dir}/engine-smoke.json" \
+  --budget docs/benchmarks/engine-smoke-budgets.json
@@ -118,7 +118,8 @@ export const runPlanningCycleController: RequestHandler = async (req, res, next)
       return;
     }
 
-    const result = await runPlanningCycle(cycleId);
+    const { doctorCaps } = (res.locals as PlanningCycleLocals).runPlanningCycleRequest ?? {};
+    const result = await runPlanningCycle(cycleId, undefined, doctorCaps);
     if ('error' in result) {
       if (result.error === 'CYCLE_NOT_FOUND') {
         next(new HttpError(404, { error: 'Planning cycle not found' }));
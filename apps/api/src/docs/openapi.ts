@@ -275,6 +275,37 @@ export const openApiDocument = {
           value: { type: 'integer', minimum: 0 },
           reachableNodes: { type: 'array', items: { type: 'string' } },
           cutEdges: { type: 'array', items: ref('MinCutEdge') },
+          bottlenecks: ref('MinCutBottlenecks'),
+        },
+      },
+      MinCutBottlenecks: {
+        type: 'object',
+        required: ['cappedDoctors', 'periodLimits', 'uncoverableDays'],
+        properties: {
+          cappedDoctors: {
+            type: 'array',
+            items: {
+              type: 'object',
+              required: ['doctorId', 'cap'],
+              properties: { doctorId: { type: 'string' }, cap: { type: 'integer', minimum: 0 } },
+            },
+          },
+          periodLimits: {
+            type: 'array',
+            items: {
+              type: 'object',
+              required: ['doctorId', 'periodId'],
+              properties: { doctorId: { type: 'string' }, periodId: { type: 'string' } },
+            },
+          },
+          uncoverableDays: {
+            type: 'array',
+            items: {
+              type: 'object',
+              required: ['dayId', 'requiredDoctors'],
+              properties: { dayId: { type: 'string' }, requiredDoctors: { type: 'integer', minimum: 0 } },
+            },
+          },
         },
       },
       SolveResponse: {
@@ -287,6 +318,7 @@ export const openApiDocument = {
           uncoveredDays: { type: 'array', items: { type: 'string' } },
           assignments: { type: 'array', items: ref('SolveAssignment') },
           minCut: ref('MinCut'),
+          truncated: { type: 'boolean' },
         },
       },
 
@@ -494,9 +526,20 @@ export const openApiDocument = {
           nextCursor: { type: 'string', format: 'date-time' },
         },
       },
+      CycleDoctorCap: {
+        type: 'object',
+        required: ['doctorId', 'maxCycleDays'],
+        properties: {
+          doctorId: { type: 'string' },
+          maxCycleDays: { type: 'integer', minimum: 0 },
+        },
+      },
       RunPlanningCycleRequest: {
         type: 'object',
         additionalProperties: false,
+        properties: {
+          doctorCaps: { type: 'array', items: ref('CycleDoctorCap') },
+        },
       },
       RunSprintSolveResponse: {
         type: 'object',
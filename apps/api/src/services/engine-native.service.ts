@@ -0,0 +1,219 @@
+import { createRequire } from 'node:module';
+import type { SolveRequest, SolveResponse } from '@scheduler/domain';
+import { EngineRunnerError } from './engine-runner.service.js';
+
+// Shape of services/engine-cpp/node/scheduler_addon.cpp (built with
+// -DSCHEDULER_BUILD_NODE_ADDON=ON). Everything is an index into the arrays
+// passed in, so ids never cross into C++.
+interface NativeProblem {
+  doctorMaxTotalDays: Int32Array;
+  dayRequiredDoctors: Int32Array;
+  periodDayOffsets: Int32Array;
+  periodDays: Int32Array;
+  availability: Int32Array;
+}
+
+// Lists of pairs are flattened: [doctor, cap, doctor, cap, ...].
+interface NativeMinCut {
+  value: number;
+  reachableDoctors: Int32Array;
+  reachableDoctorPeriods: Int32Array;
+  reachableDays: Int32Array;
+  cappedDoctors: Int32Array;
+  periodLimits: Int32Array;
+  cutDays: Int32Array;
+  uncoverableDays: Int32Array;
+}
+
+interface NativeResult {
+  isFeasible: boolean;
+  truncated: boolean;
+  doctors: Int32Array;
+  periods: Int32Array;
+  days: Int32Array;
+  uncoveredDays: Int32Array;
+  minCut?: NativeMinCut;
+}
+
+type MinCut = NonNullable<SolveResponse['minCut']>;
+
+interface SchedulerAddon {
+  abiVersion: number;
+  solve(problem: NativeProblem, options?: { timeBudgetMs?: number }): Promise<NativeResult>;
+}
+
+const SUPPORTED_ABI_VERSION = 1;
+const require = createRequire(import.meta.url);
+const addons = new Map<string, SchedulerAddon>();
+
+function loadAddon(addonPath: string): SchedulerAddon {
+  let addon = addons.get(addonPath);
+  if (!addon) {
+    try {
+      addon = require(addonPath) as SchedulerAddon;
+    } catch (error) {
+      throw new EngineRunnerError(`Engine addon failed to load: ${String(error)}`, 'NATIVE_FAILED');
+    }
+    if (addon.abiVersion !== SUPPORTED_ABI_VERSION) {
+      throw new EngineRunnerError(
+        `Engine addon ABI ${addon.abiVersion} is not supported (expected ${SUPPORTED_ABI_VERSION})`,
+        'NATIVE_FAILED',
+      );
+    }
+    addons.set(addonPath, addon);
+  }
+  return addon;
+}
+
+function idAt(ids: readonly string[], index: number): string {
+  const id = ids[index];
+  if (id === undefined) {
+    throw new EngineRunnerError(`Engine addon returned unknown index ${index}`, 'NATIVE_FAILED');
+  }
+  return id;
+}
+
+function pairs(values: Int32Array): Array<[number, number]> {
+  const result: Array<[number, number]> = [];
+  for (let i = 0; i + 1 < values.length; i += 2) {
+    result.push([values[i] ?? 0, values[i + 1] ?? 0]);
+  }
+  return result;
+}
+
+// Names the addon's cut the way the engine's JSON report does.
+function toMinCut(
+  cut: NativeMinCut,
+  doctorIds: readonly string[],
+  periodIds: readonly string[],
+  dayIds: readonly string[],
+): MinCut {
+  const doctorNode = (doctor: number) => `doctor:${idAt(doctorIds, doctor)}`;
+  const doctorPeriodNode = (doctor: number, period: number) =>
+    `doctor-period:${idAt(doctorIds, doctor)}:${idAt(periodIds, period)}`;
+  const dayNode = (day: number) => `day:${idAt(dayIds, day)}`;
+
+  const cappedDoctors = pairs(cut.cappedDoctors);
+  const periodLimits = pairs(cut.periodLimits);
+  const cutDays = pairs(cut.cutDays);
+  return {
+    value: cut.value,
+    reachableNodes: [
+      'source',
+      ...Array.from(cut.reachableDoctors, doctorNode),
+      ...pairs(cut.reachableDoctorPeriods).map(([doctor, period]) =>
+        doctorPeriodNode(doctor, period),
+      ),
+      ...Array.from(cut.reachableDays, dayNode),
+    ],
+    cutEdges: [
+      ...cappedDoctors.map(([doctor, cap]) => ({
+        from: 'source',
+        to: doctorNode(doctor),
+        capacity: cap,
+      })),
+      ...periodLimits.map(([doctor, period]) => ({
+        from: doctorNode(doctor),
+        to: doctorPeriodNode(doctor, period),
+        capacity: 1,
+      })),
+      ...cutDays.map(([day, required]) => ({ from: dayNode(day), to: 'sink', capacity: required })),
+    ],
+    bottlenecks: {
+      cappedDoctors: cappedDoctors.map(([doctor, cap]) => ({
+        doctorId: idAt(doctorIds, doctor),
+        cap,
+      })),
+      periodLimits: periodLimits.map(([doctor, period]) => ({
+        doctorId: idAt(doctorIds, doctor),
+        periodId: idAt(periodIds, period),
+      })),
+      uncoverableDays: pairs(cut.uncoverableDays).map(([day, requiredDoctors]) => ({
+        dayId: idAt(dayIds, day),
+        requiredDoctors,
+      })),
+    },
+  };
+}
+
+export interface SolveWithAddonOptions {
+  addonPath: string;
+  // 0 disables the budget.
+  timeBudgetMs?: number;
+}
+
+// Same response as the spawned engine, min cut included, without the process
+// or the two JSON round trips. Days referenced only by periods get a zero
+// demand, and availability naming unknown ids is dropped, as the engine's
+// parser does.
+export async function solveWithAddon(
+  request: SolveRequest,
+  options: SolveWithAddonOptions,
+): Promise<SolveResponse> {
+  const addon = loadAddon(options.addonPath);
+
+  const doctorIndex = new Map(request.doctors.map((doctor, index) => [doctor.id, index]));
+  const periodIndex = new Map(request.periods.map((period, index) => [period.id, index]));
+  const dayIds = request.demands.map((demand) => demand.dayId);
+  const dayIndex = new Map(dayIds.map((dayId, index) => [dayId, index]));
+  const requiredDoctors = request.demands.map((demand) => demand.requiredDoctors);
+  const indexOfDay = (dayId: string) => {
+    let index = dayIndex.get(dayId);
+    if (index === undefined) {
+      index = dayIds.push(dayId) - 1;
+      requiredDoctors.push(0);
+      dayIndex.set(dayId, index);
+    }
+    return index;
+  };
+
+  const periodDayOffsets = new Int32Array(request.periods.length + 1);
+  const periodDays: number[] = [];
+  request.periods.forEach((period, index) => {
+    period.dayIds.forEach((dayId) => periodDays.push(indexOfDay(dayId)));
+    periodDayOffsets[index + 1] = periodDays.length;
+  });
+
+  const availability: number[] = [];
+  for (const entry of request.availability) {
+    const doctor = doctorIndex.get(entry.doctorId);
+    const period = periodIndex.get(entry.periodId);
+    const day = dayIndex.get(entry.dayId);
+    if (doctor !== undefined && period !== undefined && day !== undefined) {
+      availability.push(doctor, period, day);
+    }
+  }
+
+  let result: NativeResult;
+  try {
+    result = await addon.solve(
+      {
+        doctorMaxTotalDays: Int32Array.from(request.doctors, (doctor) => doctor.maxTotalDays),
+        dayRequiredDoctors: Int32Array.from(requiredDoctors),
+        periodDayOffsets,
+        periodDays: Int32Array.from(periodDays),
+        availability: Int32Array.from(availability),
+      },
+      { timeBudgetMs: options.timeBudgetMs ?? 0 },
+    );
+  } catch (error) {
+    throw new EngineRunnerError(`Engine addon solve failed: ${String(error)}`, 'NATIVE_FAILED');
+  }
+
+  const doctorIds = request.doctors.map((doctor) => doctor.id);
+  const periodIds = request.periods.map((period) => period.id);
+  const assignments = Array.from(result.doctors, (doctor, i) => ({
+    doctorId: idAt(doctorIds, doctor),
+    dayId: idAt(dayIds, result.days[i] ?? -1),
+    periodId: idAt(periodIds, result.periods[i] ?? -1),
+  }));
+  return {
+    contractVersion: '1.0',
+    isFeasible: result.isFeasible,
+    assignedCount: assignments.length,
+    uncoveredDays: Array.from(result.uncoveredDays, (day) => idAt(dayIds, day)),
+    assignments,
+    ...(result.minCut ? { minCut: toMinCut(result.minCut, doctorIds, periodIds, dayIds) } : {}),
+    ...(result.truncated ? { truncated: true } : {}),
+  };
+}
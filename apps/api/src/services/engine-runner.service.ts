@@ -1,8 +1,16 @@
 import { spawn } from 'node:child_process';
 import { fileURLToPath } from 'node:url';
-import type { SolveRequest, SolveResponse } from '@scheduler/domain';
-
-const DEFAULT_TIMEOUT_MS = 5_000;
+import type {
+  CycleSolveRequest,
+  CycleSolveResponse,
+  SolveRequest,
+  SolveResponse,
+} from '@scheduler/domain';
+
+export const DEFAULT_TIMEOUT_MS = 5_000;
+// Headroom left between the engine's own budget and the hard kill, so a slow
+// solve comes back truncated instead of as a TIMEOUT.
+const ENGINE_BUDGET_MARGIN_MS = 1_000;
 const DEFAULT_ENGINE_BINARY = fileURLToPath(
   new URL('../../../services/engine-cpp/build/scheduler_engine', import.meta.url),
 );
@@ -10,7 +18,7 @@ const DEFAULT_ENGINE_BINARY = fileURLToPath(
 export class EngineRunnerError extends Error {
   constructor(
     message: string,
-    readonly code: 'SPAWN_FAILED' | 'EXIT_NON_ZERO' | 'INVALID_JSON' | 'TIMEOUT',
+    readonly code: 'SPAWN_FAILED' | 'EXIT_NON_ZERO' | 'INVALID_JSON' | 'TIMEOUT' | 'NATIVE_FAILED',
     readonly stderr?: string,
   ) {
     super(message);
@@ -18,19 +26,58 @@ export class EngineRunnerError extends Error {
   }
 }
 
+// Solve budget that leaves the safety margin inside `timeoutMs`; 0 when the
+// timeout is too short for one.
+export function engineTimeBudgetMs(timeoutMs: number): number {
+  return Math.max(0, timeoutMs - ENGINE_BUDGET_MARGIN_MS);
+}
+
 export interface SolveWithEngineOptions {
   engineBinary?: string;
   timeoutMs?: number;
+  // Solve budget passed to the engine (`--time-budget-ms`). Defaults to
+  // `timeoutMs` minus a safety margin; 0 disables it.
+  timeBudgetMs?: number;
+  // Result cache directory shared by every spawn (`--cache-dir`), so repeated
+  // problems skip the solve.
+  cacheDir?: string;
 }
 
 export async function solveWithEngine(
   request: SolveRequest,
   options: SolveWithEngineOptions = {},
 ): Promise<SolveResponse> {
-  const { engineBinary = DEFAULT_ENGINE_BINARY, timeoutMs = DEFAULT_TIMEOUT_MS } = options;
+  return runEngine<SolveResponse>([], request, options);
+}
+
+// Whole planning cycle in one engine run (`--cycle`).
+export async function solveCycleWithEngine(
+  request: CycleSolveRequest,
+  options: SolveWithEngineOptions = {},
+): Promise<CycleSolveResponse> {
+  return runEngine<CycleSolveResponse>(['--cycle'], request, options);
+}
+
+function runEngine<Response>(
+  modeArgs: string[],
+  request: unknown,
+  options: SolveWithEngineOptions,
+): Promise<Response> {
+  const {
+    engineBinary = DEFAULT_ENGINE_BINARY,
+    timeoutMs = DEFAULT_TIMEOUT_MS,
+    timeBudgetMs = engineTimeBudgetMs(timeoutMs),
+  } = options;
+  const args = [...modeArgs];
+  if (timeBudgetMs > 0) {
+    args.push('--time-budget-ms', String(timeBudgetMs));
+  }
+  if (options.cacheDir) {
+    args.push('--cache-dir', options.cacheDir);
+  }
 
   return new Promise((resolve, reject) => {
-    const process = spawn(engineBinary, [], { stdio: ['pipe', 'pipe', 'pipe'] });
+    const process = spawn(engineBinary, args, { stdio: ['pipe', 'pipe', 'pipe'] });
 
     let isSettled = false;
     let stdout = '';
@@ -78,7 +125,7 @@ export async function solveWithEngine(
         }
 
         try {
-          resolve(JSON.parse(stdout) as SolveResponse);
+          resolve(JSON.parse(stdout) as Response);
         } catch (error) {
           reject(new EngineRunnerError(`Engine output is not valid JSON: ${String(error)}`, 'INVALID_JSON'));
         }
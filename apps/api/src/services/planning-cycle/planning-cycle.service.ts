@@ -1,8 +1,17 @@
-import { solveResponseSchema, type PlanningCycle, type PlanningCycleRun, type SolveRequest, type SolveResponse } from '@scheduler/domain';
+import {
+  cycleSolveResponseSchema,
+  solveRequestSchema,
+  type CycleDoctorCap,
+  type CycleSolveRequest,
+  type CycleSolveResponse,
+  type PlanningCycle,
+  type PlanningCycleRun,
+  type SolveRequest,
+} from '@scheduler/domain';
 import { SolverError } from '../../errors/solver.error.js';
 import { mapEngineRunnerError } from '../error-mapper.service.js';
 import { EngineRunnerError } from '../engine-runner.service.js';
-import { solveScheduleWithEngine } from '../solve-schedule.service.js';
+import { solveCycleScheduleWithEngine } from '../solve-schedule.service.js';
 import { findSprintOrNull } from '../sprint/sprint.service.js';
 import { buildSolveRequestFromSprint, registerFailedSprintRun, registerSucceededSprintRun } from '../sprint/sprint-run.service.js';
 import { markSprintSolved } from '../sprint/sprint-ready.service.js';
@@ -16,7 +25,7 @@ import {
   type PlanningCycleRunPageResult,
 } from './planning-cycle.repository.js';
 
-type SolveForSprint = (request: SolveRequest) => Promise<SolveResponse>;
+type SolveCycle = (request: CycleSolveRequest) => Promise<CycleSolveResponse>;
 
 function createPlanningCycleId(): string {
   return `cycle-${Date.now().toString(36)}-${Math.random().toString(36).slice(2, 8)}`;
@@ -132,9 +141,14 @@ export type RunPlanningCycleResult =
   | { run: PlanningCycleRun }
   | { error: 'CYCLE_NOT_FOUND' | 'NO_SPRINTS' };
 
+// Every eligible sprint is solved in one engine run, so `doctorCaps` bound a
+// doctor's days across the whole cycle; sprints that cannot run fail on their
+// own and stay out of the joint solve. That includes sprints whose request
+// breaks the solve contract: the engine would reject the whole cycle for one.
 export async function runPlanningCycle(
   cycleId: string,
-  solveForSprint: SolveForSprint = solveScheduleWithEngine,
+  solveCycle: SolveCycle = solveCycleScheduleWithEngine,
+  doctorCaps: CycleDoctorCap[] = [],
 ): Promise<RunPlanningCycleResult> {
   const cycle = await getPlanningCycleById(cycleId);
   if (!cycle) {
@@ -145,18 +159,23 @@ export async function runPlanningCycle(
     return { error: 'NO_SPRINTS' };
   }
 
-  const items: PlanningCycleRun['items'] = [];
+  const itemsBySprint = new Map<string, PlanningCycleRun['items'][number]>();
+  const eligible: Array<{ sprintId: string; request: SolveRequest }> = [];
 
   for (const sprintId of cycle.sprintIds) {
     const executedAt = new Date().toISOString();
     const sprint = await findSprintOrNull(sprintId);
     if (!sprint) {
-      items.push(createFailedItem(sprintId, { code: 'SPRINT_NOT_FOUND', message: 'Sprint not found' }, executedAt));
+      itemsBySprint.set(
+        sprintId,
+        createFailedItem(sprintId, { code: 'SPRINT_NOT_FOUND', message: 'Sprint not found' }, executedAt),
+      );
       continue;
     }
 
     if (sprint.status !== 'ready-to-solve') {
-      items.push(
+      itemsBySprint.set(
+        sprintId,
         createFailedItem(sprintId, { code: 'SPRINT_NOT_READY', message: 'Sprint is not ready to solve' }, executedAt),
       );
       continue;
@@ -164,7 +183,8 @@ export async function runPlanningCycle(
 
     const buildResult = await buildSolveRequestFromSprint(sprintId);
     if ('error' in buildResult) {
-      items.push(
+      itemsBySprint.set(
+        sprintId,
         createFailedItem(
           sprintId,
           { code: buildResult.error, message: 'Sprint data is not ready for solve' },
@@ -174,46 +194,81 @@ export async function runPlanningCycle(
       continue;
     }
 
-    const solveRequest = buildResult.request;
+    const parsedRequest = solveRequestSchema.safeParse(buildResult.request);
+    if (!parsedRequest.success) {
+      const issues = parsedRequest.error.issues
+        .map((issue) => `${issue.path.join('.')}: ${issue.message}`)
+        .join('; ');
+      itemsBySprint.set(
+        sprintId,
+        createFailedItem(
+          sprintId,
+          {
+            code: 'INVALID_SOLVE_REQUEST',
+            message: `Sprint data is not a valid solve request (${issues})`,
+          },
+          executedAt,
+        ),
+      );
+      continue;
+    }
+
+    eligible.push({ sprintId, request: parsedRequest.data });
+  }
+
+  if (eligible.length > 0) {
+    const failAll = async (failure: PlanningCycleRunFailure) => {
+      const executedAt = new Date().toISOString();
+      for (const { sprintId, request } of eligible) {
+        await registerFailedSprintRun(sprintId, request, failure.code, failure.message);
+        itemsBySprint.set(sprintId, createFailedItem(sprintId, failure, executedAt, request));
+      }
+    };
+
     try {
-      const rawResponse = await solveForSprint(solveRequest);
-      const parsedResponse = solveResponseSchema.safeParse(rawResponse);
-      if (!parsedResponse.success) {
-        await registerFailedSprintRun(sprintId, solveRequest, 'INTERNAL_CONTRACT_MISMATCH', 'Internal contract mismatch');
-        items.push(
-          createFailedItem(
+      const rawResponse = await solveCycle({
+        contractVersion: '1.0',
+        ...(doctorCaps.length > 0 ? { doctorCaps } : {}),
+        sprints: eligible.map(({ sprintId, request }) => ({ id: sprintId, problem: request })),
+      });
+      const parsedResponse = cycleSolveResponseSchema.safeParse(rawResponse);
+      const responses = parsedResponse.success ? parsedResponse.data.sprints : [];
+      const results = new Map(responses.map((entry) => [entry.sprintId, entry.result] as const));
+      const solved = eligible.flatMap((entry) => {
+        const response = results.get(entry.sprintId);
+        return response ? [{ ...entry, response }] : [];
+      });
+      if (solved.length !== eligible.length) {
+        await failAll({ code: 'INTERNAL_CONTRACT_MISMATCH', message: 'Internal contract mismatch' });
+      } else {
+        const executedAt = new Date().toISOString();
+        for (const { sprintId, request, response } of solved) {
+          await registerSucceededSprintRun(sprintId, request, response);
+          await markSprintSolved(sprintId);
+          itemsBySprint.set(sprintId, {
             sprintId,
-            { code: 'INTERNAL_CONTRACT_MISMATCH', message: 'Internal contract mismatch' },
             executedAt,
-            solveRequest,
-          ),
-        );
-        continue;
+            status: 'succeeded',
+            inputSnapshot: request,
+            outputSnapshot: response,
+          });
+        }
       }
-
-      await registerSucceededSprintRun(sprintId, solveRequest, parsedResponse.data);
-      await markSprintSolved(sprintId);
-      items.push({
-        sprintId,
-        executedAt,
-        status: 'succeeded',
-        inputSnapshot: solveRequest,
-        outputSnapshot: parsedResponse.data,
-      });
     } catch (error) {
       if (error instanceof EngineRunnerError) {
         const mapped = mapEngineRunnerError(error);
-        await registerFailedSprintRun(sprintId, solveRequest, mapped.code, mapped.message);
-        items.push(createFailedItem(sprintId, { code: mapped.code, message: mapped.message }, executedAt, solveRequest));
-        continue;
+        await failAll({ code: mapped.code, message: mapped.message });
+      } else {
+        const fallback = new SolverError(500, 'UNEXPECTED_ERROR', 'Unexpected solver failure');
+        await failAll({ code: fallback.code, message: fallback.message });
       }
-
-      const fallback = new SolverError(500, 'UNEXPECTED_ERROR', 'Unexpected solver failure');
-      await registerFailedSprintRun(sprintId, solveRequest, fallback.code, fallback.message);
-      items.push(createFailedItem(sprintId, { code: fallback.code, message: fallback.message }, executedAt, solveRequest));
     }
   }
 
+  const items = cycle.sprintIds.flatMap((sprintId) => {
+    const item = itemsBySprint.get(sprintId);
+    return item ? [item] : [];
+  });
   const run: PlanningCycleRun = {
     id: createPlanningCycleRunId(),
     cycleId,
@@ -1,7 +1,58 @@
-import type { SolveRequest, SolveResponse } from '@scheduler/domain';
-import { solveWithEngine } from './engine-runner.service.js';
+import type {
+  CycleSolveRequest,
+  CycleSolveResponse,
+  SolveRequest,
+  SolveResponse,
+} from '@scheduler/domain';
+import { solveWithAddon } from './engine-native.service.js';
+import {
+  DEFAULT_TIMEOUT_MS,
+  engineTimeBudgetMs,
+  solveCycleWithEngine,
+  solveWithEngine,
+  type SolveWithEngineOptions,
+} from './engine-runner.service.js';
 
-export async function solveScheduleWithEngine(request: SolveRequest): Promise<SolveResponse> {
+// A cycle is one solve over every sprint, so it gets the single-solve timeout
+// per sprint, up to this cap.
+const MAX_CYCLE_TIMEOUT_MS = 30_000;
+
+export function cycleTimeoutMs(sprintCount: number): number {
+  return Math.min(MAX_CYCLE_TIMEOUT_MS, DEFAULT_TIMEOUT_MS * Math.max(1, sprintCount));
+}
+
+// Spawn options from the environment. Cycle runs skip the result cache, which
+// the engine only consults for single solves.
+function engineOptions(timeoutMs: number, options: { useCache: boolean }): SolveWithEngineOptions {
   const engineBinary = process.env.SCHEDULER_ENGINE_BINARY;
-  return solveWithEngine(request, engineBinary ? { engineBinary, timeoutMs: 5_000 } : { timeoutMs: 5_000 });
+  const cacheDir = options.useCache ? process.env.SCHEDULER_ENGINE_CACHE_DIR : undefined;
+  return {
+    timeoutMs,
+    ...(engineBinary ? { engineBinary } : {}),
+    ...(cacheDir ? { cacheDir } : {}),
+  };
+}
+
+export async function solveScheduleWithEngine(request: SolveRequest): Promise<SolveResponse> {
+  // The in-process addon takes precedence over spawning the engine binary. It
+  // cannot be killed, so it gets the budget a spawned engine would.
+  const engineAddon = process.env.SCHEDULER_ENGINE_ADDON;
+  if (engineAddon) {
+    return solveWithAddon(request, {
+      addonPath: engineAddon,
+      timeBudgetMs: engineTimeBudgetMs(DEFAULT_TIMEOUT_MS),
+    });
+  }
+
+  return solveWithEngine(request, engineOptions(DEFAULT_TIMEOUT_MS, { useCache: true }));
+}
+
+// The addon has no cycle entry point, so cycles always go through the binary.
+export async function solveCycleScheduleWithEngine(
+  request: CycleSolveRequest,
+): Promise<CycleSolveResponse> {
+  return solveCycleWithEngine(
+    request,
+    engineOptions(cycleTimeoutMs(request.sprints.length), { useCache: false }),
+  );
 }
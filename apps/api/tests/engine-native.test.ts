@@ -0,0 +1,186 @@
+import { beforeEach, describe, expect, it, vi } from 'vitest';
+import type { SolveRequest } from '@scheduler/domain';
+
+const { addons } = vi.hoisted(() => ({ addons: new Map<string, unknown>() }));
+
+vi.mock('node:module', () => ({
+  createRequire: () => (path: string) => {
+    if (!addons.has(path)) {
+      throw new Error(`Cannot find module '${path}'`);
+    }
+    return addons.get(path);
+  },
+}));
+
+import { solveWithAddon } from '../src/services/engine-native.service.js';
+
+interface NativeProblem {
+  doctorMaxTotalDays: Int32Array;
+  dayRequiredDoctors: Int32Array;
+  periodDayOffsets: Int32Array;
+  periodDays: Int32Array;
+  availability: Int32Array;
+}
+
+const emptyResult = {
+  isFeasible: true,
+  truncated: false,
+  doctors: Int32Array.of(),
+  periods: Int32Array.of(),
+  days: Int32Array.of(),
+  uncoveredDays: Int32Array.of(),
+};
+
+const request: SolveRequest = {
+  contractVersion: '1.0',
+  doctors: [
+    { id: 'd1', maxTotalDays: 2 },
+    { id: 'd2', maxTotalDays: 1 },
+  ],
+  periods: [
+    { id: 'p1', dayIds: ['day-1', 'day-2'] },
+    { id: 'p2', dayIds: ['day-3'] },
+  ],
+  demands: [
+    { dayId: 'day-1', requiredDoctors: 1 },
+    { dayId: 'day-3', requiredDoctors: 2 },
+  ],
+  availability: [
+    { doctorId: 'd1', periodId: 'p1', dayId: 'day-1' },
+    { doctorId: 'd2', periodId: 'p2', dayId: 'day-3' },
+    { doctorId: 'ghost', periodId: 'p1', dayId: 'day-1' },
+    { doctorId: 'd1', periodId: 'p9', dayId: 'day-1' },
+    { doctorId: 'd1', periodId: 'p1', dayId: 'day-9' },
+  ],
+};
+
+let addonCount = 0;
+
+// Registers a fresh addon under its own path, so the service's per-path cache
+// never hands one test another test's mock.
+function mockAddon(result: object = emptyResult, abiVersion = 1) {
+  const solve = vi.fn<(problem: NativeProblem, options?: object) => Promise<object>>(
+    async () => result,
+  );
+  const addonPath = `/mock/scheduler_native_${addonCount++}.node`;
+  addons.set(addonPath, { abiVersion, solve });
+  return { addonPath, solve };
+}
+
+function sentProblem(solve: ReturnType<typeof mockAddon>['solve']): NativeProblem {
+  const problem = solve.mock.calls[0]?.[0];
+  if (!problem) {
+    throw new Error('addon.solve was not called');
+  }
+  return problem;
+}
+
+describe('solveWithAddon', () => {
+  beforeEach(() => {
+    addons.clear();
+  });
+
+  it('sends the request as index arrays and maps the assignments back to ids', async () => {
+    const { addonPath, solve } = mockAddon({
+      ...emptyResult,
+      isFeasible: false,
+      doctors: Int32Array.of(0, 1),
+      periods: Int32Array.of(0, 1),
+      days: Int32Array.of(0, 1),
+      uncoveredDays: Int32Array.of(1),
+    });
+
+    const response = await solveWithAddon(request, { addonPath, timeBudgetMs: 250 });
+
+    const problem = sentProblem(solve);
+    expect(Array.from(problem.doctorMaxTotalDays)).toEqual([2, 1]);
+    expect(Array.from(problem.periodDayOffsets)).toEqual([0, 2, 3]);
+    expect(solve.mock.calls[0]?.[1]).toEqual({ timeBudgetMs: 250 });
+    expect(response).toEqual({
+      contractVersion: '1.0',
+      isFeasible: false,
+      assignedCount: 2,
+      uncoveredDays: ['day-3'],
+      assignments: [
+        { doctorId: 'd1', dayId: 'day-1', periodId: 'p1' },
+        { doctorId: 'd2', dayId: 'day-3', periodId: 'p2' },
+      ],
+    });
+  });
+
+  it('gives days that only appear in periods a zero demand', async () => {
+    const { addonPath, solve } = mockAddon();
+
+    await solveWithAddon(request, { addonPath });
+
+    const problem = sentProblem(solve);
+    // day-1 and day-3 keep their demand indices; day-2 is appended after them.
+    expect(Array.from(problem.dayRequiredDoctors)).toEqual([1, 2, 0]);
+    expect(Array.from(problem.periodDays)).toEqual([0, 2, 1]);
+  });
+
+  it('drops availability that names an unknown doctor, period or day', async () => {
+    const { addonPath, solve } = mockAddon();
+
+    await solveWithAddon(request, { addonPath });
+
+    expect(Array.from(sentProblem(solve).availability)).toEqual([0, 0, 0, 1, 1, 1]);
+  });
+
+  it('passes a truncated result through and leaves the flag off otherwise', async () => {
+    const truncated = mockAddon({ ...emptyResult, isFeasible: false, truncated: true });
+    const complete = mockAddon();
+
+    expect(await solveWithAddon(request, { addonPath: truncated.addonPath })).toMatchObject({
+      truncated: true,
+    });
+    expect(await solveWithAddon(request, { addonPath: complete.addonPath })).not.toHaveProperty(
+      'truncated',
+    );
+  });
+
+  it('names the min cut the way the engine report does', async () => {
+    const { addonPath } = mockAddon({
+      ...emptyResult,
+      isFeasible: false,
+      minCut: {
+        value: 4,
+        reachableDoctors: Int32Array.of(1),
+        reachableDoctorPeriods: Int32Array.of(1, 1),
+        reachableDays: Int32Array.of(2),
+        cappedDoctors: Int32Array.of(0, 2),
+        periodLimits: Int32Array.of(1, 1),
+        cutDays: Int32Array.of(2, 1),
+        uncoverableDays: Int32Array.of(1, 2),
+      },
+    });
+
+    const response = await solveWithAddon(request, { addonPath });
+
+    expect(response.minCut).toEqual({
+      value: 4,
+      reachableNodes: ['source', 'doctor:d2', 'doctor-period:d2:p2', 'day:day-2'],
+      cutEdges: [
+        { from: 'source', to: 'doctor:d1', capacity: 2 },
+        { from: 'doctor:d2', to: 'doctor-period:d2:p2', capacity: 1 },
+        { from: 'day:day-2', to: 'sink', capacity: 1 },
+      ],
+      bottlenecks: {
+        cappedDoctors: [{ doctorId: 'd1', cap: 2 }],
+        periodLimits: [{ doctorId: 'd2', periodId: 'p2' }],
+        uncoverableDays: [{ dayId: 'day-3', requiredDoctors: 2 }],
+      },
+    });
+  });
+
+  it('fails with NATIVE_FAILED on a missing addon, another ABI or a bad index', async () => {
+    const otherAbi = mockAddon(emptyResult, 2);
+    const badIndex = mockAddon({ ...emptyResult, uncoveredDays: Int32Array.of(7) });
+
+    for (const addonPath of ['/mock/missing.node', otherAbi.addonPath, badIndex.addonPath]) {
+      await expect(solveWithAddon(request, { addonPath }), addonPath).rejects.toMatchObject({
+        code: 'NATIVE_FAILED',
+      });
+    }
+  });
+});
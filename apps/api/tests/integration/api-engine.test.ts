@@ -1,14 +1,19 @@
-import { accessSync, constants as fsConstants, readFileSync } from 'node:fs';
+import { accessSync, constants as fsConstants, existsSync, readFileSync } from 'node:fs';
 import { fileURLToPath } from 'node:url';
 import { describe, expect, it, vi } from 'vitest';
 import type { SolveRequest } from '@scheduler/domain';
 import { createSolveScheduleController } from '../../src/controllers/schedule.controller.js';
 import { validateSolveRequestMiddleware } from '../../src/middlewares/validate-solve-request.middleware.js';
+import { solveWithAddon } from '../../src/services/engine-native.service.js';
+import { solveWithEngine } from '../../src/services/engine-runner.service.js';
 import { solveScheduleWithEngine } from '../../src/services/solve-schedule.service.js';
 
 const defaultEngineBinary = fileURLToPath(
   new URL('../../../../services/engine-cpp/build/scheduler_engine', import.meta.url),
 );
+const defaultEngineAddon = fileURLToPath(
+  new URL('../../../../services/engine-cpp/build/scheduler_native.node', import.meta.url),
+);
 const fixturesDir = fileURLToPath(new URL('../../../../packages/domain/fixtures', import.meta.url));
 
 type FixtureCatalogEntry = {
@@ -101,3 +106,22 @@ describe('API-engine integration', () => {
     });
   });
 });
+
+describe('API-engine addon parity', () => {
+  const engineBinary = process.env.SCHEDULER_ENGINE_BINARY ?? defaultEngineBinary;
+  const engineAddon = process.env.SCHEDULER_ENGINE_ADDON ?? defaultEngineAddon;
+  const describeIf = hasExecutable(engineBinary) && existsSync(engineAddon) ? describe : describe.skip;
+  const validFixtures = fixtureCatalog.filter((fixture) => fixture.expectSchemaValid && fixture.expectedSolver);
+
+  describeIf('addon vs spawned engine', () => {
+    it('returns the same response, min cut included, for every valid shared fixture', async () => {
+      for (const fixture of validFixtures) {
+        const request = loadRequestFixture(fixture.requestFile);
+        const spawned = await solveWithEngine(request, { engineBinary, timeBudgetMs: 0 });
+        const native = await solveWithAddon(request, { addonPath: engineAddon, timeBudgetMs: 0 });
+
+        expect(native, fixture.id).toEqual(spawned);
+      }
+    });
+  });
+});
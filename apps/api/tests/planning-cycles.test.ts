@@ -1,4 +1,5 @@
 import { beforeEach, describe, expect, it, vi } from 'vitest';
+import type { CycleSolveRequest } from '@scheduler/domain';
 import { createDoctor, clearDoctorStore } from '../src/services/doctor/doctor.repository.js';
 import { clearPeriodStore, createPeriod } from '../src/services/period/period.repository.js';
 import { clearSprintStore } from '../src/services/sprint/sprint.repository.js';
@@ -18,6 +19,7 @@ import {
   runPlanningCycle,
 } from '../src/services/planning-cycle/planning-cycle.service.js';
 import { clearPlanningCycleStore } from '../src/services/planning-cycle/planning-cycle.repository.js';
+import { cycleTimeoutMs } from '../src/services/solve-schedule.service.js';
 import {
   validateAddPlanningCycleSprintMiddleware,
   validateCreatePlanningCycleMiddleware,
@@ -123,13 +125,28 @@ describe('planning cycle controllers and services', () => {
     await addSprintToPlanningCycle(cycle.id, readySprint.id);
     await addSprintToPlanningCycle(cycle.id, draftSprint.id);
 
-    const result = await runPlanningCycle(cycle.id, async () => ({
-      contractVersion: '1.0',
+    const solveCycle = vi.fn(async (request: CycleSolveRequest) => ({
+      contractVersion: '1.0' as const,
       isFeasible: true,
       assignedCount: 1,
-      uncoveredDays: [],
-      assignments: [{ doctorId: doctor.id, periodId: period.id, dayId: '2026-04-01' }],
+      sprints: request.sprints.map((sprint) => ({
+        sprintId: sprint.id,
+        result: {
+          contractVersion: '1.0' as const,
+          isFeasible: true,
+          assignedCount: 1,
+          uncoveredDays: [],
+          assignments: [{ doctorId: doctor.id, periodId: period.id, dayId: '2026-04-01' }],
+        },
+      })),
     }));
+    const doctorCaps = [{ doctorId: doctor.id, maxCycleDays: 3 }];
+    const result = await runPlanningCycle(cycle.id, solveCycle, doctorCaps);
+
+    expect(solveCycle).toHaveBeenCalledTimes(1);
+    const cycleRequest = solveCycle.mock.calls[0]?.[0];
+    expect(cycleRequest?.doctorCaps).toEqual(doctorCaps);
+    expect(cycleRequest?.sprints.map((sprint) => sprint.id)).toEqual([readySprint.id]);
 
     expect('run' in result).toBe(true);
     if (!('run' in result)) {
@@ -137,7 +154,78 @@ describe('planning cycle controllers and services', () => {
     }
     expect(result.run.status).toBe('partial-failed');
     expect(result.run.items.length).toBe(2);
-    expect(result.run.items.some((item) => item.status === 'failed')).toBe(true);
+    expect(result.run.items.map((item) => item.sprintId)).toEqual([readySprint.id, draftSprint.id]);
+    expect(result.run.items.map((item) => item.status)).toEqual(['succeeded', 'failed']);
+  }, 20_000);
+
+  it('keeps a sprint with an invalid solve request out of the joint solve', async () => {
+    const doctor = await createDoctor({ name: 'Dr. Uno', active: true, maxTotalDaysDefault: 8 });
+    const validPeriod = await createPeriod({
+      name: 'Mayo 2026',
+      startsOn: '2026-05-01',
+      endsOn: '2026-05-01',
+      demands: [{ dayId: '2026-05-01', requiredDoctors: 1 }],
+    });
+    // A zero demand breaks the solve contract (requiredDoctors must be positive).
+    const invalidPeriod = await createPeriod({
+      name: 'Junio 2026',
+      startsOn: '2026-06-01',
+      endsOn: '2026-06-01',
+      demands: [{ dayId: '2026-06-01', requiredDoctors: 0 }],
+    });
+
+    const createReadySprint = async (period: typeof validPeriod) => {
+      const sprint = await createSprint({
+        name: `Sprint ${period.name}`,
+        periodId: period.id,
+        globalConfig: { requiredDoctorsPerShift: 1, maxDaysPerDoctorDefault: 8 },
+        doctorIds: [doctor.id],
+      });
+      await updateDoctorAvailability(
+        sprint.id,
+        doctor.id,
+        [{ periodId: period.id, dayId: period.startsOn }],
+        { role: 'planner', userId: 'planner-1' },
+      );
+      await markSprintReadyToSolve(sprint.id);
+      return sprint;
+    };
+    const validSprint = await createReadySprint(validPeriod);
+    const invalidSprint = await createReadySprint(invalidPeriod);
+
+    const cycle = await createPlanningCycle({ name: 'Q2 Invalid' });
+    await addSprintToPlanningCycle(cycle.id, validSprint.id);
+    await addSprintToPlanningCycle(cycle.id, invalidSprint.id);
+
+    const solveCycle = vi.fn(async (request: CycleSolveRequest) => ({
+      contractVersion: '1.0' as const,
+      isFeasible: true,
+      assignedCount: 1,
+      sprints: request.sprints.map((sprint) => ({
+        sprintId: sprint.id,
+        result: {
+          contractVersion: '1.0' as const,
+          isFeasible: true,
+          assignedCount: 1,
+          uncoveredDays: [],
+          assignments: [{ doctorId: doctor.id, periodId: validPeriod.id, dayId: '2026-05-01' }],
+        },
+      })),
+    }));
+    const result = await runPlanningCycle(cycle.id, solveCycle);
+
+    expect(solveCycle).toHaveBeenCalledTimes(1);
+    const cycleRequest = solveCycle.mock.calls[0]?.[0];
+    expect(cycleRequest?.sprints.map((sprint) => sprint.id)).toEqual([validSprint.id]);
+    if (!('run' in result)) {
+      throw new Error('Expected a planning cycle run');
+    }
+    expect(result.run.status).toBe('partial-failed');
+    expect(result.run.items.map((item) => [item.sprintId, item.status])).toEqual([
+      [validSprint.id, 'succeeded'],
+      [invalidSprint.id, 'failed'],
+    ]);
+    expect(result.run.items[1]?.error?.code).toBe('INVALID_SOLVE_REQUEST');
   }, 20_000);
 
   it('returns 422 from controller when running empty planning cycle', async () => {
@@ -169,3 +257,12 @@ describe('planning cycle controllers and services', () => {
     expect(res.json).toHaveBeenCalledWith(expect.objectContaining({ items: expect.any(Array) }));
   });
 });
+
+describe('cycleTimeoutMs', () => {
+  it('gives the engine one single-solve timeout per sprint, up to a cap', () => {
+    expect(cycleTimeoutMs(0)).toBe(5_000);
+    expect(cycleTimeoutMs(1)).toBe(5_000);
+    expect(cycleTimeoutMs(3)).toBe(15_000);
+    expect(cycleTimeoutMs(12)).toBe(30_000);
+  });
+});
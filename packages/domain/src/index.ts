@@ -140,10 +140,40 @@ export const minCutEdgeSchema = z.object({
   capacity: z.number().int().nonnegative(),
 });
 
+export const minCutBottlenecksSchema = z.object({
+  cappedDoctors: z.array(z.object({ doctorId: z.string().min(1), cap: z.number().int().nonnegative() })),
+  periodLimits: z.array(z.object({ doctorId: z.string().min(1), periodId: z.string().min(1) })),
+  uncoverableDays: z.array(z.object({ dayId: z.string().min(1), requiredDoctors: z.number().int().nonnegative() })),
+});
+
 export const minCutSchema = z.object({
   value: z.number().int().nonnegative(),
   reachableNodes: z.array(z.string().min(1)),
   cutEdges: z.array(minCutEdgeSchema),
+  bottlenecks: minCutBottlenecksSchema.optional(),
+});
+
+export const solveStatsSchema = z.object({
+  phasesMs: z.object({
+    parse: z.number().nonnegative(),
+    build: z.number().nonnegative(),
+    maxFlow: z.number().nonnegative(),
+    extract: z.number().nonnegative(),
+    serialize: z.number().nonnegative(),
+  }),
+  network: z.object({
+    components: z.number().int().nonnegative(),
+    nodes: z.number().int().nonnegative(),
+    arcs: z.number().int().nonnegative(),
+  }),
+  maxFlow: z.object({
+    phases: z.number().int().nonnegative(),
+    augmentations: z.number().int().nonnegative(),
+    relabels: z.number().int().nonnegative(),
+    arcsScanned: z.number().int().nonnegative(),
+    warmStartFlow: z.number().int().nonnegative(),
+  }),
+  peakRssKb: z.number().int().nonnegative(),
 });
 
 export const solveResponseSchema = z.object({
@@ -153,6 +183,8 @@ export const solveResponseSchema = z.object({
   uncoveredDays: z.array(z.string()),
   assignments: z.array(assignmentSchema),
   minCut: minCutSchema.optional(),
+  truncated: z.boolean().optional(),
+  stats: solveStatsSchema.optional(),
 });
 
 export const doctorCatalogSchema = z.object({
@@ -424,7 +456,40 @@ export const addPlanningCycleSprintRequestSchema = z.object({
   orderIndex: z.number().int().positive().optional(),
 });
 
-export const runPlanningCycleRequestSchema = z.object({}).strict();
+export const cycleDoctorCapSchema = z.object({
+  doctorId: z.string().min(1),
+  maxCycleDays: z.number().int().nonnegative(),
+});
+
+export const runPlanningCycleRequestSchema = z
+  .object({
+    doctorCaps: z.array(cycleDoctorCapSchema).optional(),
+  })
+  .strict();
+
+export const cycleSolveRequestSchema = z.object({
+  contractVersion: contractVersionSchema.default('1.0'),
+  doctorCaps: z.array(cycleDoctorCapSchema).optional(),
+  sprints: z.array(
+    z.object({
+      id: z.string().min(1),
+      problem: solveRequestSchema,
+    }),
+  ),
+});
+
+export const cycleSolveResponseSchema = z.object({
+  contractVersion: contractVersionSchema.default('1.0'),
+  isFeasible: z.boolean(),
+  assignedCount: z.number().int().nonnegative(),
+  sprints: z.array(
+    z.object({
+      sprintId: z.string().min(1),
+      result: solveResponseSchema,
+    }),
+  ),
+  truncated: z.boolean().optional(),
+});
 
 export const planningCycleRunItemSchema = z.object({
   sprintId: z.string().min(1),
@@ -460,6 +525,7 @@ export const planningCycleRunListResponseSchema = z.object({
 
 export type SolveRequest = z.infer<typeof solveRequestSchema>;
 export type SolveResponse = z.infer<typeof solveResponseSchema>;
+export type SolveStats = z.infer<typeof solveStatsSchema>;
 export type DoctorCatalog = z.infer<typeof doctorCatalogSchema>;
 export type CreateDoctorRequest = z.infer<typeof createDoctorRequestSchema>;
 export type UpdateDoctorRequest = z.infer<typeof updateDoctorRequestSchema>;
@@ -489,6 +555,9 @@ export type PlanningCycle = z.infer<typeof planningCycleSchema>;
 export type CreatePlanningCycleRequest = z.infer<typeof createPlanningCycleRequestSchema>;
 export type AddPlanningCycleSprintRequest = z.infer<typeof addPlanningCycleSprintRequestSchema>;
 export type RunPlanningCycleRequest = z.infer<typeof runPlanningCycleRequestSchema>;
+export type CycleDoctorCap = z.infer<typeof cycleDoctorCapSchema>;
+export type CycleSolveRequest = z.infer<typeof cycleSolveRequestSchema>;
+export type CycleSolveResponse = z.infer<typeof cycleSolveResponseSchema>;
 export type PlanningCycleRunStatus = z.infer<typeof planningCycleRunStatusSchema>;
 export type PlanningCycleRunItem = z.infer<typeof planningCycleRunItemSchema>;
 export type PlanningCycleRun = z.infer<typeof planningCycleRunSchema>;
@@ -133,6 +133,28 @@ describe('solveResponseSchema', () => {
     expect(result.success).toBe(true);
   });
 
+  it('accepts minCut bottlenecks', () => {
+    const result = solveResponseSchema.safeParse({
+      contractVersion: '1.0',
+      isFeasible: false,
+      assignedCount: 1,
+      uncoveredDays: ['day-2', 'day-3'],
+      assignments: [{ doctorId: 'd1', dayId: 'day-1', periodId: 'p1' }],
+      minCut: {
+        value: 1,
+        reachableNodes: ['source', 'doctor:d1'],
+        cutEdges: [{ from: 'doctor:d1', to: 'doctor-period:d1:p1', capacity: 1 }],
+        bottlenecks: {
+          cappedDoctors: [],
+          periodLimits: [{ doctorId: 'd1', periodId: 'p1' }],
+          uncoverableDays: [{ dayId: 'day-3', requiredDoctors: 1 }],
+        },
+      },
+    });
+
+    expect(result.success).toBe(true);
+  });
+
   it('rejects invalid minCut capacity', () => {
     const result = solveResponseSchema.safeParse({
       isFeasible: true,
@@ -0,0 +1,75 @@
+#include "roster_generator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace scheduler::bench {
+
+std::string GenerateRoster(const RosterShape& shape) {
+  std::mt19937 rng(shape.seed);
+  std::uniform_real_distribution<double> coin(0.0, 1.0);
+  std::uniform_int_distribution<int> cap(shape.max_total_days >= 0 ? shape.min_total_days : 1,
+                                         shape.max_total_days >= 0 ? shape.max_total_days : std::max(1, shape.periods));
+  std::uniform_int_distribution<int> required(1, std::max(1, shape.max_required));
+
+  nlohmann::ordered_json request;
+  request["contractVersion"] = "1.0";
+  request["doctors"] = nlohmann::ordered_json::array();
+  request["periods"] = nlohmann::ordered_json::array();
+  request["demands"] = nlohmann::ordered_json::array();
+  request["availability"] = nlohmann::ordered_json::array();
+
+  const auto day_id = [](int period, int day) { return "day-" + std::to_string(period) + "-" + std::to_string(day); };
+  for (int k = 0; k < shape.periods; ++k) {
+    nlohmann::ordered_json day_ids = nlohmann::ordered_json::array();
+    for (int d = 0; d < shape.days_per_period; ++d) {
+      day_ids.push_back(day_id(k, d));
+    }
+    request["periods"].push_back({{"id", "p-" + std::to_string(k)}, {"dayIds", day_ids}});
+  }
+
+  const int day_count = shape.periods * shape.days_per_period;
+  std::vector<double> day_supply(day_count, 0.0);
+  for (int i = 0; i < shape.doctors; ++i) {
+    const std::string doctor_id = "doc-" + std::to_string(i);
+    const int max_total_days = cap(rng);
+    request["doctors"].push_back({{"id", doctor_id}, {"maxTotalDays", max_total_days}});
+
+    int available_periods = 0;
+    std::vector<int> available_days;
+    for (int k = 0; k < shape.periods; ++k) {
+      bool any = false;
+      for (int d = 0; d < shape.days_per_period; ++d) {
+        if (coin(rng) < shape.density) {
+          request["availability"].push_back(
+              {{"doctorId", doctor_id}, {"periodId", "p-" + std::to_string(k)}, {"dayId", day_id(k, d)}});
+          available_days.push_back(k * shape.days_per_period + d);
+          any = true;
+        }
+      }
+      available_periods += any ? 1 : 0;
+    }
+
+    // Spread what the doctor can give over the days it could cover.
+    const int doctor_supply = std::min(max_total_days, available_periods);
+    for (const int day : available_days) {
+      day_supply[day] += static_cast<double>(doctor_supply) / available_days.size();
+    }
+  }
+
+  for (int day = 0; day < day_count; ++day) {
+    const int required_doctors = shape.max_required > 0
+                                     ? required(rng)
+                                     : static_cast<int>(std::lround(shape.tightness * day_supply[day]));
+    request["demands"].push_back({{"dayId", day_id(day / shape.days_per_period, day % shape.days_per_period)},
+                                  {"requiredDoctors", required_doctors}});
+  }
+
+  return request.dump();
+}
+
+}  // namespace scheduler::bench
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace scheduler::bench {
+
+// Shape of a synthetic roster. Every doctor gets a cap in [1, periods] and
+// each (doctor, period, day) is available with probability `density`.
+// `tightness` scales demand against the supply doctors can actually give
+// (sum of min(cap, periods with availability)): 1.0 asks for all of it,
+// below 1 leaves slack, above 1 is infeasible by construction.
+struct RosterShape {
+  int doctors = 100;
+  int periods = 4;
+  int days_per_period = 7;
+  double density = 0.3;
+  double tightness = 0.9;
+  std::uint32_t seed = 1;
+  // Overrides for the engine tests, which want small, arbitrary rosters: caps
+  // in [min_total_days, max_total_days] when max_total_days >= 0, and each
+  // day requiring a uniform [1, max_required] doctors (ignoring `tightness`)
+  // when max_required > 0.
+  int min_total_days = 1;
+  int max_total_days = -1;
+  int max_required = 0;
+};
+
+// Returns a SolveRequest JSON payload; the same shape and seed always give
+// the same bytes.
+std::string GenerateRoster(const RosterShape& shape);
+
+}  // namespace scheduler::bench
@@ -0,0 +1,481 @@
+// In-process microbenchmarks for the solve pipeline on synthetic rosters.
+// Each phase (parse, build, max-flow, extract) and the whole in-process
+// solve are timed separately and reported as JSON whose `results` entries
+// (`<scenario>/<phase>`) can be checked with scripts/check-engine-benchmark.mjs.
+// `warmStartComparison` compares the engine's work from zero flow against a
+// GreedyWarmStart seed on the same network, and `criticalityComparison` times
+// IncrementalSolver::AnalyzeDoctorCriticality against one solve per doctor.
+// `balanceComparison` sets the plain max flow against BalancedMaxFlow and
+// against the binary search over a uniform cap that it replaces.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <scheduler/assignment_extractor.hpp>
+#include <scheduler/graph_builder.hpp>
+#include <scheduler/incremental_solver.hpp>
+#include <scheduler/problem_input.hpp>
+#include <scheduler/solver.hpp>
+
+#include "roster_generator.hpp"
+
+namespace {
+
+using scheduler::bench::RosterShape;
+
+constexpr const char* kUsage =
+    "usage: solver_bench [--runs N] [--seed S] [--algorithm NAME] [--warm-start on|off] [--output report.json]\n"
+    "                    [--scenario name:doctors:periods:daysPerPeriod:density:tightness]...\n";
+
+struct Scenario {
+  std::string name;
+  RosterShape shape;
+};
+
+struct Arguments {
+  int runs = 10;
+  std::uint32_t seed = 20260301;
+  scheduler::SolveOptions options;
+  std::string output;
+  std::vector<Scenario> scenarios;
+};
+
+std::vector<Scenario> DefaultScenarios() {
+  return {
+      {"roster-small", RosterShape{50, 4, 7, 0.3, 0.9}},
+      {"roster-medium", RosterShape{400, 13, 7, 0.3, 0.9}},
+      {"roster-large", RosterShape{3000, 26, 7, 0.25, 0.95}},
+      {"roster-overloaded", RosterShape{400, 13, 7, 0.3, 1.2}},
+  };
+}
+
+std::optional<Scenario> ParseScenario(const std::string& spec) {
+  std::vector<std::string> fields;
+  std::stringstream stream(spec);
+  for (std::string field; std::getline(stream, field, ':');) {
+    fields.push_back(field);
+  }
+  if (fields.size() != 6) {
+    return std::nullopt;
+  }
+  try {
+    return Scenario{fields[0], RosterShape{std::stoi(fields[1]), std::stoi(fields[2]), std::stoi(fields[3]),
+                                           std::stod(fields[4]), std::stod(fields[5])}};
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
+
+bool ParseArguments(int argc, char** argv, Arguments& arguments) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << arg << "\n" << kUsage;
+      return false;
+    }
+    const std::string value = argv[++i];
+    try {
+      if (arg == "--runs") {
+        arguments.runs = std::stoi(value);
+      } else if (arg == "--seed") {
+        arguments.seed = static_cast<std::uint32_t>(std::stoul(value));
+      } else if (arg == "--output") {
+        arguments.output = value;
+      } else if (arg == "--algorithm") {
+        if (value != "auto") {
+          arguments.options.algorithm = scheduler::ParseMaxFlowAlgorithm(value);
+          if (!arguments.options.algorithm) {
+            std::cerr << "Unknown max-flow algorithm: " << value << "\n" << kUsage;
+            return false;
+          }
+        }
+      } else if (arg == "--warm-start") {
+        if (value != "on" && value != "off") {
+          std::cerr << "Invalid value for --warm-start: " << value << "\n" << kUsage;
+          return false;
+        }
+        arguments.options.warm_start = value == "on";
+      } else if (arg == "--scenario") {
+        const std::optional<Scenario> scenario = ParseScenario(value);
+        if (!scenario) {
+          std::cerr << "Invalid scenario: " << value << "\n" << kUsage;
+          return false;
+        }
+        arguments.scenarios.push_back(*scenario);
+      } else {
+        std::cerr << "Unknown argument: " << arg << "\n" << kUsage;
+        return false;
+      }
+    } catch (const std::exception&) {
+      std::cerr << "Invalid value for " << arg << ": " << value << "\n" << kUsage;
+      return false;
+    }
+  }
+  if (arguments.runs <= 0) {
+    std::cerr << "--runs must be positive\n" << kUsage;
+    return false;
+  }
+  if (arguments.scenarios.empty()) {
+    arguments.scenarios = DefaultScenarios();
+  }
+  return true;
+}
+
+double Percentile(std::vector<double> values, double p) {
+  std::sort(values.begin(), values.end());
+  const long index = static_cast<long>(std::ceil(p / 100.0 * values.size())) - 1;
+  return values[std::clamp<long>(index, 0, static_cast<long>(values.size()) - 1)];
+}
+
+double Round3(double value) {
+  return std::round(value * 1000.0) / 1000.0;
+}
+
+nlohmann::ordered_json Summarize(const std::vector<double>& times_ms) {
+  double total = 0.0;
+  for (const double time : times_ms) {
+    total += time;
+  }
+  nlohmann::ordered_json metrics;
+  metrics["runs"] = times_ms.size();
+  metrics["minMs"] = Round3(*std::min_element(times_ms.begin(), times_ms.end()));
+  metrics["maxMs"] = Round3(*std::max_element(times_ms.begin(), times_ms.end()));
+  metrics["avgMs"] = Round3(total / times_ms.size());
+  metrics["p50Ms"] = Round3(Percentile(times_ms, 50));
+  metrics["p95Ms"] = Round3(Percentile(times_ms, 95));
+  return metrics;
+}
+
+// Runs `setup` untimed and `body` timed, once as warm-up and then `runs` times.
+std::vector<double> Measure(int runs, const std::function<void()>& setup, const std::function<void()>& body) {
+  std::vector<double> times_ms;
+  for (int run = 0; run <= runs; ++run) {
+    setup();
+    const auto start = std::chrono::steady_clock::now();
+    body();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if (run > 0) {
+      times_ms.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+    }
+  }
+  return times_ms;
+}
+
+std::string UtcTimestamp() {
+  const std::time_t now = std::time(nullptr);
+  char buffer[32];
+  std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+  return buffer;
+}
+
+nlohmann::ordered_json EngineWork(const scheduler::MaxFlowStats& stats, const std::vector<double>& times_ms) {
+  nlohmann::ordered_json work;
+  work["augmentations"] = stats.augmentations;
+  work["phases"] = stats.phases;
+  work["relabels"] = stats.relabels;
+  work["arcsScanned"] = stats.arcs_scanned;
+  work["p50Ms"] = Round3(Percentile(times_ms, 50));
+  return work;
+}
+
+// Same network, same engine, with and without the greedy seed. The warm
+// timing includes the greedy pass itself.
+nlohmann::ordered_json CompareWarmStart(const Scenario& scenario,
+                                        const scheduler::ProblemView& view,
+                                        const Arguments& arguments) {
+  std::optional<scheduler::GraphBuildResult> graph;
+  const auto rebuild = [&] { graph = scheduler::BuildFlowGraph(view); };
+
+  nlohmann::ordered_json entry;
+  entry["scenario"] = scenario.name;
+  int flow = 0;
+  for (const bool warm : {false, true}) {
+    scheduler::SolveOptions options = arguments.options;
+    options.warm_start = warm;
+    const std::vector<double> times_ms =
+        Measure(arguments.runs, rebuild, [&] { scheduler::SolveMaxFlow(*graph, options); });
+    scheduler::MaxFlowStats stats;
+    rebuild();
+    flow = scheduler::SolveMaxFlow(*graph, options, &stats);
+    if (warm) {
+      entry["totalDemand"] = graph->total_demand;
+      entry["maxFlow"] = flow;
+      entry["seededFlow"] = stats.warm_start_flow;
+      entry["seededShare"] = Round3(flow == 0 ? 0.0 : static_cast<double>(stats.warm_start_flow) / flow);
+      entry["augmentationsSaved"] =
+          entry["cold"]["augmentations"].get<long long>() - stats.augmentations;
+    }
+    entry[warm ? "warm" : "cold"] = EngineWork(stats, times_ms);
+  }
+  return entry;
+}
+
+struct LoadSpread {
+  int max_load = 0;
+  double stddev = 0.0;
+};
+
+// Per-doctor days of a solved network, read off the class arcs with the
+// extractor's floor/ceil split; doctors the presolve dropped count as 0.
+LoadSpread LoadsOf(const scheduler::GraphBuildResult& graph, std::size_t doctor_count) {
+  std::vector<int> loads;
+  loads.reserve(doctor_count);
+  const scheduler::FlowNetwork& network = graph.network;
+  for (int c = 0; c < graph.layers.doctor_count; ++c) {
+    const int node = graph.layers.doctor_offset + c;
+    const int members = static_cast<int>(graph.doctor_classes[c].doctors.size());
+    for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+      if (network.Head(arc) < graph.layers.doctor_offset) {
+        const int flow = network.Residual(arc);
+        for (int m = 0; m < members; ++m) {
+          loads.push_back(flow / members + (m < flow % members ? 1 : 0));
+        }
+      }
+    }
+  }
+  loads.resize(std::max(loads.size(), doctor_count), 0);
+
+  LoadSpread spread;
+  double sum = 0.0;
+  for (const int load : loads) {
+    spread.max_load = std::max(spread.max_load, load);
+    sum += load;
+  }
+  const double mean = loads.empty() ? 0.0 : sum / loads.size();
+  double squares = 0.0;
+  for (const int load : loads) {
+    squares += (load - mean) * (load - mean);
+  }
+  spread.stddev = loads.empty() ? 0.0 : std::sqrt(squares / loads.size());
+  return spread;
+}
+
+// Caps every class arc at `limit` days per member.
+void CapLoads(scheduler::GraphBuildResult& graph, int limit) {
+  scheduler::FlowNetwork& network = graph.network;
+  for (int c = 0; c < graph.layers.doctor_count; ++c) {
+    const int node = graph.layers.doctor_offset + c;
+    const int members = static_cast<int>(graph.doctor_classes[c].doctors.size());
+    for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+      if (network.Head(arc) < graph.layers.doctor_offset) {
+        const int forward = network.ReverseArc(arc);
+        network.SetCapacity(forward, std::min(network.Capacity(forward), members * limit));
+      }
+    }
+  }
+}
+
+// The usual way to even out a roster without costs: binary search the
+// smallest uniform cap that keeps the maximum, one max flow per probe. It only
+// bounds the largest load; BalancedMaxFlow also evens out the rest.
+nlohmann::ordered_json CompareBalance(const Scenario& scenario,
+                                      const scheduler::ProblemView& view,
+                                      const Arguments& arguments) {
+  std::optional<scheduler::GraphBuildResult> graph;
+  const auto rebuild = [&] { graph = scheduler::BuildFlowGraph(view); };
+
+  nlohmann::ordered_json entry;
+  entry["scenario"] = scenario.name;
+  int max_flow = 0;
+  for (const bool balanced : {false, true}) {
+    scheduler::SolveOptions options = arguments.options;
+    options.balance_load = balanced;
+    const std::vector<double> times_ms =
+        Measure(arguments.runs, rebuild, [&] { scheduler::SolveMaxFlow(*graph, options); });
+    scheduler::MaxFlowStats stats;
+    rebuild();
+    max_flow = scheduler::SolveMaxFlow(*graph, options, &stats);
+    const LoadSpread spread = LoadsOf(*graph, view.doctors.size());
+    nlohmann::ordered_json side = EngineWork(stats, times_ms);
+    side["maxLoad"] = spread.max_load;
+    side["loadStddev"] = Round3(spread.stddev);
+    entry[balanced ? "balanced" : "plain"] = side;
+  }
+  entry["maxFlow"] = max_flow;
+
+  int solves = 0;
+  int best_cap = 0;
+  const std::vector<double> times_ms = Measure(arguments.runs, [] {}, [&] {
+    solves = 0;
+    int low = 0;
+    int high = entry["plain"]["maxLoad"].get<int>();
+    while (low < high) {
+      const int mid = low + (high - low) / 2;
+      scheduler::GraphBuildResult capped = scheduler::BuildFlowGraph(view);
+      CapLoads(capped, mid);
+      ++solves;
+      if (scheduler::SolveMaxFlow(capped, arguments.options) == max_flow) {
+        high = mid;
+      } else {
+        low = mid + 1;
+      }
+    }
+    best_cap = high;
+  });
+  rebuild();
+  CapLoads(*graph, best_cap);
+  scheduler::SolveMaxFlow(*graph, arguments.options);
+  const LoadSpread spread = LoadsOf(*graph, view.doctors.size());
+  nlohmann::ordered_json capped;
+  capped["solves"] = solves;
+  capped["cap"] = best_cap;
+  capped["maxLoad"] = spread.max_load;
+  capped["loadStddev"] = Round3(spread.stddev);
+  capped["p50Ms"] = Round3(Percentile(times_ms, 50));
+  entry["cappedSearch"] = capped;
+  return entry;
+}
+
+// The analysis is timed end to end (build, first solve, every removal). The
+// re-solve side is estimated as doctors x the measured in-process solve.
+nlohmann::ordered_json CompareCriticality(const Scenario& scenario,
+                                          const scheduler::ProblemInput& input,
+                                          double solve_p50_ms,
+                                          const Arguments& arguments) {
+  scheduler::CriticalityReport report;
+  const std::vector<double> times_ms = Measure(arguments.runs, [] {}, [&] {
+    scheduler::IncrementalSolver solver(input, arguments.options);
+    report = solver.AnalyzeDoctorCriticality(true);
+  });
+
+  const double resolve_ms = solve_p50_ms * static_cast<double>(input.doctors.size());
+  nlohmann::ordered_json entry;
+  entry["scenario"] = scenario.name;
+  entry["doctors"] = input.doctors.size();
+  entry["criticalDoctors"] = report.critical_doctors.size();
+  entry["analysisP50Ms"] = Round3(Percentile(times_ms, 50));
+  entry["resolveEstimateMs"] = Round3(resolve_ms);
+  entry["share"] = Round3(resolve_ms == 0 ? 0.0 : Percentile(times_ms, 50) / resolve_ms);
+  return entry;
+}
+
+void BenchmarkScenario(const Scenario& scenario,
+                       const Arguments& arguments,
+                       nlohmann::ordered_json& results,
+                       nlohmann::ordered_json& warm_start,
+                       nlohmann::ordered_json& criticality,
+                       nlohmann::ordered_json& balance) {
+  RosterShape shape = scenario.shape;
+  shape.seed = arguments.seed;
+  const std::string payload = scheduler::bench::GenerateRoster(shape);
+  const int runs = arguments.runs;
+  const auto noop = [] {};
+
+  scheduler::ProblemInput input;
+  const std::vector<double> parse = Measure(runs, noop, [&] { input = scheduler::ParseProblemInput(payload); });
+  const scheduler::ProblemView view = input.View();
+
+  std::optional<scheduler::GraphBuildResult> graph;
+  const std::vector<double> build = Measure(runs, [&] { graph.reset(); }, [&] { graph = scheduler::BuildFlowGraph(view); });
+  const std::vector<double> max_flow = Measure(
+      runs, [&] { graph = scheduler::BuildFlowGraph(view); },
+      [&] { scheduler::SolveMaxFlow(*graph, arguments.options); });
+  const int flow = [&] {
+    scheduler::GraphBuildResult solved = scheduler::BuildFlowGraph(view);
+    return scheduler::SolveMaxFlow(solved, arguments.options);
+  }();
+
+  scheduler::ExtractionResult extraction;
+  const std::vector<double> extract =
+      Measure(runs, noop, [&] { extraction = scheduler::ExtractAssignmentsAndCoverage(*graph, view); });
+  scheduler::SolveResult result;
+  const std::vector<double> solve = Measure(runs, noop, [&] { result = scheduler::Solve(view, arguments.options); });
+
+  nlohmann::ordered_json input_size;
+  input_size["doctors"] = input.doctors.size();
+  input_size["periods"] = input.periods.size();
+  input_size["demands"] = input.demands.size();
+  input_size["availability"] = input.availability.size();
+  input_size["payloadBytes"] = payload.size();
+  input_size["density"] = shape.density;
+  input_size["tightness"] = shape.tightness;
+
+  nlohmann::ordered_json network;
+  network["nodes"] = graph->network.node_count();
+  network["arcs"] = graph->network.arc_count();
+  network["totalDemand"] = graph->total_demand;
+  network["maxFlow"] = flow;
+  network["isFeasible"] = result.is_feasible;
+
+  const std::vector<std::pair<const char*, const std::vector<double>*>> phases = {
+      {"parse", &parse}, {"build", &build}, {"max-flow", &max_flow}, {"extract", &extract}, {"solve", &solve},
+  };
+  for (const auto& [phase, times_ms] : phases) {
+    nlohmann::ordered_json entry;
+    entry["scenario"] = scenario.name + "/" + phase;
+    entry["inputSize"] = input_size;
+    entry["network"] = network;
+    entry["metrics"] = Summarize(*times_ms);
+    results.push_back(entry);
+  }
+
+  warm_start.push_back(CompareWarmStart(scenario, view, arguments));
+  const nlohmann::ordered_json& warm = warm_start.back();
+  criticality.push_back(CompareCriticality(scenario, input, Percentile(solve, 50), arguments));
+  const nlohmann::ordered_json& critical = criticality.back();
+  balance.push_back(CompareBalance(scenario, view, arguments));
+  const nlohmann::ordered_json& balanced = balance.back();
+
+  std::cerr << scenario.name << ": parse p50=" << Percentile(parse, 50) << "ms build p50=" << Percentile(build, 50)
+            << "ms max-flow p50=" << Percentile(max_flow, 50) << "ms extract p50=" << Percentile(extract, 50)
+            << "ms solve p50=" << Percentile(solve, 50) << "ms [arcs=" << graph->network.arc_count()
+            << "] warm start seeded " << warm["seededFlow"] << "/" << warm["maxFlow"] << ", augmentations "
+            << warm["cold"]["augmentations"] << " -> " << warm["warm"]["augmentations"] << ", criticality p50="
+            << critical["analysisP50Ms"] << "ms vs ~" << critical["resolveEstimateMs"] << "ms re-solving, balanced p50="
+            << balanced["balanced"]["p50Ms"] << "ms max load " << balanced["plain"]["maxLoad"] << " -> "
+            << balanced["balanced"]["maxLoad"] << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Arguments arguments;
+  if (!ParseArguments(argc, argv, arguments)) {
+    return 2;
+  }
+
+  nlohmann::ordered_json report;
+  report["benchmark"] = "solver-micro";
+  report["generatedAt"] = UtcTimestamp();
+  report["algorithm"] =
+      arguments.options.algorithm ? scheduler::MaxFlowAlgorithmName(*arguments.options.algorithm) : "auto";
+  report["warmStart"] = arguments.options.warm_start;
+  report["seed"] = arguments.seed;
+  report["runsPerScenario"] = arguments.runs;
+  report["results"] = nlohmann::ordered_json::array();
+  nlohmann::ordered_json warm_start = nlohmann::ordered_json::array();
+  nlohmann::ordered_json criticality = nlohmann::ordered_json::array();
+  nlohmann::ordered_json balance = nlohmann::ordered_json::array();
+  for (const Scenario& scenario : arguments.scenarios) {
+    BenchmarkScenario(scenario, arguments, report["results"], warm_start, criticality, balance);
+  }
+  report["warmStartComparison"] = warm_start;
+  report["criticalityComparison"] = criticality;
+  report["balanceComparison"] = balance;
+
+  const std::string text = report.dump(2) + "\n";
+  if (arguments.output.empty()) {
+    std::cout << text;
+    return 0;
+  }
+  std::ofstream output(arguments.output);
+  if (!output) {
+    std::cerr << "Unable to write " << arguments.output << "\n";
+    return 1;
+  }
+  output << text;
+  return 0;
+}
@@ -1,7 +1,9 @@
 #pragma once
+#include <string>
 #include <vector>
 #include <scheduler/flow_network.hpp>
 #include <scheduler/graph_builder.hpp>
+#include <scheduler/problem_input.hpp>
 #include <scheduler/solver.hpp>
 
 namespace scheduler {
@@ -11,9 +13,22 @@ struct ExtractionResult {
   std::vector<std::string> uncovered_days;
 };
 
-ExtractionResult ExtractAssignmentsAndCoverage(
-    const FlowNetwork& network,
-    const std::vector<AssignmentEdgeRef>& assignment_edges,
-    const std::vector<DayDemandRef>& day_edges);
+struct ExtractionRefs {
+  std::vector<AssignmentRef> assignments;
+  // Positions in ProblemView::demands.
+  std::vector<int> uncovered_demands;
+};
+
+// Resolves symbols back to ids through `input` for the edges that carry flow.
+// Flow on a class edge is split over the class doctors round-robin: members
+// share availability and cap, so handing out units in turn keeps every doctor
+// within one day per period and within its cap. Assignments come out ordered
+// by doctor position, then period and day symbol.
+ExtractionResult ExtractAssignmentsAndCoverage(const GraphBuildResult& graph, const ProblemView& input);
+// Merges graphs built from disjoint parts of `input` (BuildComponentGraphs):
+// same ordering as a single graph, uncovered days in demand order.
+ExtractionResult ExtractAssignmentsAndCoverage(const std::vector<GraphBuildResult>& graphs, const ProblemView& input);
+// Same split and order, stopping short of looking up any id.
+ExtractionRefs ExtractAssignmentRefs(const std::vector<GraphBuildResult>& graphs);
 
 }  // namespace scheduler
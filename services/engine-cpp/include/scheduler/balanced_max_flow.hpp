@@ -0,0 +1,25 @@
+#pragma once
+
+#include <scheduler/flow_network.hpp>
+#include <scheduler/graph_builder.hpp>
+
+namespace scheduler {
+
+// Min-cost max flow on a BuildFlowGraph network where the arc into each
+// doctor class has a convex cost: with n members and f units already on it,
+// the next unit costs 2 * floor(f / n) + 1, so the total is the sum of the
+// squared days of the members under the round-robin split of extraction.
+// Every other arc is free. The result is a maximum flow that minimizes that
+// sum, i.e. the most even roster among the maximum ones, in one solve. With a
+// DoctorGroups layer (planning cycles) the cost sits on the source -> group
+// arc instead, with n = 1, so days are evened out per doctor over the cycle.
+//
+// Primal-dual successive shortest paths: a bucketed Dijkstra on reduced costs
+// updates the node potentials, then Dinic-style blocking flows saturate the arcs of
+// reduced cost 0 (a class arc only up to the end of its current cost step).
+// Distances only take the values 2k + 1, so the number of Dijkstra rounds is
+// bounded by the largest per-doctor load. Starts from zero flow; `stop` is
+// polled between rounds and blocking flows (see StopCondition).
+int BalancedMaxFlow(GraphBuildResult& graph, MaxFlowStats* stats = nullptr, const StopCondition* stop = nullptr);
+
+}  // namespace scheduler
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <scheduler/problem_input.hpp>
+#include <scheduler/solver.hpp>
+
+namespace scheduler {
+
+struct CycleSprintResult {
+  std::string sprint_id;
+  // Feasibility, assignments and uncovered days of this sprint alone.
+  SolveResult result;
+};
+
+struct CycleSolveResult {
+  std::string contract_version = "1.0";
+  bool is_feasible = false;
+  int assigned_count = 0;
+  bool truncated = false;
+  // In request order.
+  std::vector<CycleSprintResult> sprints;
+};
+
+// One max flow over every sprint (BuildFlowGraph with DoctorGroups: a cycle
+// doctor node feeds the doctor's node in each sprint), split back per sprint.
+// Honors the algorithm, time budget, cancellation and balance_load (days even
+// per doctor over the whole cycle) of `options`; min cuts and stats are not
+// reported per sprint.
+CycleSolveResult SolveCycle(const CycleProblem& problem, const SolveOptions& options = {});
+// Parses the cycle envelope (ParseCycleProblem) and solves it; the time budget
+// starts before parsing, as in Solve.
+CycleSolveResult SolveCycle(std::istream& input, const SolveOptions& options = {});
+
+}  // namespace scheduler
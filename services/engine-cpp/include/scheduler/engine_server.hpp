@@ -0,0 +1,37 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+
+#include <scheduler/solver.hpp>
+
+namespace scheduler {
+
+struct ServerOptions {
+  // <= 0 sizes the worker pool to the machine.
+  int worker_count = 0;
+  // Defaults for requests that do not carry their own options.
+  SolveOptions solve_options;
+};
+
+// Answers one newline-delimited request envelope. Never throws: malformed
+// envelopes and solver failures become error responses carrying the same id.
+//
+//   request:  {"id": <string|number>, "problem": {...},
+//              "options": {"algorithm": "dinic", "stats": true, "timeBudgetMs": 500}}
+//   response: {"id": ..., "status": "ok", "result": {...}}
+//             {"id": ..., "status": "error", "error": {"code": "...", "message": "..."}}
+std::string HandleServerRequest(const std::string& line, const SolveOptions& defaults);
+
+// Long-lived mode behind `scheduler_engine --serve`: reads envelopes from
+// `input` until EOF, solves them concurrently on a worker pool and writes one
+// response line per request to `output` as each finishes (completion order,
+// matched by id). Returns the process exit code.
+int RunServer(std::istream& input, std::ostream& output, const ServerOptions& options);
+
+// `scheduler_engine --batch`: reads a JSON array of problems, solves them with
+// SolveBatch and writes a JSON array of {"status", "result" | "error"} items
+// in input order. Returns the process exit code.
+int RunBatch(std::istream& input, std::ostream& output, const SolveOptions& options);
+
+}  // namespace scheduler
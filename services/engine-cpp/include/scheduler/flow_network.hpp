@@ -1,27 +1,162 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace scheduler {
 
-struct Edge {
-  int to;
-  int rev;
-  int capacity;
-  int original_capacity;
+enum class MaxFlowAlgorithm {
+  kEdmondsKarp,
+  kDinic,
+  kPushRelabel,
+  kParallelPushRelabel,
 };
 
+std::optional<MaxFlowAlgorithm> ParseMaxFlowAlgorithm(const std::string& name);
+const char* MaxFlowAlgorithmName(MaxFlowAlgorithm algorithm);
+
+// Stop request shared between a caller and running solves; Cancel may be
+// called from any thread.
+class CancellationToken {
+ public:
+  void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+  bool IsCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<bool> cancelled_{false};
+};
+
+// When a max-flow run should give up. Engines poll ShouldStop between phases
+// (Dinic and the layered engine also every few hundred augmentations inside
+// one, push-relabel every few hundred discharges) and, once it fires, leave a
+// valid flow in the network - not necessarily maximum - and return its value.
+// Firing is sticky and visible through Fired(), so one condition can be shared
+// by the engines of several components.
+class StopCondition {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  StopCondition(std::optional<Clock::time_point> deadline, const CancellationToken* cancellation)
+      : deadline_(deadline), cancellation_(cancellation) {}
+
+  bool ShouldStop() const {
+    if (fired_.load(std::memory_order_relaxed)) {
+      return true;
+    }
+    if ((cancellation_ && cancellation_->IsCancelled()) || (deadline_ && Clock::now() >= *deadline_)) {
+      fired_.store(true, std::memory_order_relaxed);
+      return true;
+    }
+    return false;
+  }
+  bool Fired() const { return fired_.load(std::memory_order_relaxed); }
+
+ private:
+  std::optional<Clock::time_point> deadline_;
+  const CancellationToken* cancellation_;
+  mutable std::atomic<bool> fired_{false};
+};
+
+// Work done by one max-flow run. Engines are compiled twice, with and without
+// counting, and MaxFlow only runs the counting copy when stats are requested,
+// so the default path carries no counter updates in its loops.
+struct MaxFlowStats {
+  // BFS passes (Edmonds-Karp searches, Dinic/layered level graphs) or
+  // push-relabel rounds and global relabels.
+  long long phases = 0;
+  // Augmenting paths, or pushes for push-relabel.
+  long long augmentations = 0;
+  long long relabels = 0;
+  long long arcs_scanned = 0;
+  // Units seeded by GreedyWarmStart before the engine ran.
+  long long warm_start_flow = 0;
+
+  MaxFlowStats& operator+=(const MaxFlowStats& other) {
+    phases += other.phases;
+    augmentations += other.augmentations;
+    relabels += other.relabels;
+    arcs_scanned += other.arcs_scanned;
+    warm_start_flow += other.warm_start_flow;
+    return *this;
+  }
+};
+
+// Residual network in compressed-sparse-row form. Edges are staged with
+// AddEdge and laid out by Finalize in two passes (count out-degrees, then
+// fill), so the arcs leaving node v are [FirstArc(v), EndArc(v)). Every edge
+// owns a forward arc and a paired reverse arc; arcs are addressed by one
+// global id and residual capacities live in their own array.
 class FlowNetwork {
  public:
   explicit FlowNetwork(int node_count);
 
+  void ReserveEdges(int edge_count);
   int AddEdge(int from, int to, int capacity);
-  int MaxFlow(int source, int sink);
+  void Finalize();
+
+  // `threads` is used by kParallelPushRelabel only; <= 0 sizes it to the machine.
+  // Counters are added to `stats` when it is set; with `stop` the run may end
+  // early on a smaller, still valid flow (see StopCondition).
+  int MaxFlow(int source,
+              int sink,
+              MaxFlowAlgorithm algorithm = MaxFlowAlgorithm::kDinic,
+              int threads = 1,
+              MaxFlowStats* stats = nullptr,
+              const StopCondition* stop = nullptr);
+
+  int node_count() const { return node_count_; }
+  int arc_count() const { return static_cast<int>(head_.size()); }
 
-  const Edge& GetEdge(int from, int edge_index) const;
+  int ForwardArc(int edge_id) const { return edge_arc_[edge_id]; }
+  int FirstArc(int node) const { return first_arc_[node]; }
+  int EndArc(int node) const { return first_arc_[node + 1]; }
+  int Head(int arc) const { return head_[arc]; }
+  int ReverseArc(int arc) const { return reverse_[arc]; }
+  int Residual(int arc) const { return residual_[arc]; }
+
+  // Valid for forward arcs: their paired reverse arc starts empty, so its
+  // residual capacity is exactly the flow pushed so far.
+  int Flow(int arc) const { return residual_[reverse_[arc]]; }
+  int Capacity(int arc) const { return residual_[arc] + residual_[reverse_[arc]]; }
+
+  // Requires capacity >= Flow(arc); the current flow is kept.
+  void SetCapacity(int arc, int capacity) { residual_[arc] = capacity - Flow(arc); }
+
+  void Push(int arc, int amount) {
+    residual_[arc] -= amount;
+    residual_[reverse_[arc]] += amount;
+  }
 
  private:
-  std::vector<std::vector<Edge>> adjacency_;
+  struct PendingEdge {
+    int from;
+    int to;
+    int capacity;
+  };
+
+  template <bool kCount>
+  int EdmondsKarp(int source, int sink, MaxFlowStats& stats, const StopCondition* stop);
+  template <bool kCount>
+  int Dinic(int source, int sink, MaxFlowStats& stats, const StopCondition* stop);
+  template <bool kCount>
+  int PushRelabel(int source, int sink, MaxFlowStats& stats, const StopCondition* stop);
+  template <bool kCount>
+  int ParallelPushRelabel(int source, int sink, int threads, MaxFlowStats& stats, const StopCondition* stop);
+  // Turns a preflow left by an interrupted push-relabel run into a flow by
+  // sending every node's excess back towards the source.
+  void ReturnExcess(int source, int sink, std::vector<int>& excess);
+
+  int node_count_;
+  bool finalized_ = false;
+  std::vector<PendingEdge> pending_edges_;
+  std::vector<int> edge_arc_;
+  std::vector<int> first_arc_;
+  std::vector<int> head_;
+  std::vector<int> reverse_;
+  std::vector<int> residual_;
 };
 
 }  // namespace scheduler
@@ -1,24 +1,37 @@
 #pragma once
 
-#include <string>
+#include <cstdint>
 #include <vector>
 
 #include <scheduler/flow_network.hpp>
+#include <scheduler/layered_max_flow.hpp>
 #include <scheduler/problem_input.hpp>
 #include <scheduler/solver.hpp>
 
 namespace scheduler {
 
+// Doctors that share the same valid availability and effective day cap are
+// interchangeable, so the builder gives them one node. `doctors` holds their
+// positions in ProblemView::doctors, in input order.
+struct DoctorClass {
+  std::vector<int> doctors;
+};
+
+// One class-period -> day arc. Its flow counts how many doctors of the class
+// take that day; ids are ProblemInput symbols and strings are materialized
+// only for the assignments that end up carrying flow.
 struct AssignmentEdgeRef {
-  int from;
-  int edge_index;
-  Assignment assignment;
+  int arc;
+  int doctor_class;
+  std::uint32_t period_id;
+  std::uint32_t day_id;
 };
 
 struct DayDemandRef {
-  int from;
-  int edge_index;
-  std::string day_id;
+  int arc;
+  // Position in ProblemView::demands.
+  int demand;
+  std::uint32_t day_id;
   int required;
 };
 
@@ -27,10 +40,59 @@ struct GraphBuildResult {
   int source;
   int sink;
   int total_demand;
+  FlowLayers layers;
+  std::vector<DoctorClass> doctor_classes;
   std::vector<AssignmentEdgeRef> assignment_edges;
   std::vector<DayDemandRef> day_edges;
 };
 
-GraphBuildResult BuildFlowGraph(const ProblemInput& input);
+// By default the builder presolves: doctors without usable availability or
+// cap are dropped, doctor-period nodes exist only where the doctor has
+// availability in that period, and identical doctors are merged into one
+// class whose arcs carry the summed capacity (see ExtractAssignmentsAndCoverage
+// for the split back to doctors).
+struct GraphBuildOptions {
+  // Lays out one class per doctor, a doctor-period node for every period and
+  // a doctor-period -> day arc for every (doctor, period, day) whose day
+  // belongs to the period and has demand, with capacity 0 where the doctor is
+  // unavailable, so availability can later be toggled in place.
+  bool include_unavailable_arcs = false;
+  bool merge_identical_doctors = true;
+};
+
+GraphBuildResult BuildFlowGraph(const ProblemView& input, const GraphBuildOptions& options = {});
+GraphBuildResult BuildFlowGraph(const ProblemInput& input, const GraphBuildOptions& options = {});
+
+// Doctors that stand for the same person in several sub-problems (the sprints
+// of a planning cycle, see cycle_solver.hpp) and the cap on their days summed
+// over all of them.
+struct DoctorGroups {
+  // Group of each position in ProblemView::doctors.
+  std::vector<int> group_of_doctor;
+  std::vector<int> group_cap;
+};
+
+// Adds a group layer between the source and the doctors: source -> group
+// (capacity min(group cap, summed member caps)) -> doctor (its own cap) ->
+// doctor-period -> day -> sink. Doctors are never merged and the problem is
+// not split into components, so the network no longer matches FlowLayers and
+// SolveMaxFlow runs Dinic on it unless an algorithm is forced.
+GraphBuildResult BuildFlowGraph(const ProblemView& input, const DoctorGroups& groups);
+
+// Splits the problem into connected components of the doctor/day
+// availability structure (union-find over valid availability) and builds one
+// network per component, ordered by first doctor. Demands no doctor can cover
+// share a trailing component without doctors. The max flow of the whole
+// problem is the sum over components. With include_unavailable_arcs the whole
+// problem is returned as a single graph.
+std::vector<GraphBuildResult> BuildComponentGraphs(const ProblemView& input, const GraphBuildOptions& options = {});
+
+// Runs the max-flow engine selected by `options` (see SolveOptions::algorithm)
+// on a built graph and returns the flow value. Engine counters are added to
+// `stats` when it is set; `stop` may end the run early on a valid flow.
+int SolveMaxFlow(GraphBuildResult& graph,
+                 const SolveOptions& options,
+                 MaxFlowStats* stats = nullptr,
+                 const StopCondition* stop = nullptr);
 
 }  // namespace scheduler
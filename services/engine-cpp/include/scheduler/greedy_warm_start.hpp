@@ -0,0 +1,17 @@
+#pragma once
+
+#include <scheduler/flow_network.hpp>
+#include <scheduler/layered_max_flow.hpp>
+
+namespace scheduler {
+
+// Seeds a valid flow on a network that satisfies MatchesFlowLayers, so the
+// exact engine only has to find the remaining deficit. Days are filled in
+// order of fewest candidate doctor-periods first; each unit of a day's demand
+// goes to the open doctor-period whose doctor class has the most remaining
+// capacity per doctor. Every push goes source -> doctor -> doctor-period ->
+// day -> sink along arcs with residual capacity, so all four capacity layers
+// hold. One pass over the day adjacency; returns the flow added.
+int GreedyWarmStart(FlowNetwork& network, const FlowLayers& layers);
+
+}  // namespace scheduler
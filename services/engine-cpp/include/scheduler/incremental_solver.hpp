@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <scheduler/graph_builder.hpp>
+#include <scheduler/problem_input.hpp>
+#include <scheduler/solver.hpp>
+
+namespace scheduler {
+
+struct DoctorCoverageLoss {
+  std::string doctor_id;
+  // Demand units the maximum flow loses without this doctor.
+  int lost_days = 0;
+};
+
+// Doctors whose removal lowers the maximum flow: on a feasible roster, the
+// ones without whom it becomes infeasible. `coverage_loss` lists every doctor
+// (including zero losses) in input order, and is only filled on request.
+struct CriticalityReport {
+  bool is_feasible = false;
+  int assigned_count = 0;
+  std::vector<std::string> critical_doctors;
+  std::vector<DoctorCoverageLoss> coverage_loss;
+};
+
+// Keeps a solved network and repairs its flow locally after small edits
+// instead of re-parsing, rebuilding and re-solving from zero.
+//
+// The first solve runs on the presolved network of BuildFlowGraph (one node
+// per doctor, no merging), which is then copied into a network that takes new
+// nodes and edges: an availability the roster did not have gets its
+// doctor-period node and arc when AddAvailability first names it, and a
+// removed one keeps its arc at capacity 0. Every edit is then a capacity
+// change on one arc:
+// - capacity increase on arc u -> v: each extra unit needs an augmenting path
+//   through that arc, found by searching backward from u and forward from v;
+// - capacity decrease below the current flow: one unit at a time is cancelled
+//   along a flow path through the arc, then rerouted by searching from the
+//   freed prefix/suffix of that path.
+// Both searches are BFS over the residual network that stop at the first hit
+// and reuse epoch-stamped scratch arrays, so nothing is cleared per search. A
+// search that finds a path usually stays near the edited arc, but one that
+// fails (the maximum does not grow, or a cancelled unit cannot be rerouted)
+// visits everything reachable, O(V + E). A change of k units runs at most 2k
+// searches: O(k * (V + E)) in the worst case, with no rebuild, parse or
+// re-solve; bounding the searches would give up the maximum flow.
+//
+// Assignments and uncovered days are kept up to date from the arcs each push
+// touches, so Result() only copies them out.
+//
+// Edits that reference unknown doctors, periods or days, or a day outside its
+// period, are ignored exactly like BuildFlowGraph ignores such availability.
+class IncrementalSolver {
+ public:
+  explicit IncrementalSolver(ProblemInput input, const SolveOptions& options = {});
+  // Throws when the payload does not parse.
+  static IncrementalSolver FromJson(const std::string& input_json, const SolveOptions& options = {});
+
+  SolveResult AddAvailability(const std::string& doctor_id, const std::string& period_id, const std::string& day_id);
+  SolveResult RemoveAvailability(const std::string& doctor_id, const std::string& period_id, const std::string& day_id);
+  SolveResult SetMaxTotalDays(const std::string& doctor_id, int max_total_days);
+  SolveResult SetRequiredDoctors(const std::string& day_id, int required_doctors);
+
+  SolveResult Result() const;
+  // Works on the solved network instead of re-solving once per doctor. One
+  // residual traversal settles doctors without flow, doctors no one else can
+  // resupply (they lose all their flow) and single-unit doctors someone can
+  // resupply. Each remaining doctor is removed by cancelling the flow on its
+  // source arc unit by unit and rerouting it (a direct swap to a spare doctor
+  // first, then the repair search), and restored by augmenting through the
+  // arc again; the solver ends on a maximum flow of the unchanged problem.
+  // Without `coverage_loss` a doctor stops at its first unit that cannot be
+  // rerouted.
+  CriticalityReport AnalyzeDoctorCriticality(bool coverage_loss = false);
+  int flow_value() const { return flow_value_; }
+  bool is_feasible() const;
+
+ private:
+  // Residual network that grows after the first solve. Edge e owns forward
+  // arc 2e and reverse arc 2e + 1; edges run source -> doctor ->
+  // doctor-period -> day -> sink. A doctor or doctor-period node has a single
+  // incoming edge, added right after the node, so the first arc it lists is
+  // that edge's reverse.
+  class Network {
+   public:
+    int AddNode();
+    int AddEdge(int from, int to, int capacity, int flow = 0);
+
+    int node_count() const { return static_cast<int>(arcs_.size()); }
+    const std::vector<int>& Arcs(int node) const { return arcs_[node]; }
+    int Head(int arc) const { return head_[arc]; }
+    int ReverseArc(int arc) const { return arc ^ 1; }
+    bool IsForward(int arc) const { return (arc & 1) == 0; }
+    int Residual(int arc) const { return residual_[arc]; }
+    // Valid for forward arcs, as in FlowNetwork.
+    int Flow(int arc) const { return residual_[arc ^ 1]; }
+    int Capacity(int arc) const { return residual_[arc] + residual_[arc ^ 1]; }
+    void SetCapacity(int arc, int capacity) { residual_[arc] = capacity - Flow(arc); }
+    void Push(int arc, int amount) {
+      residual_[arc] -= amount;
+      residual_[arc ^ 1] += amount;
+    }
+
+   private:
+    std::vector<std::vector<int>> arcs_;
+    std::vector<int> head_;
+    std::vector<int> residual_;
+  };
+
+  void CopySolvedGraph(const GraphBuildResult& graph);
+  int AddNode();
+  int AddEdge(int from, int to, int capacity, int flow = 0);
+  void Push(int arc, int amount);
+  void UpdateCoverage(int demand);
+  void ChangeCapacity(int arc, int capacity);
+  int RemovalLoss(int arc, bool full_loss);
+  bool ShiftUnitToSpareDoctor(int doctor_arc);
+  std::vector<char> ResuppliedDoctors() const;
+  bool AugmentThrough(int arc);
+  void CancelUnitThrough(int arc, std::vector<int>& prefix_arcs, std::vector<int>& suffix_arcs);
+  bool Reroute(const std::vector<int>& prefix_arcs, const std::vector<int>& suffix_arcs);
+  bool SearchForward(const std::vector<int>& roots, std::vector<int>& path);
+  bool SearchBackward(const std::vector<int>& roots, std::vector<int>& path);
+  void PushUnitAlong(const std::vector<int>& arcs);
+  int Tail(int arc) const;
+  // -1 when the edit is outside the problem, or when the doctor never had the
+  // availability and `create` is off.
+  int AssignmentArc(const std::string& doctor_id, const std::string& period_id, const std::string& day_id, bool create);
+  int AssignmentArc(std::uint32_t doctor_id, std::uint32_t period_id, std::uint32_t day_id, bool create);
+  int DoctorPeriodNode(std::uint32_t doctor_id, std::uint32_t period_id);
+  std::uint64_t AssignmentKey(std::uint32_t doctor_id, std::uint32_t period_id, std::uint32_t day_id) const;
+
+  static constexpr int kSource = 0;
+  static constexpr int kSink = 1;
+
+  ProblemInput input_;
+  Network network_;
+  int flow_value_ = 0;
+  int total_demand_ = 0;
+  // Indexed by symbol; -1 when no doctor / demand declares it.
+  std::vector<int> doctor_arcs_;
+  std::vector<int> doctor_positions_;
+  std::vector<int> day_demands_;
+  // Demand days of each period symbol, sorted; what an availability's day
+  // must belong to.
+  std::vector<std::vector<std::uint32_t>> period_days_;
+  // Keyed by AssignmentKey with day 0.
+  std::unordered_map<std::uint64_t, int> doctor_period_nodes_;
+  std::unordered_map<std::uint64_t, int> assignment_arcs_;
+
+  // Indexed by position in ProblemInput::demands.
+  std::vector<int> day_arcs_;
+  std::vector<int> required_;
+  // Indexed by edge; -1 unless the edge is an availability or a day edge.
+  std::vector<int> edge_assignment_;
+  std::vector<int> edge_demand_;
+  std::vector<AssignmentRef> assignment_refs_;
+  // Ordered like ExtractAssignmentsAndCoverage: doctor position, then period
+  // and day symbol; uncovered days by demand position.
+  std::set<std::tuple<int, std::uint32_t, std::uint32_t>> assigned_;
+  std::set<int> uncovered_demands_;
+
+  std::vector<int> visit_epoch_;
+  std::vector<int> parent_arc_;
+  std::vector<int> search_queue_;
+  std::vector<int> path_position_;
+  int epoch_ = 0;
+};
+
+}  // namespace scheduler
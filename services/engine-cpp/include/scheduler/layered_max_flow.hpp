@@ -0,0 +1,33 @@
+#pragma once
+
+#include <scheduler/flow_network.hpp>
+
+namespace scheduler {
+
+// Node ranges of the source -> doctor -> doctor-period -> day -> sink network
+// described in docs/flow-network-model.md.
+struct FlowLayers {
+  int source = 0;
+  int sink = 0;
+  int doctor_offset = 0;
+  int doctor_count = 0;
+  int doctor_period_offset = 0;
+  int doctor_period_count = 0;
+  int day_offset = 0;
+  int day_count = 0;
+};
+
+bool MatchesFlowLayers(const FlowNetwork& network, const FlowLayers& layers);
+
+// Hopcroft-Karp style phased augmentation over the doctor/doctor-period/day
+// layers. Doctors with spare source capacity seed every phase and days with
+// spare sink capacity end it, so BFS and DFS never walk the source or sink
+// adjacency. Requires a finalized network that satisfies MatchesFlowLayers.
+// Counters are added to `stats` when it is set (see MaxFlowStats); `stop` is
+// polled between phases and every few hundred augmentations (see StopCondition).
+int LayeredMaxFlow(FlowNetwork& network,
+                   const FlowLayers& layers,
+                   MaxFlowStats* stats = nullptr,
+                   const StopCondition* stop = nullptr);
+
+}  // namespace scheduler
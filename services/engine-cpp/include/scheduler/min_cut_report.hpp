@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+
+#include <scheduler/graph_builder.hpp>
+#include <scheduler/problem_input.hpp>
+#include <scheduler/solver.hpp>
+
+namespace scheduler {
+
+// Reads the minimum cut off graphs that hold a maximum flow: S is what one
+// BFS over residual arcs reaches from each source, and the saturated S -> T
+// arcs are reported in problem terms. Merged doctor classes are split back
+// into their doctors (a class cap of n * C becomes n doctors capped at C), so
+// `value` equals the max flow summed over components. Doctors the builder
+// pruned (no usable availability or cap) are not part of any network and
+// never appear. On networks with a DoctorGroups layer the doctors whose own
+// cap binds are listed as capped; a group held below its members' caps by the
+// cycle cap has no problem term here, so `value` then falls short of the max
+// flow by that group's cap.
+MinCutReport BuildMinCutReport(const std::vector<GraphBuildResult>& graphs, const ProblemView& input);
+
+// The same cut by index, without reading any id (see MinCutRefs).
+MinCutRefs BuildMinCutRefs(const std::vector<GraphBuildResult>& graphs);
+
+}  // namespace scheduler
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <scheduler/problem_input.hpp>
+
+namespace scheduler {
+
+// Versioned binary encoding of a problem, laid out so a mapped file can be
+// used in place as a ProblemView (native little-endian, 4-byte aligned):
+//
+//   ProblemBinaryHeader
+//   uint32 string_offsets[S + 1]    S = doctor + period + day symbols + 1
+//   Doctor doctors[doctor_count]
+//   Period periods[period_count]
+//   uint32 period_days[period_day_count]
+//   Demand demands[demand_count]
+//   Availability availability[availability_count]
+//   char strings[string_bytes]
+//
+// The string table holds doctor ids, then period ids, then day ids (in symbol
+// order) and finally the contract version.
+inline constexpr char kProblemBinaryMagic[4] = {'M', 'F', 'S', 'P'};
+inline constexpr std::uint32_t kProblemBinaryVersion = 1;
+
+struct ProblemBinaryHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t doctor_symbol_count;
+  std::uint32_t period_symbol_count;
+  std::uint32_t day_symbol_count;
+  std::uint32_t string_bytes;
+  std::uint32_t doctor_count;
+  std::uint32_t period_count;
+  std::uint32_t period_day_count;
+  std::uint32_t demand_count;
+  std::uint32_t availability_count;
+  std::uint32_t reserved;
+};
+
+bool IsProblemBinary(const char* data, std::size_t size);
+
+std::string EncodeProblemBinary(const ProblemView& problem);
+
+// Validates the buffer and returns a view pointing into it; nothing is
+// copied, so `data` must outlive the view. Throws std::runtime_error on a bad
+// magic, unsupported version, truncated sections or out-of-range symbols.
+ProblemView DecodeProblemBinary(const char* data, std::size_t size);
+
+// JSON contract form of a problem (the inverse of ParseProblemInput).
+std::string SerializeProblemJson(const ProblemView& problem);
+
+// Read-only private mapping of a regular file.
+class MappedFile {
+ public:
+  // nullopt when `fd` is not a mappable regular file (pipe, tty, empty file).
+  static std::optional<MappedFile> Map(int fd);
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  const char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  MappedFile(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+}  // namespace scheduler
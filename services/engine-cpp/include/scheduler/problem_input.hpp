@@ -1,39 +1,156 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace scheduler {
 
+// Read-only view over a contiguous array owned elsewhere (a vector or a
+// mapped binary problem).
+template <typename T>
+class Span {
+ public:
+  Span() = default;
+  Span(const T* data, std::size_t size) : data_(data), size_(size) {}
+
+  const T* data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+  const T& operator[](std::size_t index) const { return data_[index]; }
+
+ private:
+  const T* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+// Names of one symbol kind: symbol i is bytes[offsets[i], offsets[i + 1]).
+struct SymbolNames {
+  Span<std::uint32_t> offsets;
+  const char* bytes = nullptr;
+
+  std::uint32_t size() const { return offsets.empty() ? 0 : static_cast<std::uint32_t>(offsets.size() - 1); }
+  std::string_view Name(std::uint32_t symbol) const {
+    return std::string_view(bytes + offsets[symbol], offsets[symbol + 1] - offsets[symbol]);
+  }
+};
+
+// Interns string ids into dense indices, in first-seen order. Everything past
+// parsing works on the indices; names are looked up again only for output.
+class SymbolTable {
+ public:
+  std::uint32_t Intern(const std::string& name);
+  std::optional<std::uint32_t> Find(const std::string& name) const;
+
+  std::string_view Name(std::uint32_t symbol) const { return names().Name(symbol); }
+  std::uint32_t size() const { return static_cast<std::uint32_t>(offsets_.size() - 1); }
+  SymbolNames names() const { return SymbolNames{{offsets_.data(), offsets_.size()}, bytes_.data()}; }
+
+ private:
+  std::string bytes_;
+  std::vector<std::uint32_t> offsets_{0};
+  std::unordered_map<std::string, std::uint32_t> index_;
+};
+
+// Records are fixed-width so the binary problem format can store them as-is.
 struct Doctor {
-  std::string id;
-  int max_total_days = 0;
+  std::uint32_t id = 0;
+  std::int32_t max_total_days = 0;
 };
 
+// Days are period_days[first_day, first_day + day_count).
 struct Period {
-  std::string id;
-  std::vector<std::string> day_ids;
+  std::uint32_t id = 0;
+  std::uint32_t first_day = 0;
+  std::uint32_t day_count = 0;
 };
 
 struct Demand {
-  std::string day_id;
-  int required_doctors = 0;
+  std::uint32_t day_id = 0;
+  std::int32_t required_doctors = 0;
 };
 
 struct Availability {
-  std::string doctor_id;
-  std::string period_id;
-  std::string day_id;
+  std::uint32_t doctor_id = 0;
+  std::uint32_t period_id = 0;
+  std::uint32_t day_id = 0;
 };
 
+// What graph building and extraction read. Views never own their data.
+struct ProblemView {
+  std::string_view contract_version;
+  SymbolNames doctor_ids;
+  SymbolNames period_ids;
+  SymbolNames day_ids;
+  Span<Doctor> doctors;
+  Span<Period> periods;
+  Span<std::uint32_t> period_days;
+  Span<Demand> demands;
+  Span<Availability> availability;
+
+  Span<std::uint32_t> DaysOf(const Period& period) const {
+    return Span<std::uint32_t>(period_days.data() + period.first_day, period.day_count);
+  }
+};
+
+// Doctor, period and day ids are symbols of `doctor_ids`, `period_ids` and
+// `day_ids`. Availability may reference symbols that no doctor, period or
+// demand declares; the graph builder skips those tuples.
 struct ProblemInput {
   std::string contract_version = "1.0";
+  SymbolTable doctor_ids;
+  SymbolTable period_ids;
+  SymbolTable day_ids;
   std::vector<Doctor> doctors;
   std::vector<Period> periods;
+  std::vector<std::uint32_t> period_days;
   std::vector<Demand> demands;
   std::vector<Availability> availability;
+
+  ProblemView View() const;
 };
 
+// Streams the payload through a SAX parser; no JSON DOM is built. Throws
+// nlohmann::json exceptions for malformed JSON, missing keys or wrong types.
+ProblemInput ParseProblemInput(std::istream& input);
 ProblemInput ParseProblemInput(const std::string& input_json);
 
+// Days a doctor may work summed over every sprint of a planning cycle.
+struct CycleDoctorCap {
+  std::string doctor_id;
+  int max_cycle_days = 0;
+};
+
+struct CycleSprint {
+  std::string id;
+  ProblemInput problem;
+};
+
+// A planning cycle solved as one problem (see SolveCycle). Each sprint is a
+// regular problem with its own periods, demands and per-sprint maxTotalDays;
+// doctors with the same id across sprints are the same person, and
+// `doctor_caps` bounds their cycle total. Doctors without a cap are bounded
+// by their sprints only.
+struct CycleProblem {
+  std::string contract_version = "1.0";
+  std::vector<CycleDoctorCap> doctor_caps;
+  std::vector<CycleSprint> sprints;
+};
+
+//   {"contractVersion": "1.0",
+//    "doctorCaps": [{"doctorId": "d1", "maxCycleDays": 6}],
+//    "sprints": [{"id": "s1", "problem": {...SolveRequest...}}]}
+//
+// `doctorCaps` is optional. Streams like ParseProblemInput, handing each
+// sprint's problem to the same SAX handler, and throws the same exceptions.
+CycleProblem ParseCycleProblem(std::istream& input);
+CycleProblem ParseCycleProblem(const std::string& input_json);
+
 }  // namespace scheduler
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <scheduler/problem_input.hpp>
+#include <scheduler/solver.hpp>
+
+namespace scheduler {
+
+// 128-bit content hash of a problem. Not cryptographic: it tells apart
+// problems, not adversaries.
+struct ProblemHash {
+  std::uint64_t high = 0;
+  std::uint64_t low = 0;
+
+  bool operator==(const ProblemHash& other) const { return high == other.high && low == other.low; }
+  bool operator!=(const ProblemHash& other) const { return !(*this == other); }
+  // 32 lowercase hex digits.
+  std::string ToHex() const;
+};
+
+struct ProblemHashHasher {
+  std::size_t operator()(const ProblemHash& hash) const { return static_cast<std::size_t>(hash.low); }
+};
+
+// Canonical hash of `input`: ids are hashed by name, and the order of doctors,
+// periods, days within a period, demands and availability does not matter
+// (each is hashed as a multiset). Duplicates still count.
+ProblemHash HashProblem(const ProblemView& input);
+// Version of what a cache entry holds. Bump it whenever the engine may return
+// a different result for the same problem and options, or the stored JSON
+// changes: it is part of every SolveCacheKey, so entries an older engine
+// wrote are never served (on disk they age out like any other entry).
+inline constexpr std::uint64_t kResultCacheVersion = 1;
+
+// HashProblem mixed with kResultCacheVersion and the options that change a
+// result: algorithm, warm start, load balancing and min-cut report. Threads
+// and budgets do not.
+ProblemHash SolveCacheKey(const ProblemView& input, const SolveOptions& options);
+
+// A cached result may come from the same problem listed in another order:
+// re-sorts its assignments (doctor position, then period and day symbol) and
+// uncovered days (demand order) for `input`. Min-cut lists keep the order of
+// the solve that filled the entry.
+void ReorderCachedResult(SolveResult& result, const ProblemView& input);
+
+struct ResultCacheOptions {
+  // Entries kept in memory; the least recently used one is evicted first.
+  std::size_t capacity = 256;
+  // When set, every entry is also written to `<directory>/<hash>.json` and a
+  // memory miss falls back to that file, so results survive the process.
+  std::string directory;
+  // Files kept in `directory`; past it an insert removes the least recently
+  // written or read ones. Files already past it are only pruned by the first
+  // insert that adds one. 0 leaves the directory unbounded, to be cleaned up
+  // from outside.
+  std::size_t disk_capacity = 4096;
+};
+
+struct ResultCacheCounters {
+  long long hits = 0;
+  // Hits served from `directory` after a memory miss; included in `hits`.
+  long long disk_hits = 0;
+  long long misses = 0;
+  long long evictions = 0;
+  // Files removed from `directory` by disk_capacity.
+  long long disk_evictions = 0;
+};
+
+// Bounded LRU of solve results keyed by SolveCacheKey, safe to share between
+// threads (one mutex; disk reads and writes happen outside it). Plug it into
+// Solve through SolveOptions::result_cache.
+class ResultCache {
+ public:
+  explicit ResultCache(ResultCacheOptions options = {});
+
+  // Results come back without stats.
+  std::optional<SolveResult> Find(const ProblemHash& key);
+  void Insert(const ProblemHash& key, SolveResult result);
+
+  ResultCacheCounters counters() const;
+  std::size_t size() const;
+
+ private:
+  using Entry = std::pair<ProblemHash, SolveResult>;
+
+  void InsertInMemory(const ProblemHash& key, SolveResult result);
+  std::string PathOf(const ProblemHash& key) const;
+  // Removes the oldest files of `directory` down to disk_capacity; returns
+  // how many files are left and how many were removed.
+  std::pair<std::size_t, std::size_t> PruneDirectory() const;
+
+  ResultCacheOptions options_;
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  std::list<Entry> entries_;
+  std::unordered_map<ProblemHash, std::list<Entry>::iterator, ProblemHashHasher> index_;
+  ResultCacheCounters counters_;
+  // Files in `directory`, as of the last prune plus the entries added since;
+  // unknown until the first insert adds a file, so constructing a cache
+  // (once per one-shot engine run) never lists the directory.
+  std::optional<std::size_t> disk_entries_;
+};
+
+}  // namespace scheduler
@@ -0,0 +1,121 @@
+#pragma once
+
+/*
+ * Stable C ABI over solver_lib for in-process embedding (built as
+ * libscheduler_c and used by the Node addon). Everything is addressed by
+ * index: entities are numbered in the order they are added and results come
+ * back as parallel int32 arrays of those indices, so no ids or JSON cross the
+ * boundary. The caller keeps its own index -> id tables.
+ *
+ * A problem is not thread-safe while it is being filled, but scheduler_solve
+ * only reads it: several threads may solve the same finished problem at once.
+ * Results are owned by the caller and must be freed with scheduler_result_free;
+ * the arrays they expose stay valid until then.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define SCHEDULER_C_API __declspec(dllexport)
+#else
+#define SCHEDULER_C_API __attribute__((visibility("default")))
+#endif
+
+/* Bumped on any incompatible change to the declarations below. */
+#define SCHEDULER_C_ABI_VERSION 1
+
+typedef struct scheduler_problem scheduler_problem;
+typedef struct scheduler_result scheduler_result;
+
+typedef enum scheduler_status {
+  SCHEDULER_OK = 0,
+  SCHEDULER_INVALID_ARGUMENT = 1,
+  SCHEDULER_SOLVE_FAILED = 2,
+} scheduler_status;
+
+typedef enum scheduler_algorithm {
+  SCHEDULER_ALGORITHM_AUTO = 0,
+  SCHEDULER_ALGORITHM_EDMONDS_KARP = 1,
+  SCHEDULER_ALGORITHM_DINIC = 2,
+  SCHEDULER_ALGORITHM_PUSH_RELABEL = 3,
+  SCHEDULER_ALGORITHM_PARALLEL_PUSH_RELABEL = 4,
+} scheduler_algorithm;
+
+/* Lists of the min cut (see scheduler_result_min_cut_entries). Each entry is
+ * one index or a pair of ints, flattened: */
+typedef enum scheduler_min_cut_list {
+  SCHEDULER_MIN_CUT_REACHABLE_DOCTORS = 0,        /* doctor */
+  SCHEDULER_MIN_CUT_REACHABLE_DOCTOR_PERIODS = 1, /* (doctor, period) */
+  SCHEDULER_MIN_CUT_REACHABLE_DAYS = 2,           /* day */
+  SCHEDULER_MIN_CUT_CAPPED_DOCTORS = 3,           /* (doctor, cap): source -> doctor arcs */
+  SCHEDULER_MIN_CUT_PERIOD_LIMITS = 4,            /* (doctor, period): capacity 1 */
+  SCHEDULER_MIN_CUT_CUT_DAYS = 5,                 /* (day, required): day -> sink arcs */
+  SCHEDULER_MIN_CUT_UNCOVERABLE_DAYS = 6,         /* (day, required) */
+} scheduler_min_cut_list;
+
+/* Mirrors SolveOptions; fill with scheduler_solve_options_init first. */
+typedef struct scheduler_solve_options {
+  int32_t algorithm;      /* scheduler_algorithm */
+  int32_t threads;        /* as SolveOptions::threads; default 1 */
+  int32_t time_budget_ms; /* 0 = no budget */
+  int32_t warm_start;     /* non-zero seeds the greedy warm start; default 1 */
+} scheduler_solve_options;
+
+SCHEDULER_C_API int32_t scheduler_abi_version(void);
+SCHEDULER_C_API const char* scheduler_status_message(scheduler_status status);
+
+/* NULL when out of memory. */
+SCHEDULER_C_API scheduler_problem* scheduler_problem_create(void);
+SCHEDULER_C_API void scheduler_problem_free(scheduler_problem* problem);
+
+/* Each returns the new entity's index, or -1 on an invalid argument. */
+SCHEDULER_C_API int32_t scheduler_problem_add_doctor(scheduler_problem* problem, int32_t max_total_days);
+SCHEDULER_C_API int32_t scheduler_problem_add_day(scheduler_problem* problem, int32_t required_doctors);
+SCHEDULER_C_API int32_t scheduler_problem_add_period(scheduler_problem* problem,
+                                                     const int32_t* days,
+                                                     size_t day_count);
+/* Indices must exist. A day outside the period is accepted and ignored by the
+ * solve, like the JSON contract's inconsistent availability. */
+SCHEDULER_C_API scheduler_status scheduler_problem_add_availability(scheduler_problem* problem,
+                                                                    int32_t doctor,
+                                                                    int32_t period,
+                                                                    int32_t day);
+
+SCHEDULER_C_API void scheduler_solve_options_init(scheduler_solve_options* options);
+/* `options` may be NULL for the defaults. On SCHEDULER_OK `*result` owns a new
+ * result; otherwise it is set to NULL. */
+SCHEDULER_C_API scheduler_status scheduler_solve(const scheduler_problem* problem,
+                                                 const scheduler_solve_options* options,
+                                                 scheduler_result** result);
+
+SCHEDULER_C_API int32_t scheduler_result_is_feasible(const scheduler_result* result);
+SCHEDULER_C_API int32_t scheduler_result_is_truncated(const scheduler_result* result);
+/* Assignment i is (doctors[i], periods[i], days[i]), ordered by doctor, then
+ * period and day. */
+SCHEDULER_C_API size_t scheduler_result_assignment_count(const scheduler_result* result);
+SCHEDULER_C_API const int32_t* scheduler_result_assignment_doctors(const scheduler_result* result);
+SCHEDULER_C_API const int32_t* scheduler_result_assignment_periods(const scheduler_result* result);
+SCHEDULER_C_API const int32_t* scheduler_result_assignment_days(const scheduler_result* result);
+/* Days whose demand is not met, ascending. */
+SCHEDULER_C_API size_t scheduler_result_uncovered_day_count(const scheduler_result* result);
+SCHEDULER_C_API const int32_t* scheduler_result_uncovered_days(const scheduler_result* result);
+/* Infeasible, non-truncated results carry the min cut of the JSON contract's
+ * `minCut`, with the node names left to the caller ("source", "doctor:<id>",
+ * "doctor-period:<doctorId>:<periodId>", "day:<id>"). Lists are in the JSON
+ * order; on results without a cut they are empty and the value is 0. */
+SCHEDULER_C_API int32_t scheduler_result_has_min_cut(const scheduler_result* result);
+SCHEDULER_C_API int32_t scheduler_result_min_cut_value(const scheduler_result* result);
+/* Number of entries in `list`; the array holds that many indices or pairs. */
+SCHEDULER_C_API size_t scheduler_result_min_cut_count(const scheduler_result* result, scheduler_min_cut_list list);
+SCHEDULER_C_API const int32_t* scheduler_result_min_cut_entries(const scheduler_result* result,
+                                                                scheduler_min_cut_list list);
+SCHEDULER_C_API void scheduler_result_free(scheduler_result* result);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+#include <scheduler/solver.hpp>
+
+namespace scheduler {
+
+struct CriticalityReport;
+struct CycleSolveResult;
+
+// Serializes a SolveResult into the response contract of packages/domain.
+std::string SerializeSolveResult(const SolveResult& result);
+// `coverageLoss` is written only when the report carries it.
+std::string SerializeCriticalityReport(const CriticalityReport& report);
+// {"contractVersion", "isFeasible", "assignedCount", "sprints": [{"sprintId",
+// "result"}], "truncated"?}; each result follows SerializeSolveResult.
+std::string SerializeCycleSolveResult(const CycleSolveResult& result);
+// Inverse of SerializeSolveResult, without stats. Throws nlohmann::json
+// exceptions on malformed input.
+SolveResult ParseSolveResult(const std::string& result_json);
+
+}  // namespace scheduler
@@ -1,24 +1,183 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <scheduler/flow_network.hpp>
+
 namespace scheduler {
 
+struct ProblemView;
+class ResultCache;
+
 struct Assignment {
   std::string doctor_id;
   std::string day_id;
   std::string period_id;
 };
 
+// Assignment without materialized ids: `doctor` is a position in
+// ProblemView::doctors, `period_id` and `day_id` are symbols.
+struct AssignmentRef {
+  int doctor = 0;
+  std::uint32_t period_id = 0;
+  std::uint32_t day_id = 0;
+};
+
+// Per-solve instrumentation, filled only when SolveOptions::collect_stats is
+// set. Times are wall-clock milliseconds and a binary decode counts as parse;
+// SerializeSolveResult adds its own time when it writes the stats out.
+struct SolveStats {
+  double parse_ms = 0;
+  double build_ms = 0;
+  double max_flow_ms = 0;
+  double extract_ms = 0;
+  int components = 0;
+  long long nodes = 0;
+  long long arcs = 0;
+  // Summed over components.
+  MaxFlowStats max_flow;
+  // Peak resident set of the process (getrusage) when the solve finished.
+  long peak_rss_kb = 0;
+};
+
+// Node names are "source", "sink", "doctor:<id>",
+// "doctor-period:<doctorId>:<periodId>" and "day:<id>".
+struct MinCutEdge {
+  std::string from;
+  std::string to;
+  int capacity = 0;
+};
+
+// A doctor whose day cap is saturated; `cap` is the effective one, i.e.
+// maxTotalDays bounded by the periods the doctor is available in.
+struct CappedDoctor {
+  std::string doctor_id;
+  int cap = 0;
+};
+
+// A doctor already working its one day in the period.
+struct PeriodLimit {
+  std::string doctor_id;
+  std::string period_id;
+};
+
+// A day with demand that no doctor is available for.
+struct UncoverableDay {
+  std::string day_id;
+  int required_doctors = 0;
+};
+
+// Minimum cut of an infeasible solve (see BuildMinCutReport). The bottleneck
+// lists translate the cut arcs: capped doctors (source -> doctor), period
+// limits (doctor -> doctor-period) and days nobody can cover.
+struct MinCutReport {
+  int value = 0;
+  std::vector<std::string> reachable_nodes;
+  std::vector<MinCutEdge> cut_edges;
+  std::vector<CappedDoctor> capped_doctors;
+  std::vector<PeriodLimit> period_limits;
+  std::vector<UncoverableDay> uncoverable_days;
+};
+
+// MinCutReport by index, filled instead of `min_cut` under
+// SolveOptions::index_results: doctors and days are positions in
+// ProblemView::doctors / demands, periods are symbols. Lists keep the
+// report's order; `cut_days` are its day -> sink arcs as (demand, required).
+struct MinCutRefs {
+  int value = 0;
+  std::vector<int> reachable_doctors;
+  std::vector<std::pair<int, std::uint32_t>> reachable_doctor_periods;
+  std::vector<int> reachable_days;
+  std::vector<std::pair<int, int>> capped_doctors;
+  std::vector<std::pair<int, std::uint32_t>> period_limits;
+  std::vector<std::pair<int, int>> cut_days;
+  std::vector<std::pair<int, int>> uncoverable_days;
+};
+
 struct SolveResult {
-  bool is_feasible;
-  int assigned_count;
+  bool is_feasible = false;
+  int assigned_count = 0;
   std::vector<std::string> uncovered_days;
   std::vector<Assignment> assignments;
   std::string contract_version;
+  // Set when a time budget or cancellation stopped the max flow before it was
+  // proven maximum. Assignments and uncovered days then describe the flow
+  // found so far, which is still a valid (partial) roster.
+  bool truncated = false;
+  // Set on infeasible, non-truncated results when SolveOptions::report_min_cut is on.
+  std::optional<MinCutReport> min_cut;
+  std::optional<SolveStats> stats;
+  // Filled instead of `assignments` / `uncovered_days` under
+  // SolveOptions::index_results, in the same order; uncovered days are
+  // positions in ProblemView::demands.
+  std::vector<AssignmentRef> assignment_refs;
+  std::vector<int> uncovered_demands;
+  std::optional<MinCutRefs> min_cut_refs;
+};
+
+struct SolveOptions {
+  // Unset picks the structure-aware layered engine whenever the built network
+  // matches the flow model, and Dinic otherwise.
+  std::optional<MaxFlowAlgorithm> algorithm;
+  // Independent components of the problem (see BuildComponentGraphs) are
+  // solved on up to this many threads; 1 solves them in turn and <= 0 sizes
+  // the pool to the machine. A single-component problem hands the budget to
+  // the engine instead (only kParallelPushRelabel uses it). Results do not
+  // depend on the thread count.
+  int threads = 1;
+  // Attaches SolveStats to the result. Off by default: the engines then run
+  // their non-counting instantiation.
+  bool collect_stats = false;
+  // Seeds each layered network with GreedyWarmStart before the engine runs,
+  // also under an explicit `algorithm`, which then only finishes the flow.
+  bool warm_start = true;
+  // Among the maximum flows, returns one that spreads the days as evenly as
+  // possible over the doctors (BalancedMaxFlow). Replaces `algorithm` and
+  // `warm_start`; the value of the flow is the same.
+  bool balance_load = false;
+  // Attaches the min cut and its bottlenecks to infeasible results; one
+  // residual traversal per component, skipped on feasible or truncated ones.
+  bool report_min_cut = true;
+  // Returns assignments as AssignmentRef and the min cut as MinCutRefs instead
+  // of id strings, for embedders that keep their own id tables (scheduler_c.h).
+  bool index_results = false;
+  // Wall-clock budget for the whole call, parsing included. When it runs out,
+  // or `cancellation` is cancelled, the engines stop at their next check and
+  // the result is truncated instead of late.
+  std::optional<std::chrono::milliseconds> time_budget;
+  const CancellationToken* cancellation = nullptr;
+  // Answers repeated problems from this cache (result_cache.hpp) and stores
+  // every new result that is not truncated. A hit costs a hash and a lookup;
+  // its stats carry only parse time and peak RSS. Ignored under index_results.
+  ResultCache* result_cache = nullptr;
 };
 
-SolveResult Solve(const std::string& input_json);
+struct BatchSolveItem {
+  bool ok = false;
+  SolveResult result;
+  // Set when the item failed; the other items are unaffected.
+  std::string error;
+};
+
+SolveResult Solve(const std::string& input_json, const SolveOptions& options = {});
+// Parses straight from the stream; same result and fallback as the string form.
+SolveResult Solve(std::istream& input, const SolveOptions& options = {});
+
+// Solves an already decoded problem (parsed JSON or a mapped binary problem).
+SolveResult Solve(const ProblemView& input, const SolveOptions& options = {});
+// Solves a binary problem (problem_binary.hpp) in place, without copying it;
+// a buffer that does not decode gets the same fallback as invalid JSON.
+SolveResult SolveBinary(const char* data, std::size_t size, const SolveOptions& options = {});
+
+// Solves independent problems in parallel on a work-stealing pool sized to the
+// machine (capped at the number of inputs). Items come back in input order.
+std::vector<BatchSolveItem> SolveBatch(const std::vector<std::string>& input_jsons, const SolveOptions& options = {});
 
 }  // namespace scheduler
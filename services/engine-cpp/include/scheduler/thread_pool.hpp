@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace scheduler {
+
+// Work-stealing worker pool. Every worker owns a deque: tasks submitted from a
+// worker go to its own deque (LIFO, cache-warm), external submissions are
+// spread round-robin, and idle workers steal from the opposite end of other
+// deques. A task that throws does not take its worker down: the first
+// exception is kept and rethrown by the next Wait().
+class ThreadPool {
+ public:
+  // thread_count <= 0 sizes the pool to the machine.
+  explicit ThreadPool(int thread_count = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void Submit(std::function<void()> task);
+  // Blocks until every task submitted so far has finished, then rethrows the
+  // first exception a task threw since the last Wait(), if any.
+  void Wait();
+
+  int size() const { return static_cast<int>(workers_.size()); }
+
+  static int DefaultThreadCount();
+
+ private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void WaitIdle();
+  void WorkerLoop(int worker_index);
+  bool TryRunOne(int worker_index);
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<unsigned> next_queue_{0};
+  std::atomic<int> pending_{0};
+  std::atomic<int> queued_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable task_available_;
+  std::condition_variable idle_;
+  bool stopping_ = false;
+  // Guarded by sleep_mutex_.
+  std::exception_ptr first_error_;
+};
+
+}  // namespace scheduler
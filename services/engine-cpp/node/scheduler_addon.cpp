@@ -0,0 +1,344 @@
+// Node-API addon over the C ABI (scheduler_c.h). `solve(problem, options?)`
+// takes the problem as Int32Arrays of indices, runs scheduler_solve on a libuv
+// worker thread and resolves with Int32Arrays of assignment indices:
+//
+//   problem: { doctorMaxTotalDays, dayRequiredDoctors, periodDayOffsets,
+//              periodDays, availability }
+//   options: { algorithm?: 'edmonds-karp' | 'dinic' | 'push-relabel' |
+//              'parallel-push-relabel', threads?, timeBudgetMs?, warmStart? }
+//   result:  { isFeasible, truncated, doctors, periods, days, uncoveredDays,
+//              minCut? }
+//   minCut:  { value, reachableDoctors, reachableDoctorPeriods, reachableDays,
+//              cappedDoctors, periodLimits, cutDays, uncoverableDays }
+//
+// Period k owns periodDays[periodDayOffsets[k] .. periodDayOffsets[k + 1]) and
+// availability is a flat list of (doctor, period, day) triples. `minCut` is
+// set on infeasible, non-truncated results; its lists are the
+// scheduler_min_cut_list ones, pairs flattened.
+
+#include <node_api.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <scheduler/scheduler_c.h>
+
+namespace {
+
+struct SolveWork {
+  napi_async_work work = nullptr;
+  napi_deferred deferred = nullptr;
+  scheduler_problem* problem = nullptr;
+  scheduler_solve_options options{};
+  scheduler_result* result = nullptr;
+  scheduler_status status = SCHEDULER_OK;
+};
+
+bool Check(napi_env env, napi_status status) {
+  if (status == napi_ok) {
+    return true;
+  }
+  bool pending = false;
+  napi_is_exception_pending(env, &pending);
+  if (!pending) {
+    const napi_extended_error_info* info = nullptr;
+    napi_get_last_error_info(env, &info);
+    napi_throw_error(env, nullptr, info && info->error_message ? info->error_message : "Node-API call failed");
+  }
+  return false;
+}
+
+// Reads `object[name]` as an Int32Array; throws a TypeError otherwise.
+bool GetInt32Array(napi_env env, napi_value object, const char* name, const int32_t** data, size_t* length) {
+  napi_value value;
+  if (!Check(env, napi_get_named_property(env, object, name, &value))) {
+    return false;
+  }
+  bool is_typedarray = false;
+  napi_is_typedarray(env, value, &is_typedarray);
+  napi_typedarray_type type = napi_int8_array;
+  void* raw = nullptr;
+  if (is_typedarray) {
+    if (!Check(env, napi_get_typedarray_info(env, value, &type, length, &raw, nullptr, nullptr))) {
+      return false;
+    }
+  }
+  if (!is_typedarray || type != napi_int32_array) {
+    napi_throw_type_error(env, nullptr, (std::string("problem.") + name + " must be an Int32Array").c_str());
+    return false;
+  }
+  *data = static_cast<const int32_t*>(raw);
+  return true;
+}
+
+bool GetOptionalInt(napi_env env, napi_value object, const char* name, int32_t* out) {
+  bool has = false;
+  if (!Check(env, napi_has_named_property(env, object, name, &has))) {
+    return false;
+  }
+  if (!has) {
+    return true;
+  }
+  napi_value value;
+  napi_valuetype type;
+  if (!Check(env, napi_get_named_property(env, object, name, &value)) || !Check(env, napi_typeof(env, value, &type))) {
+    return false;
+  }
+  if (type == napi_undefined) {
+    return true;
+  }
+  if (type == napi_boolean) {
+    bool flag = false;
+    napi_get_value_bool(env, value, &flag);
+    *out = flag ? 1 : 0;
+    return true;
+  }
+  if (type != napi_number) {
+    napi_throw_type_error(env, nullptr, (std::string("options.") + name + " must be a number").c_str());
+    return false;
+  }
+  return Check(env, napi_get_value_int32(env, value, out));
+}
+
+bool ReadOptions(napi_env env, napi_value object, scheduler_solve_options* options) {
+  scheduler_solve_options_init(options);
+  napi_valuetype type;
+  if (!Check(env, napi_typeof(env, object, &type))) {
+    return false;
+  }
+  if (type == napi_undefined || type == napi_null) {
+    return true;
+  }
+  if (type != napi_object) {
+    napi_throw_type_error(env, nullptr, "options must be an object");
+    return false;
+  }
+
+  bool has_algorithm = false;
+  napi_has_named_property(env, object, "algorithm", &has_algorithm);
+  if (has_algorithm) {
+    napi_value value;
+    char name[32] = {0};
+    size_t length = 0;
+    napi_get_named_property(env, object, "algorithm", &value);
+    napi_valuetype algorithm_type;
+    napi_typeof(env, value, &algorithm_type);
+    if (algorithm_type == napi_string) {
+      napi_get_value_string_utf8(env, value, name, sizeof(name), &length);
+      if (std::strcmp(name, "edmonds-karp") == 0) {
+        options->algorithm = SCHEDULER_ALGORITHM_EDMONDS_KARP;
+      } else if (std::strcmp(name, "dinic") == 0) {
+        options->algorithm = SCHEDULER_ALGORITHM_DINIC;
+      } else if (std::strcmp(name, "push-relabel") == 0) {
+        options->algorithm = SCHEDULER_ALGORITHM_PUSH_RELABEL;
+      } else if (std::strcmp(name, "parallel-push-relabel") == 0) {
+        options->algorithm = SCHEDULER_ALGORITHM_PARALLEL_PUSH_RELABEL;
+      } else {
+        napi_throw_range_error(env, nullptr, "options.algorithm is not a known algorithm");
+        return false;
+      }
+    } else if (algorithm_type != napi_undefined) {
+      napi_throw_type_error(env, nullptr, "options.algorithm must be a string");
+      return false;
+    }
+  }
+  return GetOptionalInt(env, object, "threads", &options->threads) &&
+         GetOptionalInt(env, object, "timeBudgetMs", &options->time_budget_ms) &&
+         GetOptionalInt(env, object, "warmStart", &options->warm_start);
+}
+
+// Builds the problem on the calling (main) thread; the typed arrays must not
+// be touched from the worker.
+scheduler_problem* ReadProblem(napi_env env, napi_value object) {
+  const int32_t* max_total_days;
+  const int32_t* required_doctors;
+  const int32_t* period_offsets;
+  const int32_t* period_days;
+  const int32_t* availability;
+  size_t doctor_count, day_count, offset_count, period_day_count, availability_length;
+  if (!GetInt32Array(env, object, "doctorMaxTotalDays", &max_total_days, &doctor_count) ||
+      !GetInt32Array(env, object, "dayRequiredDoctors", &required_doctors, &day_count) ||
+      !GetInt32Array(env, object, "periodDayOffsets", &period_offsets, &offset_count) ||
+      !GetInt32Array(env, object, "periodDays", &period_days, &period_day_count) ||
+      !GetInt32Array(env, object, "availability", &availability, &availability_length)) {
+    return nullptr;
+  }
+  if (offset_count == 0 || availability_length % 3 != 0) {
+    napi_throw_range_error(env, nullptr,
+                           "problem.periodDayOffsets must hold periods + 1 entries and "
+                           "problem.availability whole triples");
+    return nullptr;
+  }
+
+  scheduler_problem* problem = scheduler_problem_create();
+  if (!problem) {
+    napi_throw_error(env, nullptr, "out of memory");
+    return nullptr;
+  }
+  bool ok = true;
+  for (size_t i = 0; ok && i < doctor_count; ++i) {
+    ok = scheduler_problem_add_doctor(problem, max_total_days[i]) >= 0;
+  }
+  for (size_t d = 0; ok && d < day_count; ++d) {
+    ok = scheduler_problem_add_day(problem, required_doctors[d]) >= 0;
+  }
+  for (size_t k = 0; ok && k + 1 < offset_count; ++k) {
+    const int32_t first = period_offsets[k];
+    const int32_t last = period_offsets[k + 1];
+    ok = first >= 0 && first <= last && static_cast<size_t>(last) <= period_day_count &&
+         scheduler_problem_add_period(problem, period_days + first, static_cast<size_t>(last - first)) >= 0;
+  }
+  for (size_t t = 0; ok && t < availability_length; t += 3) {
+    ok = scheduler_problem_add_availability(problem, availability[t], availability[t + 1], availability[t + 2]) ==
+         SCHEDULER_OK;
+  }
+  if (!ok) {
+    scheduler_problem_free(problem);
+    napi_throw_range_error(env, nullptr, "problem references an index out of range");
+    return nullptr;
+  }
+  return problem;
+}
+
+napi_value CopyInt32Array(napi_env env, const int32_t* data, size_t length) {
+  void* raw = nullptr;
+  napi_value buffer;
+  napi_value array;
+  napi_create_arraybuffer(env, length * sizeof(int32_t), &raw, &buffer);
+  if (length > 0) {
+    std::memcpy(raw, data, length * sizeof(int32_t));
+  }
+  napi_create_typedarray(env, napi_int32_array, length, buffer, 0, &array);
+  return array;
+}
+
+napi_value CopyMinCut(napi_env env, const scheduler_result* result) {
+  static constexpr struct {
+    scheduler_min_cut_list list;
+    const char* name;
+    size_t width;
+  } kLists[] = {
+      {SCHEDULER_MIN_CUT_REACHABLE_DOCTORS, "reachableDoctors", 1},
+      {SCHEDULER_MIN_CUT_REACHABLE_DOCTOR_PERIODS, "reachableDoctorPeriods", 2},
+      {SCHEDULER_MIN_CUT_REACHABLE_DAYS, "reachableDays", 1},
+      {SCHEDULER_MIN_CUT_CAPPED_DOCTORS, "cappedDoctors", 2},
+      {SCHEDULER_MIN_CUT_PERIOD_LIMITS, "periodLimits", 2},
+      {SCHEDULER_MIN_CUT_CUT_DAYS, "cutDays", 2},
+      {SCHEDULER_MIN_CUT_UNCOVERABLE_DAYS, "uncoverableDays", 2},
+  };
+  napi_value cut;
+  napi_value value;
+  napi_create_object(env, &cut);
+  napi_create_int32(env, scheduler_result_min_cut_value(result), &value);
+  napi_set_named_property(env, cut, "value", value);
+  for (const auto& entry : kLists) {
+    napi_set_named_property(env, cut, entry.name,
+                            CopyInt32Array(env, scheduler_result_min_cut_entries(result, entry.list),
+                                           entry.width * scheduler_result_min_cut_count(result, entry.list)));
+  }
+  return cut;
+}
+
+void ExecuteSolve(napi_env, void* data) {
+  auto* work = static_cast<SolveWork*>(data);
+  work->status = scheduler_solve(work->problem, &work->options, &work->result);
+}
+
+void CompleteSolve(napi_env env, napi_status status, void* data) {
+  auto* work = static_cast<SolveWork*>(data);
+  if (status != napi_ok || work->status != SCHEDULER_OK) {
+    napi_value message;
+    napi_value error;
+    const char* text = status != napi_ok ? "solve was cancelled" : scheduler_status_message(work->status);
+    napi_create_string_utf8(env, text, NAPI_AUTO_LENGTH, &message);
+    napi_create_error(env, nullptr, message, &error);
+    napi_reject_deferred(env, work->deferred, error);
+  } else {
+    const scheduler_result* result = work->result;
+    const size_t count = scheduler_result_assignment_count(result);
+    napi_value output;
+    napi_value is_feasible;
+    napi_value truncated;
+    napi_create_object(env, &output);
+    napi_get_boolean(env, scheduler_result_is_feasible(result) != 0, &is_feasible);
+    napi_get_boolean(env, scheduler_result_is_truncated(result) != 0, &truncated);
+    napi_set_named_property(env, output, "isFeasible", is_feasible);
+    napi_set_named_property(env, output, "truncated", truncated);
+    napi_set_named_property(env, output, "doctors",
+                            CopyInt32Array(env, scheduler_result_assignment_doctors(result), count));
+    napi_set_named_property(env, output, "periods",
+                            CopyInt32Array(env, scheduler_result_assignment_periods(result), count));
+    napi_set_named_property(env, output, "days", CopyInt32Array(env, scheduler_result_assignment_days(result), count));
+    napi_set_named_property(
+        env, output, "uncoveredDays",
+        CopyInt32Array(env, scheduler_result_uncovered_days(result), scheduler_result_uncovered_day_count(result)));
+    if (scheduler_result_has_min_cut(result) != 0) {
+      napi_set_named_property(env, output, "minCut", CopyMinCut(env, result));
+    }
+    napi_resolve_deferred(env, work->deferred, output);
+  }
+
+  scheduler_result_free(work->result);
+  scheduler_problem_free(work->problem);
+  napi_delete_async_work(env, work->work);
+  delete work;
+}
+
+napi_value Solve(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value args[2];
+  napi_get_undefined(env, &args[1]);
+  if (!Check(env, napi_get_cb_info(env, info, &argc, args, nullptr, nullptr))) {
+    return nullptr;
+  }
+  napi_valuetype type = napi_undefined;
+  if (argc >= 1) {
+    napi_typeof(env, args[0], &type);
+  }
+  if (type != napi_object) {
+    napi_throw_type_error(env, nullptr, "solve expects a problem object");
+    return nullptr;
+  }
+
+  scheduler_solve_options options;
+  if (!ReadOptions(env, args[1], &options)) {
+    return nullptr;
+  }
+  scheduler_problem* problem = ReadProblem(env, args[0]);
+  if (!problem) {
+    return nullptr;
+  }
+
+  auto* work = new SolveWork();
+  work->problem = problem;
+  work->options = options;
+  napi_value promise;
+  napi_value resource_name;
+  napi_create_string_utf8(env, "schedulerSolve", NAPI_AUTO_LENGTH, &resource_name);
+  if (!Check(env, napi_create_promise(env, &work->deferred, &promise)) ||
+      !Check(env, napi_create_async_work(env, nullptr, resource_name, ExecuteSolve, CompleteSolve, work, &work->work)) ||
+      !Check(env, napi_queue_async_work(env, work->work))) {
+    if (work->work) {
+      napi_delete_async_work(env, work->work);
+    }
+    scheduler_problem_free(problem);
+    delete work;
+    return nullptr;
+  }
+  return promise;
+}
+
+napi_value Init(napi_env env, napi_value exports) {
+  napi_value solve;
+  napi_value abi_version;
+  napi_create_function(env, "solve", NAPI_AUTO_LENGTH, Solve, nullptr, &solve);
+  napi_create_int32(env, scheduler_abi_version(), &abi_version);
+  napi_set_named_property(env, exports, "solve", solve);
+  napi_set_named_property(env, exports, "abiVersion", abi_version);
+  return exports;
+}
+
+}  // namespace
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -1,30 +1,100 @@
 #include <scheduler/assignment_extractor.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
 namespace scheduler {
 
-ExtractionResult ExtractAssignmentsAndCoverage(
-    const FlowNetwork& network,
-    const std::vector<AssignmentEdgeRef>& assignment_edges,
-    const std::vector<DayDemandRef>& day_edges) {
-  ExtractionResult result;
+namespace {
 
-  for (const AssignmentEdgeRef& edge_ref : assignment_edges) {
-    const Edge& edge = network.GetEdge(edge_ref.from, edge_ref.edge_index);
-    const int flow = edge.original_capacity - edge.capacity;
-    if (flow > 0) {
-      result.assignments.push_back(edge_ref.assignment);
+void CollectAssignedSlots(const GraphBuildResult& graph, std::vector<AssignmentRef>& assigned) {
+  // Edges of one class-period are contiguous, so a class cursor that keeps
+  // advancing hands each doctor at most one day of that period.
+  std::vector<std::size_t> next_member(graph.doctor_classes.size(), 0);
+  for (const AssignmentEdgeRef& edge_ref : graph.assignment_edges) {
+    const std::vector<int>& members = graph.doctor_classes[edge_ref.doctor_class].doctors;
+    std::size_t& next = next_member[edge_ref.doctor_class];
+    for (int unit = graph.network.Flow(edge_ref.arc); unit > 0; --unit) {
+      assigned.push_back(AssignmentRef{members[next], edge_ref.period_id, edge_ref.day_id});
+      next = (next + 1) % members.size();
     }
   }
+}
 
-  for (const DayDemandRef& day_ref : day_edges) {
-    const Edge& edge = network.GetEdge(day_ref.from, day_ref.edge_index);
-    const int covered = edge.original_capacity - edge.capacity;
-    if (covered < day_ref.required) {
-      result.uncovered_days.push_back(day_ref.day_id);
+void CollectUncoveredDays(const GraphBuildResult& graph, std::vector<std::pair<int, std::uint32_t>>& uncovered) {
+  for (const DayDemandRef& day_ref : graph.day_edges) {
+    if (graph.network.Flow(day_ref.arc) < day_ref.required) {
+      uncovered.emplace_back(day_ref.demand, day_ref.day_id);
     }
   }
+}
+
+void SortAssigned(std::vector<AssignmentRef>& assigned) {
+  std::sort(assigned.begin(), assigned.end(), [](const AssignmentRef& a, const AssignmentRef& b) {
+    return std::tie(a.doctor, a.period_id, a.day_id) < std::tie(b.doctor, b.period_id, b.day_id);
+  });
+}
+
+ExtractionResult Materialize(std::vector<AssignmentRef>& assigned,
+                             std::vector<std::pair<int, std::uint32_t>>& uncovered,
+                             const ProblemView& input) {
+  ExtractionResult result;
+
+  SortAssigned(assigned);
+  result.assignments.reserve(assigned.size());
+  for (const AssignmentRef& slot : assigned) {
+    result.assignments.push_back(Assignment{
+        std::string(input.doctor_ids.Name(input.doctors[slot.doctor].id)),
+        std::string(input.day_ids.Name(slot.day_id)),
+        std::string(input.period_ids.Name(slot.period_id)),
+    });
+  }
+
+  std::sort(uncovered.begin(), uncovered.end());
+  result.uncovered_days.reserve(uncovered.size());
+  for (const auto& [demand, day_id] : uncovered) {
+    result.uncovered_days.emplace_back(input.day_ids.Name(day_id));
+  }
 
   return result;
 }
 
+}  // namespace
+
+ExtractionResult ExtractAssignmentsAndCoverage(const GraphBuildResult& graph, const ProblemView& input) {
+  std::vector<AssignmentRef> assigned;
+  std::vector<std::pair<int, std::uint32_t>> uncovered;
+  CollectAssignedSlots(graph, assigned);
+  CollectUncoveredDays(graph, uncovered);
+  return Materialize(assigned, uncovered, input);
+}
+
+ExtractionResult ExtractAssignmentsAndCoverage(const std::vector<GraphBuildResult>& graphs, const ProblemView& input) {
+  std::vector<AssignmentRef> assigned;
+  std::vector<std::pair<int, std::uint32_t>> uncovered;
+  for (const GraphBuildResult& graph : graphs) {
+    CollectAssignedSlots(graph, assigned);
+    CollectUncoveredDays(graph, uncovered);
+  }
+  return Materialize(assigned, uncovered, input);
+}
+
+ExtractionRefs ExtractAssignmentRefs(const std::vector<GraphBuildResult>& graphs) {
+  ExtractionRefs refs;
+  std::vector<std::pair<int, std::uint32_t>> uncovered;
+  for (const GraphBuildResult& graph : graphs) {
+    CollectAssignedSlots(graph, refs.assignments);
+    CollectUncoveredDays(graph, uncovered);
+  }
+  SortAssigned(refs.assignments);
+  std::sort(uncovered.begin(), uncovered.end());
+  refs.uncovered_demands.reserve(uncovered.size());
+  for (const auto& [demand, day_id] : uncovered) {
+    refs.uncovered_demands.push_back(demand);
+  }
+  return refs;
+}
+
 }  // namespace scheduler
@@ -0,0 +1,279 @@
+#include <scheduler/balanced_max_flow.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace scheduler {
+
+namespace {
+
+constexpr long long kUnreached = std::numeric_limits<long long>::max();
+
+template <bool kCount>
+class BalancedFlow {
+ public:
+  BalancedFlow(GraphBuildResult& graph, MaxFlowStats& stats, const StopCondition* stop)
+      : network_(graph.network),
+        source_(graph.source),
+        sink_(graph.sink),
+        stats_(stats),
+        stop_(stop),
+        members_(network_.arc_count(), 0),
+        potential_(network_.node_count(), 0),
+        distance_(network_.node_count()),
+        level_(network_.node_count()),
+        current_arc_(network_.node_count()),
+        queue_(network_.node_count()) {
+    // The parent of a class node (the source, or a cycle group) has a lower id.
+    // A group is one person over every sprint, so its source arc carries the
+    // cost and the per-sprint arcs below it stay free.
+    const FlowLayers& layers = graph.layers;
+    for (int c = 0; c < layers.doctor_count; ++c) {
+      const int node = layers.doctor_offset + c;
+      const int members = static_cast<int>(graph.doctor_classes[c].doctors.size());
+      for (int arc = network_.FirstArc(node); arc < network_.EndArc(node); ++arc) {
+        if (network_.Head(arc) == source_) {
+          SetMembers(network_.ReverseArc(arc), members);
+        }
+      }
+    }
+    for (int group = 0; group < layers.doctor_offset; ++group) {
+      for (int arc = network_.FirstArc(group); group != source_ && arc < network_.EndArc(group); ++arc) {
+        if (network_.Head(arc) == source_) {
+          SetMembers(network_.ReverseArc(arc), 1);
+        }
+      }
+    }
+  }
+
+  int Run() {
+    int total_flow = 0;
+    while (!ShouldStop() && ShortestPaths()) {
+      while (!ShouldStop() && AdmissibleLevels()) {
+        total_flow += BlockingFlow();
+      }
+    }
+    return total_flow;
+  }
+
+ private:
+  bool ShouldStop() const { return stop_ && stop_->ShouldStop(); }
+
+  void SetMembers(int arc, int members) {
+    members_[arc] = members;
+    members_[network_.ReverseArc(arc)] = -members;
+  }
+
+  // Cost of one more unit on `arc`: the marginal step of a class arc, its
+  // refund on the reverse arc, 0 elsewhere.
+  long long Cost(int arc) const {
+    const int members = members_[arc];
+    if (members > 0) {
+      return 2LL * (network_.Flow(arc) / members) + 1;
+    }
+    if (members < 0) {
+      return -(2LL * ((network_.Residual(arc) - 1) / -members) + 1);
+    }
+    return 0;
+  }
+
+  // Units `arc` takes before its cost changes.
+  int StepRoom(int arc) const {
+    const int members = members_[arc];
+    if (members > 0) {
+      return members - network_.Flow(arc) % members;
+    }
+    if (members < 0) {
+      return (network_.Residual(arc) - 1) % -members + 1;
+    }
+    return std::numeric_limits<int>::max();
+  }
+
+  long long ReducedCost(int from, int arc) const {
+    return Cost(arc) + potential_[from] - potential_[network_.Head(arc)];
+  }
+
+  bool Admissible(int from, int arc) const { return network_.Residual(arc) > 0 && ReducedCost(from, arc) == 0; }
+
+  // Dijkstra on reduced costs, stopped once the sink is settled; every node
+  // then moves by min(distance, sink distance), which keeps reduced costs
+  // non-negative and makes the shortest paths to the sink cost 0. Reduced
+  // costs are small integers, so the queue is one bucket per distance, and a
+  // candidate no shorter than the sink's is never queued.
+  bool ShortestPaths() {
+    if constexpr (kCount) {
+      ++stats_.phases;
+    }
+    std::fill(distance_.begin(), distance_.end(), kUnreached);
+    for (std::vector<int>& bucket : buckets_) {
+      bucket.clear();
+    }
+    distance_[source_] = 0;
+    Enqueue(0, source_);
+    for (std::size_t distance = 0; distance < buckets_.size(); ++distance) {
+      // Arcs of reduced cost 0 append to the bucket being drained.
+      for (std::size_t i = 0; i < buckets_[distance].size(); ++i) {
+        const int node = buckets_[distance][i];
+        if (distance_[node] != static_cast<long long>(distance)) {
+          continue;
+        }
+        if (node == sink_) {
+          return UpdatePotentials();
+        }
+        if constexpr (kCount) {
+          stats_.arcs_scanned += network_.EndArc(node) - network_.FirstArc(node);
+        }
+        for (int arc = network_.FirstArc(node); arc < network_.EndArc(node); ++arc) {
+          if (network_.Residual(arc) <= 0) {
+            continue;
+          }
+          const int head = network_.Head(arc);
+          const long long candidate = static_cast<long long>(distance) + ReducedCost(node, arc);
+          if (candidate < distance_[head] && candidate < distance_[sink_]) {
+            distance_[head] = candidate;
+            Enqueue(candidate, head);
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  void Enqueue(long long distance, int node) {
+    if (static_cast<std::size_t>(distance) >= buckets_.size()) {
+      buckets_.resize(distance + 1);
+    }
+    buckets_[distance].push_back(node);
+  }
+
+  bool UpdatePotentials() {
+    const long long sink_distance = distance_[sink_];
+    for (int node = 0; node < network_.node_count(); ++node) {
+      potential_[node] += std::min(distance_[node], sink_distance);
+    }
+    return true;
+  }
+
+  // BFS levels over the arcs of reduced cost 0, stopped once the sink is
+  // labelled: nothing further out lies on a shortest admissible path.
+  bool AdmissibleLevels() {
+    if constexpr (kCount) {
+      ++stats_.phases;
+    }
+    std::fill(level_.begin(), level_.end(), -1);
+    int queue_head = 0;
+    int queue_tail = 0;
+    level_[source_] = 0;
+    queue_[queue_tail++] = source_;
+    while (queue_head < queue_tail) {
+      const int node = queue_[queue_head++];
+      if constexpr (kCount) {
+        stats_.arcs_scanned += network_.EndArc(node) - network_.FirstArc(node);
+      }
+      for (int arc = network_.FirstArc(node); arc < network_.EndArc(node); ++arc) {
+        const int head = network_.Head(arc);
+        if (level_[head] == -1 && Admissible(node, arc)) {
+          level_[head] = level_[node] + 1;
+          if (head == sink_) {
+            return true;
+          }
+          queue_[queue_tail++] = head;
+        }
+      }
+    }
+    return false;
+  }
+
+  // Same walk as FlowNetwork::Dinic, restricted to admissible arcs and capped
+  // by the cost step of class arcs.
+  int BlockingFlow() {
+    for (int node = 0; node < network_.node_count(); ++node) {
+      current_arc_[node] = network_.FirstArc(node);
+    }
+    path_.clear();
+    int flow = 0;
+
+    while (true) {
+      const int current = path_.empty() ? source_ : network_.Head(path_.back());
+
+      if (current == sink_) {
+        int path_flow = std::numeric_limits<int>::max();
+        for (const int arc : path_) {
+          path_flow = std::min({path_flow, network_.Residual(arc), StepRoom(arc)});
+        }
+
+        std::size_t retreat_to = path_.size();
+        for (std::size_t i = 0; i < path_.size(); ++i) {
+          network_.Push(path_[i], path_flow);
+        }
+        for (std::size_t i = 0; i < path_.size(); ++i) {
+          const int from = i == 0 ? source_ : network_.Head(path_[i - 1]);
+          if (!Admissible(from, path_[i])) {
+            retreat_to = i;
+            break;
+          }
+        }
+
+        flow += path_flow;
+        if constexpr (kCount) {
+          ++stats_.augmentations;
+        }
+        path_.resize(retreat_to);
+        continue;
+      }
+
+      int& arc = current_arc_[current];
+      const int end_arc = network_.EndArc(current);
+      [[maybe_unused]] const int scan_start = arc;
+      while (arc < end_arc &&
+             (level_[network_.Head(arc)] != level_[current] + 1 || !Admissible(current, arc))) {
+        ++arc;
+      }
+      if constexpr (kCount) {
+        stats_.arcs_scanned += arc - scan_start + (arc < end_arc ? 1 : 0);
+      }
+
+      if (arc < end_arc) {
+        path_.push_back(arc);
+        continue;
+      }
+
+      level_[current] = -1;
+      if (path_.empty()) {
+        break;
+      }
+      path_.pop_back();
+      ++current_arc_[path_.empty() ? source_ : network_.Head(path_.back())];
+    }
+    return flow;
+  }
+
+  FlowNetwork& network_;
+  int source_;
+  int sink_;
+  MaxFlowStats& stats_;
+  const StopCondition* stop_;
+  // Members of the class behind a class arc, 1 on a group arc (negative on
+  // their reverse arcs), 0 for every other arc.
+  std::vector<int> members_;
+  std::vector<long long> potential_;
+  std::vector<long long> distance_;
+  std::vector<std::vector<int>> buckets_;
+  std::vector<int> level_;
+  std::vector<int> current_arc_;
+  std::vector<int> queue_;
+  std::vector<int> path_;
+};
+
+}  // namespace
+
+int BalancedMaxFlow(GraphBuildResult& graph, MaxFlowStats* stats, const StopCondition* stop) {
+  MaxFlowStats unused;
+  if (stats) {
+    return BalancedFlow<true>(graph, *stats, stop).Run();
+  }
+  return BalancedFlow<false>(graph, unused, stop).Run();
+}
+
+}  // namespace scheduler
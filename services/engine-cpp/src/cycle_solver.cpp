@@ -0,0 +1,192 @@
+#include <scheduler/cycle_solver.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <istream>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <scheduler/assignment_extractor.hpp>
+#include <scheduler/graph_builder.hpp>
+
+#include "solver_internal.hpp"
+
+namespace scheduler {
+
+namespace {
+
+// Every sprint concatenated into one problem. Sprint s owns a contiguous range
+// of each array and of each symbol kind; symbols keep no names (the merged
+// view is never serialized), results are mapped back through the offsets.
+struct MergedCycle {
+  std::vector<Doctor> doctors;
+  std::vector<Period> periods;
+  std::vector<std::uint32_t> period_days;
+  std::vector<Demand> demands;
+  std::vector<Availability> availability;
+  // Per sprint, plus a final entry with the totals.
+  std::vector<int> doctor_offset{0};
+  std::vector<int> demand_offset{0};
+  std::vector<std::uint32_t> doctor_symbol_offset{0};
+  std::vector<std::uint32_t> period_symbol_offset{0};
+  std::vector<std::uint32_t> day_symbol_offset{0};
+  std::vector<std::uint32_t> doctor_names;
+  std::vector<std::uint32_t> period_names;
+  std::vector<std::uint32_t> day_names;
+
+  ProblemView View(std::string_view contract_version) const {
+    return ProblemView{
+        contract_version,
+        {{doctor_names.data(), doctor_names.size()}, ""},
+        {{period_names.data(), period_names.size()}, ""},
+        {{day_names.data(), day_names.size()}, ""},
+        {doctors.data(), doctors.size()},
+        {periods.data(), periods.size()},
+        {period_days.data(), period_days.size()},
+        {demands.data(), demands.size()},
+        {availability.data(), availability.size()},
+    };
+  }
+
+  int SprintOf(const std::vector<int>& offsets, int position) const {
+    return static_cast<int>(std::upper_bound(offsets.begin(), offsets.end(), position) - offsets.begin()) - 1;
+  }
+};
+
+MergedCycle MergeSprints(const CycleProblem& problem) {
+  MergedCycle merged;
+  for (const CycleSprint& sprint : problem.sprints) {
+    const ProblemInput& input = sprint.problem;
+    const std::uint32_t doctor_base = merged.doctor_symbol_offset.back();
+    const std::uint32_t period_base = merged.period_symbol_offset.back();
+    const std::uint32_t day_base = merged.day_symbol_offset.back();
+    const auto period_day_base = static_cast<std::uint32_t>(merged.period_days.size());
+
+    for (const Doctor& doctor : input.doctors) {
+      merged.doctors.push_back(Doctor{doctor_base + doctor.id, doctor.max_total_days});
+    }
+    for (const Period& period : input.periods) {
+      merged.periods.push_back(Period{period_base + period.id, period_day_base + period.first_day, period.day_count});
+    }
+    for (const std::uint32_t day : input.period_days) {
+      merged.period_days.push_back(day_base + day);
+    }
+    for (const Demand& demand : input.demands) {
+      merged.demands.push_back(Demand{day_base + demand.day_id, demand.required_doctors});
+    }
+    for (const Availability& available : input.availability) {
+      merged.availability.push_back(Availability{
+          doctor_base + available.doctor_id, period_base + available.period_id, day_base + available.day_id});
+    }
+
+    merged.doctor_offset.push_back(static_cast<int>(merged.doctors.size()));
+    merged.demand_offset.push_back(static_cast<int>(merged.demands.size()));
+    merged.doctor_symbol_offset.push_back(doctor_base + input.doctor_ids.size());
+    merged.period_symbol_offset.push_back(period_base + input.period_ids.size());
+    merged.day_symbol_offset.push_back(day_base + input.day_ids.size());
+  }
+  merged.doctor_names.assign(merged.doctor_symbol_offset.back() + 1, 0);
+  merged.period_names.assign(merged.period_symbol_offset.back() + 1, 0);
+  merged.day_names.assign(merged.day_symbol_offset.back() + 1, 0);
+  return merged;
+}
+
+// One group per distinct doctor id, in first-seen order.
+DoctorGroups GroupDoctors(const CycleProblem& problem) {
+  DoctorGroups groups;
+  std::unordered_map<std::string, int> group_of_id;
+  for (const CycleSprint& sprint : problem.sprints) {
+    for (const Doctor& doctor : sprint.problem.doctors) {
+      const auto [entry, inserted] = group_of_id.emplace(std::string(sprint.problem.doctor_ids.Name(doctor.id)),
+                                                         static_cast<int>(groups.group_cap.size()));
+      if (inserted) {
+        groups.group_cap.push_back(std::numeric_limits<int>::max());
+      }
+      groups.group_of_doctor.push_back(entry->second);
+    }
+  }
+  for (const CycleDoctorCap& cap : problem.doctor_caps) {
+    const auto entry = group_of_id.find(cap.doctor_id);
+    if (entry != group_of_id.end()) {
+      int& group_cap = groups.group_cap[entry->second];
+      group_cap = std::min(group_cap, std::max(0, cap.max_cycle_days));
+    }
+  }
+  return groups;
+}
+
+CycleSolveResult SolveParsedCycle(const CycleProblem& problem,
+                                  const SolveOptions& options,
+                                  StopCondition::Clock::time_point start) {
+  const StopCondition stop = MakeStopCondition(options, start);
+
+  const MergedCycle merged = MergeSprints(problem);
+  std::vector<GraphBuildResult> graphs;
+  graphs.push_back(BuildFlowGraph(merged.View(problem.contract_version), GroupDoctors(problem)));
+  const int max_flow = SolveMaxFlow(graphs.front(), options, nullptr, EngineStop(options, stop));
+
+  CycleSolveResult result;
+  result.contract_version = problem.contract_version;
+  result.truncated = IsTruncated(stop, max_flow, graphs.front().total_demand);
+  result.sprints.reserve(problem.sprints.size());
+  for (const CycleSprint& sprint : problem.sprints) {
+    CycleSprintResult& sprint_result = result.sprints.emplace_back();
+    sprint_result.sprint_id = sprint.id;
+    sprint_result.result.contract_version = problem.contract_version;
+    sprint_result.result.truncated = result.truncated;
+  }
+
+  // Refs come sorted by merged doctor position, hence sprint by sprint and in
+  // each sprint's own (doctor, period, day) order.
+  const ExtractionRefs refs = ExtractAssignmentRefs(graphs);
+  for (const AssignmentRef& ref : refs.assignments) {
+    const int s = merged.SprintOf(merged.doctor_offset, ref.doctor);
+    const ProblemInput& input = problem.sprints[s].problem;
+    const Doctor& doctor = input.doctors[ref.doctor - merged.doctor_offset[s]];
+    result.sprints[s].result.assignments.push_back(Assignment{
+        std::string(input.doctor_ids.Name(doctor.id)),
+        std::string(input.day_ids.Name(ref.day_id - merged.day_symbol_offset[s])),
+        std::string(input.period_ids.Name(ref.period_id - merged.period_symbol_offset[s])),
+    });
+  }
+  for (const int demand : refs.uncovered_demands) {
+    const int s = merged.SprintOf(merged.demand_offset, demand);
+    const ProblemInput& input = problem.sprints[s].problem;
+    // Solve reports no uncovered days for a problem it has nothing to route in.
+    if (HasNothingToSolve(input.View())) {
+      continue;
+    }
+    result.sprints[s].result.uncovered_days.emplace_back(
+        input.day_ids.Name(input.demands[demand - merged.demand_offset[s]].day_id));
+  }
+
+  for (std::size_t s = 0; s < problem.sprints.size(); ++s) {
+    const ProblemInput& input = problem.sprints[s].problem;
+    SolveResult& sprint_result = result.sprints[s].result;
+    sprint_result.assigned_count = static_cast<int>(sprint_result.assignments.size());
+    // Same rule as Solve: a sprint without doctors or demands is not feasible.
+    sprint_result.is_feasible = sprint_result.uncovered_days.empty() && !HasNothingToSolve(input.View());
+    result.assigned_count += sprint_result.assigned_count;
+  }
+  result.is_feasible = !result.sprints.empty() &&
+                       std::all_of(result.sprints.begin(), result.sprints.end(),
+                                   [](const CycleSprintResult& sprint) { return sprint.result.is_feasible; });
+  return result;
+}
+
+}  // namespace
+
+CycleSolveResult SolveCycle(const CycleProblem& problem, const SolveOptions& options) {
+  return SolveParsedCycle(problem, options, StopCondition::Clock::now());
+}
+
+CycleSolveResult SolveCycle(std::istream& input, const SolveOptions& options) {
+  const auto parse_start = StopCondition::Clock::now();
+  return SolveParsedCycle(ParseCycleProblem(input), options, parse_start);
+}
+
+}  // namespace scheduler
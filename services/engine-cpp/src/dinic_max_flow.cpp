@@ -0,0 +1,119 @@
+#include <scheduler/flow_network.hpp>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace scheduler {
+
+namespace {
+
+// One blocking flow can take the whole solve on a large network, so stop is
+// also polled every this many augmentations inside it.
+constexpr int kStopCheckInterval = 256;
+
+}  // namespace
+
+// Dinic: BFS level graph from the source, then blocking flow by DFS that keeps
+// a current-arc pointer per node and prunes dead ends for the rest of the phase.
+template <bool kCount>
+int FlowNetwork::Dinic(int source, int sink, MaxFlowStats& stats, const StopCondition* stop) {
+  std::vector<int> level(node_count_);
+  std::vector<int> current_arc(node_count_);
+  std::vector<int> bfs_queue(node_count_);
+  std::vector<int> path;
+  path.reserve(node_count_);
+  int total_flow = 0;
+  int augmentations = 0;
+
+  while (!(stop && stop->ShouldStop())) {
+    std::fill(level.begin(), level.end(), -1);
+    int queue_head = 0;
+    int queue_tail = 0;
+    level[source] = 0;
+    bfs_queue[queue_tail++] = source;
+
+    if constexpr (kCount) {
+      ++stats.phases;
+    }
+    while (queue_head < queue_tail) {
+      const int current = bfs_queue[queue_head++];
+      if constexpr (kCount) {
+        stats.arcs_scanned += first_arc_[current + 1] - first_arc_[current];
+      }
+      for (int arc = first_arc_[current]; arc < first_arc_[current + 1]; ++arc) {
+        if (residual_[arc] > 0 && level[head_[arc]] == -1) {
+          level[head_[arc]] = level[current] + 1;
+          bfs_queue[queue_tail++] = head_[arc];
+        }
+      }
+    }
+
+    if (level[sink] == -1) {
+      break;
+    }
+
+    std::copy(first_arc_.begin(), first_arc_.end() - 1, current_arc.begin());
+    path.clear();
+
+    while (true) {
+      const int current = path.empty() ? source : head_[path.back()];
+
+      if (current == sink) {
+        int path_flow = std::numeric_limits<int>::max();
+        for (const int arc : path) {
+          path_flow = std::min(path_flow, residual_[arc]);
+        }
+
+        std::size_t retreat_to = path.size();
+        for (std::size_t i = 0; i < path.size(); ++i) {
+          Push(path[i], path_flow);
+          if (residual_[path[i]] == 0 && retreat_to == path.size()) {
+            retreat_to = i;
+          }
+        }
+
+        total_flow += path_flow;
+        if constexpr (kCount) {
+          ++stats.augmentations;
+        }
+        path.resize(retreat_to);
+        if (stop && ++augmentations == kStopCheckInterval) {
+          augmentations = 0;
+          if (stop->ShouldStop()) {
+            break;
+          }
+        }
+        continue;
+      }
+
+      int& arc = current_arc[current];
+      const int end_arc = first_arc_[current + 1];
+      [[maybe_unused]] const int scan_start = arc;
+      while (arc < end_arc && (residual_[arc] <= 0 || level[head_[arc]] != level[current] + 1)) {
+        ++arc;
+      }
+      if constexpr (kCount) {
+        stats.arcs_scanned += arc - scan_start + (arc < end_arc ? 1 : 0);
+      }
+
+      if (arc < end_arc) {
+        path.push_back(arc);
+        continue;
+      }
+
+      level[current] = -1;
+      if (path.empty()) {
+        break;
+      }
+      path.pop_back();
+      ++current_arc[path.empty() ? source : head_[path.back()]];
+    }
+  }
+
+  return total_flow;
+}
+
+template int FlowNetwork::Dinic<false>(int, int, MaxFlowStats&, const StopCondition*);
+template int FlowNetwork::Dinic<true>(int, int, MaxFlowStats&, const StopCondition*);
+
+}  // namespace scheduler
@@ -0,0 +1,414 @@
+#include <scheduler/engine_server.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <scheduler/problem_input.hpp>
+#include <scheduler/solve_result_json.hpp>
+#include <scheduler/thread_pool.hpp>
+
+#include "problem_input_sax.hpp"
+#include "solver_internal.hpp"
+
+namespace scheduler {
+
+namespace {
+
+using Json = nlohmann::json;
+using Clock = StopCondition::Clock;
+using DomSax = nlohmann::detail::json_sax_dom_parser<Json>;
+
+std::string ErrorResponse(const Json& id, const std::string& code, const std::string& message) {
+  const Json response = {
+      {"id", id},
+      {"status", "error"},
+      {"error", {{"code", code}, {"message", message}}},
+  };
+  return response.dump();
+}
+
+// Feeds one JSON value, event by event, to a ProblemInputSax. Content errors
+// only mark the problem invalid, the way Solve falls back on a payload it
+// cannot parse; the caller keeps consuming the rest of the value.
+class ProblemForwarder {
+ public:
+  void Begin(ProblemInput& problem) {
+    problem = ProblemInput();
+    sax_.emplace(problem);
+    valid_ = true;
+  }
+
+  template <typename Event>
+  void Forward(const Event& event) {
+    if (!sax_) {
+      return;
+    }
+    try {
+      event(*sax_);
+    } catch (const std::exception&) {
+      sax_.reset();
+      valid_ = false;
+    }
+  }
+
+  void End() { sax_.reset(); }
+  bool valid() const { return valid_; }
+
+ private:
+  std::optional<detail::ProblemInputSax> sax_;
+  bool valid_ = false;
+};
+
+// Base for the two single-pass handlers below: tracks the one root container
+// and how deep the current member value is. Derived sees each member value
+// begin (BeginValue) and end (EndValue), and every event of it (Route).
+template <typename Derived>
+class ValueRouterSax {
+ public:
+  bool null() {
+    return Value([](auto& sax) { return sax.null(); });
+  }
+  bool boolean(bool value) {
+    return Value([value](auto& sax) { return sax.boolean(value); });
+  }
+  bool number_integer(Json::number_integer_t value) {
+    return Value([value](auto& sax) { return sax.number_integer(value); });
+  }
+  bool number_unsigned(Json::number_unsigned_t value) {
+    return Value([value](auto& sax) { return sax.number_unsigned(value); });
+  }
+  bool number_float(Json::number_float_t value, const Json::string_t& text) {
+    return Value([value, &text](auto& sax) { return sax.number_float(value, text); });
+  }
+  bool string(Json::string_t& value) {
+    return Value([&value](auto& sax) { return sax.string(value); });
+  }
+  bool binary(Json::binary_t& value) {
+    return Value([&value](auto& sax) { return sax.binary(value); });
+  }
+
+  bool start_object(std::size_t size) {
+    if (!root_open_) {
+      root_open_ = self().OpensRoot(true);
+      return root_open_;
+    }
+    return Open(true, [size](auto& sax) { return sax.start_object(size); });
+  }
+  bool start_array(std::size_t size) {
+    if (!root_open_) {
+      root_open_ = self().OpensRoot(false);
+      return root_open_;
+    }
+    return Open(false, [size](auto& sax) { return sax.start_array(size); });
+  }
+  bool end_object() {
+    return Close([](auto& sax) { return sax.end_object(); });
+  }
+  bool end_array() {
+    return Close([](auto& sax) { return sax.end_array(); });
+  }
+
+  bool key(Json::string_t& value) {
+    if (depth_ == 0) {
+      self().RootKey(value);
+      return true;
+    }
+    self().Route([&value](auto& sax) { return sax.key(value); });
+    return true;
+  }
+
+  template <class Exception>
+  bool parse_error(std::size_t, const std::string&, const Exception& error) {
+    throw error;
+  }
+
+ private:
+  Derived& self() { return static_cast<Derived&>(*this); }
+
+  // A root that is not the expected container stops the parse (sax_parse
+  // returns false); the caller reports it.
+  template <typename Event>
+  bool Value(const Event& event) {
+    if (!root_open_) {
+      return false;
+    }
+    if (depth_ == 0) {
+      self().BeginValue(false);
+    }
+    self().Route(event);
+    if (depth_ == 0) {
+      self().EndValue();
+    }
+    return true;
+  }
+
+  template <typename Event>
+  bool Open(bool is_object, const Event& event) {
+    if (depth_++ == 0) {
+      self().BeginValue(is_object);
+    }
+    self().Route(event);
+    return true;
+  }
+
+  template <typename Event>
+  bool Close(const Event& event) {
+    if (depth_ == 0) {
+      root_open_ = false;
+      return true;
+    }
+    self().Route(event);
+    if (--depth_ == 0) {
+      self().EndValue();
+    }
+    return true;
+  }
+
+  bool root_open_ = false;
+  int depth_ = 0;
+};
+
+// {"id": ..., "problem": {...}, "options": {...}} in one pass: `id` and
+// `options` become small DOMs, `problem` streams into a ProblemInput. Repeated
+// keys keep the last value, as a DOM parse did.
+class RequestEnvelopeSax : public ValueRouterSax<RequestEnvelopeSax> {
+ public:
+  explicit RequestEnvelopeSax(ProblemInput& problem) : problem_input_(problem) {}
+
+  const Json& id() const { return id_; }
+  const std::optional<Json>& options() const { return options_; }
+  bool has_problem_object() const { return has_problem_object_; }
+  bool problem_valid() const { return problem_.valid(); }
+
+  bool OpensRoot(bool is_object) const { return is_object; }
+
+  void RootKey(const std::string& key) {
+    if (key == "id") {
+      member_ = Member::kId;
+    } else if (key == "options") {
+      member_ = Member::kOptions;
+    } else if (key == "problem") {
+      member_ = Member::kProblem;
+    } else {
+      member_ = Member::kIgnored;
+    }
+  }
+
+  void BeginValue(bool is_object) {
+    switch (member_) {
+      case Member::kId:
+        id_ = nullptr;
+        dom_.emplace(id_);
+        break;
+      case Member::kOptions:
+        dom_.emplace(options_.emplace());
+        break;
+      case Member::kProblem:
+        problem_.Begin(problem_input_);
+        has_problem_object_ = is_object;
+        break;
+      case Member::kIgnored:
+        break;
+    }
+  }
+
+  template <typename Event>
+  void Route(const Event& event) {
+    if (member_ == Member::kProblem) {
+      problem_.Forward(event);
+    } else if (dom_) {
+      event(*dom_);
+    }
+  }
+
+  void EndValue() {
+    if (member_ == Member::kProblem) {
+      problem_.End();
+    }
+    dom_.reset();
+  }
+
+ private:
+  enum class Member { kIgnored, kId, kOptions, kProblem };
+
+  ProblemInput& problem_input_;
+  ProblemForwarder problem_;
+  Member member_ = Member::kIgnored;
+  bool has_problem_object_ = false;
+  Json id_ = nullptr;
+  std::optional<Json> options_;
+  std::optional<DomSax> dom_;
+};
+
+// A JSON array of problems in one pass, each element streamed into its own
+// ProblemInput and timed, so its budget can count its own parse only.
+class ProblemArraySax : public ValueRouterSax<ProblemArraySax> {
+ public:
+  struct Element {
+    ProblemInput problem;
+    bool valid = false;
+    Clock::duration parse_time{};
+  };
+
+  explicit ProblemArraySax(std::vector<Element>& elements) : elements_(elements) {}
+
+  bool OpensRoot(bool is_object) const { return !is_object; }
+  void RootKey(const std::string&) {}
+
+  void BeginValue(bool) {
+    element_start_ = Clock::now();
+    problem_.Begin(elements_.emplace_back().problem);
+  }
+
+  template <typename Event>
+  void Route(const Event& event) {
+    problem_.Forward(event);
+  }
+
+  void EndValue() {
+    problem_.End();
+    elements_.back().valid = problem_.valid();
+    elements_.back().parse_time = Clock::now() - element_start_;
+  }
+
+ private:
+  std::vector<Element>& elements_;
+  ProblemForwarder problem_;
+  Clock::time_point element_start_;
+};
+
+}  // namespace
+
+std::string HandleServerRequest(const std::string& line, const SolveOptions& defaults) {
+  const Clock::time_point parse_start = Clock::now();
+  Json id = nullptr;
+
+  try {
+    ProblemInput problem;
+    RequestEnvelopeSax envelope(problem);
+    if (!Json::sax_parse(line, &envelope)) {
+      return ErrorResponse(id, "INVALID_REQUEST", "Request envelope must be a JSON object");
+    }
+    id = envelope.id();
+    if (!envelope.has_problem_object()) {
+      return ErrorResponse(id, "INVALID_REQUEST", "Request envelope requires a 'problem' object");
+    }
+
+    SolveOptions options = defaults;
+    if (envelope.options()) {
+      const Json& request_options = *envelope.options();
+      if (request_options.contains("algorithm")) {
+        const std::string name = request_options["algorithm"].get<std::string>();
+        if (name == "auto") {
+          options.algorithm.reset();
+        } else {
+          const std::optional<MaxFlowAlgorithm> algorithm = ParseMaxFlowAlgorithm(name);
+          if (!algorithm) {
+            return ErrorResponse(id, "INVALID_REQUEST", "Unknown max-flow algorithm: " + name);
+          }
+          options.algorithm = *algorithm;
+        }
+      }
+      if (request_options.contains("stats")) {
+        options.collect_stats = request_options["stats"].get<bool>();
+      }
+      if (request_options.contains("warmStart")) {
+        options.warm_start = request_options["warmStart"].get<bool>();
+      }
+      if (request_options.contains("balanced")) {
+        options.balance_load = request_options["balanced"].get<bool>();
+      }
+      if (request_options.contains("timeBudgetMs")) {
+        const int budget_ms = request_options["timeBudgetMs"].get<int>();
+        if (budget_ms > 0) {
+          options.time_budget = std::chrono::milliseconds(budget_ms);
+        } else {
+          options.time_budget.reset();
+        }
+      }
+    }
+
+    const SolveResult result = envelope.problem_valid() ? SolveParsed(problem.View(), options, parse_start)
+                                                        : InvalidInputResult(options, parse_start);
+    return "{\"id\":" + id.dump() + ",\"status\":\"ok\",\"result\":" + SerializeSolveResult(result) + "}";
+  } catch (const Json::exception& error) {
+    return ErrorResponse(id, "INVALID_REQUEST", error.what());
+  } catch (const std::exception& error) {
+    return ErrorResponse(id, "SOLVE_FAILED", error.what());
+  } catch (...) {
+    return ErrorResponse(id, "SOLVE_FAILED", "Unknown solver failure");
+  }
+}
+
+int RunServer(std::istream& input, std::ostream& output, const ServerOptions& options) {
+  std::mutex output_mutex;
+  ThreadPool pool(options.worker_count);
+
+  std::string line;
+  while (std::getline(input, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos) {
+      continue;
+    }
+
+    pool.Submit([line = std::move(line), &options, &output, &output_mutex] {
+      const std::string response = HandleServerRequest(line, options.solve_options);
+      std::lock_guard<std::mutex> lock(output_mutex);
+      output << response << '\n';
+      output.flush();
+    });
+  }
+
+  pool.Wait();
+  return 0;
+}
+
+int RunBatch(std::istream& input, std::ostream& output, const SolveOptions& options) {
+  std::vector<ProblemArraySax::Element> problems;
+  try {
+    ProblemArraySax handler(problems);
+    if (!Json::sax_parse(input, &handler)) {
+      output << ErrorResponse(nullptr, "INVALID_REQUEST", "Batch input must be a JSON array of problems");
+      return 1;
+    }
+  } catch (const Json::exception& error) {
+    output << ErrorResponse(nullptr, "INVALID_REQUEST", error.what());
+    return 1;
+  }
+
+  // Each budget starts when its solve does, less the time its own parse took:
+  // waiting for the rest of the array or for a worker does not count.
+  const std::vector<BatchSolveItem> items = SolveEach(problems.size(), [&problems, &options](std::size_t i) {
+    const ProblemArraySax::Element& element = problems[i];
+    const Clock::time_point parse_start = Clock::now() - element.parse_time;
+    return element.valid ? SolveParsed(element.problem.View(), options, parse_start)
+                         : InvalidInputResult(options, parse_start);
+  });
+
+  output << '[';
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    if (i > 0) {
+      output << ',';
+    }
+    if (items[i].ok) {
+      output << "{\"status\":\"ok\",\"result\":" << SerializeSolveResult(items[i].result) << '}';
+    } else {
+      const Json failure = {
+          {"status", "error"},
+          {"error", {{"code", "SOLVE_FAILED"}, {"message", items[i].error}}},
+      };
+      output << failure.dump();
+    }
+  }
+  output << ']';
+  return 0;
+}
+
+}  // namespace scheduler
@@ -1,78 +1,250 @@
 #include <scheduler/flow_network.hpp>
 #include <algorithm>
 #include <limits>
-#include <queue>
+#include <stdexcept>
 #include <vector>
 
 namespace scheduler {
 
-FlowNetwork::FlowNetwork(int node_count) : adjacency_(node_count) {}
+std::optional<MaxFlowAlgorithm> ParseMaxFlowAlgorithm(const std::string& name) {
+  if (name == "edmonds-karp") {
+    return MaxFlowAlgorithm::kEdmondsKarp;
+  }
+  if (name == "dinic") {
+    return MaxFlowAlgorithm::kDinic;
+  }
+  if (name == "push-relabel") {
+    return MaxFlowAlgorithm::kPushRelabel;
+  }
+  if (name == "parallel-push-relabel") {
+    return MaxFlowAlgorithm::kParallelPushRelabel;
+  }
+  return std::nullopt;
+}
+
+const char* MaxFlowAlgorithmName(MaxFlowAlgorithm algorithm) {
+  switch (algorithm) {
+    case MaxFlowAlgorithm::kEdmondsKarp:
+      return "edmonds-karp";
+    case MaxFlowAlgorithm::kDinic:
+      return "dinic";
+    case MaxFlowAlgorithm::kPushRelabel:
+      return "push-relabel";
+    case MaxFlowAlgorithm::kParallelPushRelabel:
+      return "parallel-push-relabel";
+  }
+  return "unknown";
+}
+
+FlowNetwork::FlowNetwork(int node_count) : node_count_(node_count) {}
+
+void FlowNetwork::ReserveEdges(int edge_count) { pending_edges_.reserve(edge_count); }
 
 int FlowNetwork::AddEdge(int from, int to, int capacity) {
-  Edge forward{to, static_cast<int>(adjacency_[to].size()), capacity, capacity};
-  Edge backward{from, static_cast<int>(adjacency_[from].size()), 0, 0};
-  adjacency_[from].push_back(forward);
-  adjacency_[to].push_back(backward);
-  return static_cast<int>(adjacency_[from].size()) - 1;
+  if (finalized_) {
+    throw std::logic_error("FlowNetwork::AddEdge called after Finalize");
+  }
+  pending_edges_.push_back(PendingEdge{from, to, capacity});
+  return static_cast<int>(pending_edges_.size()) - 1;
 }
 
-int FlowNetwork::MaxFlow(int source, int sink) {
+void FlowNetwork::Finalize() {
+  if (finalized_) {
+    return;
+  }
+  finalized_ = true;
+
+  const int edge_count = static_cast<int>(pending_edges_.size());
+  first_arc_.assign(node_count_ + 1, 0);
+  for (const PendingEdge& edge : pending_edges_) {
+    ++first_arc_[edge.from + 1];
+    ++first_arc_[edge.to + 1];
+  }
+  for (int node = 0; node < node_count_; ++node) {
+    first_arc_[node + 1] += first_arc_[node];
+  }
+
+  head_.resize(2 * static_cast<std::size_t>(edge_count));
+  reverse_.resize(head_.size());
+  residual_.resize(head_.size());
+  edge_arc_.resize(edge_count);
+
+  std::vector<int> cursor(first_arc_.begin(), first_arc_.end() - 1);
+  for (int edge_id = 0; edge_id < edge_count; ++edge_id) {
+    const PendingEdge& edge = pending_edges_[edge_id];
+    const int forward = cursor[edge.from]++;
+    const int backward = cursor[edge.to]++;
+    head_[forward] = edge.to;
+    head_[backward] = edge.from;
+    reverse_[forward] = backward;
+    reverse_[backward] = forward;
+    residual_[forward] = edge.capacity;
+    residual_[backward] = 0;
+    edge_arc_[edge_id] = forward;
+  }
+
+  std::vector<PendingEdge>().swap(pending_edges_);
+}
+
+int FlowNetwork::MaxFlow(int source,
+                         int sink,
+                         MaxFlowAlgorithm algorithm,
+                         int threads,
+                         MaxFlowStats* stats,
+                         const StopCondition* stop) {
+  Finalize();
+  if (source == sink) {
+    return 0;
+  }
+
+  MaxFlowStats unused;
+  switch (algorithm) {
+    case MaxFlowAlgorithm::kEdmondsKarp:
+      return stats ? EdmondsKarp<true>(source, sink, *stats, stop) : EdmondsKarp<false>(source, sink, unused, stop);
+    case MaxFlowAlgorithm::kDinic:
+      return stats ? Dinic<true>(source, sink, *stats, stop) : Dinic<false>(source, sink, unused, stop);
+    case MaxFlowAlgorithm::kPushRelabel:
+      return stats ? PushRelabel<true>(source, sink, *stats, stop) : PushRelabel<false>(source, sink, unused, stop);
+    case MaxFlowAlgorithm::kParallelPushRelabel:
+      return stats ? ParallelPushRelabel<true>(source, sink, threads, *stats, stop)
+                   : ParallelPushRelabel<false>(source, sink, threads, unused, stop);
+  }
+  return 0;
+}
+
+// Every node other than the source and sink holds inflow >= outflow in a
+// preflow, so walking backwards along arcs that carry flow from a node with
+// excess never gets stuck before the source. Walks that close a cycle cancel
+// the cycle instead; either way some arc or excess drops to zero per step.
+void FlowNetwork::ReturnExcess(int source, int sink, std::vector<int>& excess) {
+  std::vector<char> is_forward(head_.size(), 0);
+  for (const int arc : edge_arc_) {
+    is_forward[arc] = 1;
+  }
+  // Arc at node v whose residual is the flow of an edge entering v.
+  auto incoming_flow_arc = [&](int node, std::vector<int>& cursor) {
+    for (int& arc = cursor[node]; arc < first_arc_[node + 1]; ++arc) {
+      if (!is_forward[arc] && residual_[arc] > 0) {
+        return arc;
+      }
+    }
+    return -1;
+  };
+
+  std::vector<int> cursor(first_arc_.begin(), first_arc_.end() - 1);
+  std::vector<int> path_position(node_count_, -1);
+  std::vector<int> path_nodes;
+  std::vector<int> path_arcs;
+
+  for (int origin = 0; origin < node_count_; ++origin) {
+    while (origin != source && origin != sink && excess[origin] > 0) {
+      path_nodes.assign(1, origin);
+      path_arcs.clear();
+      path_position[origin] = 0;
+      while (path_nodes.back() != source) {
+        const int arc = incoming_flow_arc(path_nodes.back(), cursor);
+        const int previous = head_[arc];
+        if (path_position[previous] == -1) {
+          path_position[previous] = static_cast<int>(path_nodes.size());
+          path_nodes.push_back(previous);
+          path_arcs.push_back(arc);
+          continue;
+        }
+        // Flow cycle previous -> ... -> current -> previous: cancel it.
+        const std::size_t start = path_position[previous];
+        int amount = residual_[arc];
+        for (std::size_t i = start; i < path_arcs.size(); ++i) {
+          amount = std::min(amount, residual_[path_arcs[i]]);
+        }
+        Push(arc, amount);
+        for (std::size_t i = start; i < path_arcs.size(); ++i) {
+          Push(path_arcs[i], amount);
+        }
+        for (std::size_t i = start + 1; i < path_nodes.size(); ++i) {
+          path_position[path_nodes[i]] = -1;
+        }
+        path_nodes.resize(start + 1);
+        path_arcs.resize(start);
+      }
+
+      int amount = excess[origin];
+      for (const int arc : path_arcs) {
+        amount = std::min(amount, residual_[arc]);
+      }
+      for (const int arc : path_arcs) {
+        Push(arc, amount);
+      }
+      excess[origin] -= amount;
+      for (const int node : path_nodes) {
+        path_position[node] = -1;
+      }
+    }
+  }
+}
+
+template <bool kCount>
+int FlowNetwork::EdmondsKarp(int source, int sink, MaxFlowStats& stats, const StopCondition* stop) {
+  std::vector<int> parent_arc(node_count_);
+  std::vector<char> visited(node_count_);
+  std::vector<int> bfs_queue(node_count_);
   int total_flow = 0;
 
-  while (true) {
-    std::vector<int> parent_node(adjacency_.size(), -1);
-    std::vector<int> parent_edge(adjacency_.size(), -1);
-    std::queue<int> bfs_queue;
+  while (!(stop && stop->ShouldStop())) {
+    std::fill(visited.begin(), visited.end(), 0);
+    int queue_head = 0;
+    int queue_tail = 0;
 
-    parent_node[source] = source;
-    bfs_queue.push(source);
+    visited[source] = 1;
+    bfs_queue[queue_tail++] = source;
 
-    while (!bfs_queue.empty() && parent_node[sink] == -1) {
-      int current = bfs_queue.front();
-      bfs_queue.pop();
+    if constexpr (kCount) {
+      ++stats.phases;
+    }
+    while (queue_head < queue_tail && !visited[sink]) {
+      const int current = bfs_queue[queue_head++];
+      if constexpr (kCount) {
+        stats.arcs_scanned += first_arc_[current + 1] - first_arc_[current];
+      }
 
-      for (int edge_index = 0; edge_index < static_cast<int>(adjacency_[current].size()); ++edge_index) {
-        const Edge& edge = adjacency_[current][edge_index];
-        if (parent_node[edge.to] != -1 || edge.capacity <= 0) {
+      for (int arc = first_arc_[current]; arc < first_arc_[current + 1]; ++arc) {
+        const int next = head_[arc];
+        if (visited[next] || residual_[arc] <= 0) {
           continue;
         }
 
-        parent_node[edge.to] = current;
-        parent_edge[edge.to] = edge_index;
-        bfs_queue.push(edge.to);
+        visited[next] = 1;
+        parent_arc[next] = arc;
+        bfs_queue[queue_tail++] = next;
 
-        if (edge.to == sink) {
+        if (next == sink) {
           break;
         }
       }
     }
 
-    if (parent_node[sink] == -1) {
+    if (!visited[sink]) {
       break;
     }
 
     int path_flow = std::numeric_limits<int>::max();
-    for (int node = sink; node != source; node = parent_node[node]) {
-      const int prev = parent_node[node];
-      const int edge_index = parent_edge[node];
-      path_flow = std::min(path_flow, adjacency_[prev][edge_index].capacity);
+    for (int node = sink; node != source; node = head_[reverse_[parent_arc[node]]]) {
+      path_flow = std::min(path_flow, residual_[parent_arc[node]]);
     }
 
-    for (int node = sink; node != source; node = parent_node[node]) {
-      const int prev = parent_node[node];
-      const int edge_index = parent_edge[node];
-      Edge& forward = adjacency_[prev][edge_index];
-      Edge& backward = adjacency_[node][forward.rev];
-      forward.capacity -= path_flow;
-      backward.capacity += path_flow;
+    for (int node = sink; node != source; node = head_[reverse_[parent_arc[node]]]) {
+      Push(parent_arc[node], path_flow);
     }
 
     total_flow += path_flow;
+    if constexpr (kCount) {
+      ++stats.augmentations;
+    }
   }
 
   return total_flow;
 }
 
-const Edge& FlowNetwork::GetEdge(int from, int edge_index) const { return adjacency_[from][edge_index]; }
+template int FlowNetwork::EdmondsKarp<false>(int, int, MaxFlowStats&, const StopCondition*);
+template int FlowNetwork::EdmondsKarp<true>(int, int, MaxFlowStats&, const StopCondition*);
 
 }  // namespace scheduler
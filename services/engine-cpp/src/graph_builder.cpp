@@ -1,102 +1,391 @@
 #include <scheduler/graph_builder.hpp>
 
 #include <algorithm>
-#include <string>
-#include <unordered_map>
-#include <unordered_set>
+#include <cstdint>
+#include <limits>
+#include <numeric>
 #include <vector>
 
 namespace scheduler {
 
-GraphBuildResult BuildFlowGraph(const ProblemInput& input) {
-  std::unordered_map<std::string, int> doctor_index;
-  std::unordered_map<std::string, int> period_index;
-  std::unordered_map<std::string, int> day_index;
+namespace {
 
-  for (int i = 0; i < static_cast<int>(input.doctors.size()); ++i) {
+// A (period position, day position) pair a doctor can cover; sorts by period.
+using Slot = std::uint64_t;
+
+Slot MakeSlot(int period_pos, int day_pos) {
+  return (static_cast<Slot>(period_pos) << 32) | static_cast<std::uint32_t>(day_pos);
+}
+int SlotPeriod(Slot slot) { return static_cast<int>(slot >> 32); }
+int SlotDay(Slot slot) { return static_cast<int>(slot & 0xffffffffu); }
+
+struct ClassPeriod {
+  int doctor_class;
+  int period_pos;
+};
+
+// Valid availability of the whole problem, shared by every graph built from it.
+struct ProblemIndex {
+  // Demand days of each period, as sorted unique demand positions.
+  std::vector<std::vector<int>> period_days;
+  std::vector<std::vector<Slot>> doctor_slots;
+  // A doctor covers at most one day per period, so caps above the number of
+  // available periods are equivalent.
+  std::vector<int> doctor_cap;
+};
+
+ProblemIndex IndexProblem(const ProblemView& input) {
+  const int doctor_count = static_cast<int>(input.doctors.size());
+  const int period_count = static_cast<int>(input.periods.size());
+  const int demand_count = static_cast<int>(input.demands.size());
+
+  // Symbol -> position in doctors/periods/demands, -1 when nothing declares it.
+  std::vector<int> doctor_index(input.doctor_ids.size(), -1);
+  std::vector<int> period_index(input.period_ids.size(), -1);
+  std::vector<int> day_index(input.day_ids.size(), -1);
+
+  for (int i = 0; i < doctor_count; ++i) {
     doctor_index[input.doctors[i].id] = i;
   }
-  for (int i = 0; i < static_cast<int>(input.periods.size()); ++i) {
+  for (int i = 0; i < period_count; ++i) {
     period_index[input.periods[i].id] = i;
   }
-  for (int i = 0; i < static_cast<int>(input.demands.size()); ++i) {
+  for (int i = 0; i < demand_count; ++i) {
     day_index[input.demands[i].day_id] = i;
   }
 
-  std::vector<std::unordered_set<std::string>> period_days(input.periods.size());
-  for (int i = 0; i < static_cast<int>(input.periods.size()); ++i) {
-    for (const std::string& day : input.periods[i].day_ids) {
-      period_days[i].insert(day);
+  ProblemIndex index{std::vector<std::vector<int>>(period_count), std::vector<std::vector<Slot>>(doctor_count),
+                     std::vector<int>(doctor_count)};
+  for (int k = 0; k < period_count; ++k) {
+    std::vector<int>& days = index.period_days[k];
+    for (const std::uint32_t day : input.DaysOf(input.periods[k])) {
+      if (day_index[day] != -1) {
+        days.push_back(day_index[day]);
+      }
     }
+    std::sort(days.begin(), days.end());
+    days.erase(std::unique(days.begin(), days.end()), days.end());
   }
 
+  for (const Availability& available : input.availability) {
+    const int doctor_pos = doctor_index[available.doctor_id];
+    const int period_pos = period_index[available.period_id];
+    const int day_pos = day_index[available.day_id];
+    if (doctor_pos == -1 || period_pos == -1 || day_pos == -1 ||
+        !std::binary_search(index.period_days[period_pos].begin(), index.period_days[period_pos].end(), day_pos)) {
+      continue;
+    }
+    index.doctor_slots[doctor_pos].push_back(MakeSlot(period_pos, day_pos));
+  }
+
+  for (int i = 0; i < doctor_count; ++i) {
+    std::vector<Slot>& slots = index.doctor_slots[i];
+    std::sort(slots.begin(), slots.end());
+    slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+
+    int available_periods = 0;
+    for (std::size_t s = 0; s < slots.size(); ++s) {
+      if (s == 0 || SlotPeriod(slots[s]) != SlotPeriod(slots[s - 1])) {
+        ++available_periods;
+      }
+    }
+    index.doctor_cap[i] = std::min(std::max(0, input.doctors[i].max_total_days), available_periods);
+  }
+  return index;
+}
+
+bool IsActive(const ProblemIndex& index, int doctor) {
+  return index.doctor_cap[doctor] > 0;
+}
+
+// Builds the network over a subset of the problem: `doctors` and `demands`
+// are ascending positions in the view, and `day_node[demand]` is the day
+// node offset of each listed demand. Every availability slot of a listed
+// active doctor must point at a listed demand. `groups`, when set, inserts the
+// DoctorGroups layer in front of the doctor classes.
+GraphBuildResult BuildGraph(const ProblemView& input, const ProblemIndex& index, const std::vector<int>& doctors,
+                            const std::vector<int>& demands, const std::vector<int>& day_node,
+                            const GraphBuildOptions& options, const DoctorGroups* groups = nullptr) {
+  const int period_count = static_cast<int>(input.periods.size());
+  const int demand_count = static_cast<int>(demands.size());
+  const std::vector<std::vector<Slot>>& doctor_slots = index.doctor_slots;
+  const std::vector<int>& doctor_cap = index.doctor_cap;
+
+  std::vector<DoctorClass> classes;
+  if (options.include_unavailable_arcs) {
+    for (const int doctor : doctors) {
+      classes.push_back(DoctorClass{{doctor}});
+    }
+  } else {
+    std::vector<int> order;
+    for (const int doctor : doctors) {
+      if (IsActive(index, doctor)) {
+        order.push_back(doctor);
+      }
+    }
+    auto same_class = [&](int a, int b) { return doctor_cap[a] == doctor_cap[b] && doctor_slots[a] == doctor_slots[b]; };
+    if (options.merge_identical_doctors) {
+      std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        if (doctor_cap[a] != doctor_cap[b]) {
+          return doctor_cap[a] < doctor_cap[b];
+        }
+        return doctor_slots[a] < doctor_slots[b];
+      });
+    }
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      if (options.merge_identical_doctors && i > 0 && same_class(order[i - 1], order[i])) {
+        classes.back().doctors.push_back(order[i]);
+      } else {
+        classes.push_back(DoctorClass{{order[i]}});
+      }
+    }
+    std::sort(classes.begin(), classes.end(),
+              [](const DoctorClass& a, const DoctorClass& b) { return a.doctors.front() < b.doctors.front(); });
+  }
+
+  std::vector<ClassPeriod> class_periods;
+  for (int c = 0; c < static_cast<int>(classes.size()); ++c) {
+    if (options.include_unavailable_arcs) {
+      for (int k = 0; k < period_count; ++k) {
+        class_periods.push_back(ClassPeriod{c, k});
+      }
+      continue;
+    }
+    const std::vector<Slot>& slots = doctor_slots[classes[c].doctors.front()];
+    for (std::size_t s = 0; s < slots.size(); ++s) {
+      if (s == 0 || SlotPeriod(slots[s]) != SlotPeriod(slots[s - 1])) {
+        class_periods.push_back(ClassPeriod{c, SlotPeriod(slots[s])});
+      }
+    }
+  }
+
+  const int class_count = static_cast<int>(classes.size());
+  const int class_period_count = static_cast<int>(class_periods.size());
+  const int group_count = groups ? static_cast<int>(groups->group_cap.size()) : 0;
   const int source = 0;
-  const int doctor_offset = 1;
-  const int doctor_period_offset = doctor_offset + static_cast<int>(input.doctors.size());
-  const int doctor_period_count = static_cast<int>(input.doctors.size() * input.periods.size());
-  const int day_offset = doctor_period_offset + doctor_period_count;
-  const int sink = day_offset + static_cast<int>(input.demands.size());
+  const int group_offset = 1;
+  const int doctor_offset = group_offset + group_count;
+  const int doctor_period_offset = doctor_offset + class_count;
+  const int day_offset = doctor_period_offset + class_period_count;
+  const int sink = day_offset + demand_count;
   const int node_count = sink + 1;
 
-  auto doctor_node = [&](int doctor_id) { return doctor_offset + doctor_id; };
-  auto doctor_period_node = [&](int doctor_id, int period_id) {
-    return doctor_period_offset + doctor_id * static_cast<int>(input.periods.size()) + period_id;
-  };
-  auto day_node = [&](int demand_id) { return day_offset + demand_id; };
-
   GraphBuildResult build_result{
       FlowNetwork(node_count),
       source,
       sink,
       0,
+      FlowLayers{
+          source,
+          sink,
+          doctor_offset,
+          class_count,
+          doctor_period_offset,
+          class_period_count,
+          day_offset,
+          demand_count,
+      },
+      {},
       {},
       {},
   };
+  FlowNetwork& network = build_result.network;
 
-  for (int i = 0; i < static_cast<int>(input.doctors.size()); ++i) {
-    build_result.network.AddEdge(source, doctor_node(i), std::max(0, input.doctors[i].max_total_days));
+  int assignment_edge_count = 0;
+  if (options.include_unavailable_arcs) {
+    for (const ClassPeriod& class_period : class_periods) {
+      assignment_edge_count += static_cast<int>(index.period_days[class_period.period_pos].size());
+    }
+  } else {
+    for (const DoctorClass& doctor_class : classes) {
+      assignment_edge_count += static_cast<int>(doctor_slots[doctor_class.doctors.front()].size());
+    }
   }
+  network.ReserveEdges(group_count + class_count + class_period_count + assignment_edge_count + demand_count);
+  build_result.assignment_edges.reserve(assignment_edge_count);
 
-  for (int i = 0; i < static_cast<int>(input.doctors.size()); ++i) {
-    for (int k = 0; k < static_cast<int>(input.periods.size()); ++k) {
-      build_result.network.AddEdge(doctor_node(i), doctor_period_node(i, k), 1);
+  std::vector<long long> class_capacity(class_count);
+  for (int c = 0; c < class_count; ++c) {
+    const int members = static_cast<int>(classes[c].doctors.size());
+    const int first = classes[c].doctors.front();
+    const int per_doctor =
+        options.include_unavailable_arcs ? std::max(0, input.doctors[first].max_total_days) : doctor_cap[first];
+    class_capacity[c] =
+        std::min<long long>(static_cast<long long>(members) * per_doctor, std::numeric_limits<int>::max());
+  }
+  if (groups) {
+    // A group never needs more than its members can take anyway.
+    std::vector<long long> group_capacity(group_count, 0);
+    for (int c = 0; c < class_count; ++c) {
+      group_capacity[groups->group_of_doctor[classes[c].doctors.front()]] += class_capacity[c];
+    }
+    for (int g = 0; g < group_count; ++g) {
+      network.AddEdge(source, group_offset + g,
+                      static_cast<int>(std::min<long long>(group_capacity[g], std::max(0, groups->group_cap[g]))));
     }
   }
+  for (int c = 0; c < class_count; ++c) {
+    const int from = groups ? group_offset + groups->group_of_doctor[classes[c].doctors.front()] : source;
+    network.AddEdge(from, doctor_offset + c, static_cast<int>(class_capacity[c]));
+  }
 
-  for (const Availability& available : input.availability) {
-    const auto doctor_it = doctor_index.find(available.doctor_id);
-    const auto period_it = period_index.find(available.period_id);
-    const auto day_it = day_index.find(available.day_id);
-    if (doctor_it == doctor_index.end() || period_it == period_index.end() || day_it == day_index.end()) {
-      continue;
-    }
+  for (int cp = 0; cp < class_period_count; ++cp) {
+    const ClassPeriod& class_period = class_periods[cp];
+    const DoctorClass& doctor_class = classes[class_period.doctor_class];
+    const int members = static_cast<int>(doctor_class.doctors.size());
+    const int from = doctor_period_offset + cp;
+    network.AddEdge(doctor_offset + class_period.doctor_class, from, members);
 
-    const int period_pos = period_it->second;
-    if (period_days[period_pos].find(available.day_id) == period_days[period_pos].end()) {
+    const std::vector<Slot>& slots = doctor_slots[doctor_class.doctors.front()];
+    const std::uint32_t period_id = input.periods[class_period.period_pos].id;
+    if (options.include_unavailable_arcs) {
+      for (const int day_pos : index.period_days[class_period.period_pos]) {
+        const bool available = std::binary_search(slots.begin(), slots.end(), MakeSlot(class_period.period_pos, day_pos));
+        const int edge_id = network.AddEdge(from, day_offset + day_node[day_pos], available ? 1 : 0);
+        build_result.assignment_edges.push_back(
+            AssignmentEdgeRef{edge_id, class_period.doctor_class, period_id, input.demands[day_pos].day_id});
+      }
       continue;
     }
 
-    const int from = doctor_period_node(doctor_it->second, period_pos);
-    const int to = day_node(day_it->second);
-    const int edge_index = build_result.network.AddEdge(from, to, 1);
-
-    build_result.assignment_edges.push_back(AssignmentEdgeRef{
-        from,
-        edge_index,
-        Assignment{available.doctor_id, available.day_id, available.period_id},
-    });
+    const auto first_slot = std::lower_bound(slots.begin(), slots.end(), MakeSlot(class_period.period_pos, 0));
+    for (auto slot = first_slot; slot != slots.end() && SlotPeriod(*slot) == class_period.period_pos; ++slot) {
+      const int day_pos = SlotDay(*slot);
+      const int edge_id = network.AddEdge(from, day_offset + day_node[day_pos], members);
+      build_result.assignment_edges.push_back(
+          AssignmentEdgeRef{edge_id, class_period.doctor_class, period_id, input.demands[day_pos].day_id});
+    }
   }
 
-  for (int i = 0; i < static_cast<int>(input.demands.size()); ++i) {
-    const int required = std::max(0, input.demands[i].required_doctors);
-    const int from = day_node(i);
-    const int edge_index = build_result.network.AddEdge(from, sink, required);
+  for (const int demand : demands) {
+    const int required = std::max(0, input.demands[demand].required_doctors);
+    const int edge_id = network.AddEdge(day_offset + day_node[demand], sink, required);
     build_result.total_demand += required;
 
-    build_result.day_edges.push_back(DayDemandRef{from, edge_index, input.demands[i].day_id, required});
+    build_result.day_edges.push_back(DayDemandRef{edge_id, demand, input.demands[demand].day_id, required});
+  }
+
+  // Refs hold edge ids until the CSR layout exists; switch them to global arc ids.
+  network.Finalize();
+  for (AssignmentEdgeRef& edge_ref : build_result.assignment_edges) {
+    edge_ref.arc = network.ForwardArc(edge_ref.arc);
   }
+  for (DayDemandRef& day_ref : build_result.day_edges) {
+    day_ref.arc = network.ForwardArc(day_ref.arc);
+  }
+  build_result.doctor_classes = std::move(classes);
 
   return build_result;
 }
 
+class DisjointSets {
+ public:
+  explicit DisjointSets(int size) : parent_(size) { std::iota(parent_.begin(), parent_.end(), 0); }
+
+  int Find(int item) {
+    while (parent_[item] != item) {
+      parent_[item] = parent_[parent_[item]];
+      item = parent_[item];
+    }
+    return item;
+  }
+
+  void Union(int a, int b) {
+    a = Find(a);
+    b = Find(b);
+    if (a != b) {
+      parent_[std::max(a, b)] = std::min(a, b);
+    }
+  }
+
+ private:
+  std::vector<int> parent_;
+};
+
+std::vector<int> Positions(int count) {
+  std::vector<int> positions(count);
+  std::iota(positions.begin(), positions.end(), 0);
+  return positions;
+}
+
+}  // namespace
+
+GraphBuildResult BuildFlowGraph(const ProblemView& input, const GraphBuildOptions& options) {
+  const ProblemIndex index = IndexProblem(input);
+  const std::vector<int> demands = Positions(static_cast<int>(input.demands.size()));
+  return BuildGraph(input, index, Positions(static_cast<int>(input.doctors.size())), demands, demands, options);
+}
+
+GraphBuildResult BuildFlowGraph(const ProblemInput& input, const GraphBuildOptions& options) {
+  return BuildFlowGraph(input.View(), options);
+}
+
+GraphBuildResult BuildFlowGraph(const ProblemView& input, const DoctorGroups& groups) {
+  const ProblemIndex index = IndexProblem(input);
+  const std::vector<int> demands = Positions(static_cast<int>(input.demands.size()));
+  GraphBuildOptions options;
+  options.merge_identical_doctors = false;
+  return BuildGraph(input, index, Positions(static_cast<int>(input.doctors.size())), demands, demands, options,
+                    &groups);
+}
+
+std::vector<GraphBuildResult> BuildComponentGraphs(const ProblemView& input, const GraphBuildOptions& options) {
+  std::vector<GraphBuildResult> graphs;
+  if (options.include_unavailable_arcs) {
+    graphs.push_back(BuildFlowGraph(input, options));
+    return graphs;
+  }
+
+  const ProblemIndex index = IndexProblem(input);
+  const int doctor_count = static_cast<int>(input.doctors.size());
+  const int demand_count = static_cast<int>(input.demands.size());
+
+  // Doctors are items [0, doctor_count), demands follow; smallest item is the root.
+  DisjointSets sets(doctor_count + demand_count);
+  for (int i = 0; i < doctor_count; ++i) {
+    if (IsActive(index, i)) {
+      for (const Slot slot : index.doctor_slots[i]) {
+        sets.Union(i, doctor_count + SlotDay(slot));
+      }
+    }
+  }
+
+  // Components are numbered by their first doctor; demands nobody can cover
+  // share one trailing doctor-less component.
+  std::vector<int> component_of_root(doctor_count + demand_count, -1);
+  std::vector<std::vector<int>> component_doctors;
+  std::vector<std::vector<int>> component_demands;
+  for (int i = 0; i < doctor_count; ++i) {
+    if (!IsActive(index, i)) {
+      continue;
+    }
+    int& component = component_of_root[sets.Find(i)];
+    if (component == -1) {
+      component = static_cast<int>(component_doctors.size());
+      component_doctors.emplace_back();
+      component_demands.emplace_back();
+    }
+    component_doctors[component].push_back(i);
+  }
+
+  std::vector<int> uncoverable;
+  std::vector<int> day_node(demand_count);
+  for (int d = 0; d < demand_count; ++d) {
+    const int component = component_of_root[sets.Find(doctor_count + d)];
+    std::vector<int>& demands = component == -1 ? uncoverable : component_demands[component];
+    day_node[d] = static_cast<int>(demands.size());
+    demands.push_back(d);
+  }
+  if (!uncoverable.empty()) {
+    component_doctors.emplace_back();
+    component_demands.push_back(std::move(uncoverable));
+  }
+
+  graphs.reserve(component_doctors.size());
+  for (std::size_t c = 0; c < component_doctors.size(); ++c) {
+    graphs.push_back(BuildGraph(input, index, component_doctors[c], component_demands[c], day_node, options));
+  }
+  return graphs;
+}
+
 }  // namespace scheduler
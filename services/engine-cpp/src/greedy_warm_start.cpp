@@ -0,0 +1,114 @@
+#include <scheduler/greedy_warm_start.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace scheduler {
+
+namespace {
+
+// Arc at `node` whose head is `target`, or -1.
+int ArcTo(const FlowNetwork& network, int node, int target) {
+  for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+    if (network.Head(arc) == target) {
+      return arc;
+    }
+  }
+  return -1;
+}
+
+}  // namespace
+
+int GreedyWarmStart(FlowNetwork& network, const FlowLayers& layers) {
+  network.Finalize();
+
+  // Forward source -> class arc per class and class -> doctor-period arc per
+  // doctor-period; each doctor-period has exactly one class.
+  std::vector<int> source_arc(layers.doctor_count, -1);
+  for (int doctor = 0; doctor < layers.doctor_count; ++doctor) {
+    const int arc = ArcTo(network, layers.doctor_offset + doctor, layers.source);
+    if (arc != -1) {
+      source_arc[doctor] = network.ReverseArc(arc);
+    }
+  }
+  std::vector<int> class_arc(layers.doctor_period_count, -1);
+  std::vector<int> class_of(layers.doctor_period_count, -1);
+  for (int slot = 0; slot < layers.doctor_period_count; ++slot) {
+    const int node = layers.doctor_period_offset + slot;
+    for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+      const int doctor = network.Head(arc) - layers.doctor_offset;
+      if (doctor >= 0 && doctor < layers.doctor_count) {
+        class_arc[slot] = network.ReverseArc(arc);
+        class_of[slot] = doctor;
+        break;
+      }
+    }
+  }
+
+  std::vector<int> sink_arc(layers.day_count, -1);
+  std::vector<int> candidates(layers.day_count, 0);
+  for (int day = 0; day < layers.day_count; ++day) {
+    const int node = layers.day_offset + day;
+    sink_arc[day] = ArcTo(network, node, layers.sink);
+    candidates[day] = network.EndArc(node) - network.FirstArc(node);
+  }
+  std::vector<int> day_order(layers.day_count);
+  std::iota(day_order.begin(), day_order.end(), 0);
+  std::stable_sort(day_order.begin(), day_order.end(),
+                   [&candidates](int a, int b) { return candidates[a] < candidates[b]; });
+
+  struct Candidate {
+    int day_arc;
+    int slot;
+    long long remaining;
+    long long size;
+  };
+  std::vector<Candidate> open;
+
+  int seeded = 0;
+  for (const int day : day_order) {
+    if (sink_arc[day] == -1 || network.Residual(sink_arc[day]) <= 0) {
+      continue;
+    }
+    // A class reaches a day through one doctor-period only, so each candidate
+    // is taken at most once per day and one sort by remaining capacity per
+    // doctor, residual(source -> class) / capacity(class -> doctor-period),
+    // decides the order.
+    open.clear();
+    const int node = layers.day_offset + day;
+    for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+      const int slot = network.Head(arc) - layers.doctor_period_offset;
+      if (slot < 0 || slot >= layers.doctor_period_count || class_arc[slot] == -1 ||
+          source_arc[class_of[slot]] == -1) {
+        continue;
+      }
+      const int day_arc = network.ReverseArc(arc);
+      const long long remaining = network.Residual(source_arc[class_of[slot]]);
+      if (remaining > 0 && network.Residual(day_arc) > 0 && network.Residual(class_arc[slot]) > 0) {
+        open.push_back(Candidate{day_arc, slot, remaining, network.Capacity(class_arc[slot])});
+      }
+    }
+    std::stable_sort(open.begin(), open.end(), [](const Candidate& a, const Candidate& b) {
+      return a.remaining * b.size > b.remaining * a.size;
+    });
+
+    for (const Candidate& candidate : open) {
+      const int need = network.Residual(sink_arc[day]);
+      if (need == 0) {
+        break;
+      }
+      const int from_source = source_arc[class_of[candidate.slot]];
+      const int amount = std::min({need, network.Residual(candidate.day_arc), network.Residual(class_arc[candidate.slot]),
+                                   network.Residual(from_source)});
+      network.Push(from_source, amount);
+      network.Push(class_arc[candidate.slot], amount);
+      network.Push(candidate.day_arc, amount);
+      network.Push(sink_arc[day], amount);
+      seeded += amount;
+    }
+  }
+  return seeded;
+}
+
+}  // namespace scheduler
@@ -0,0 +1,697 @@
+#include <scheduler/incremental_solver.hpp>
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "solver_internal.hpp"
+
+namespace scheduler {
+
+int IncrementalSolver::Network::AddNode() {
+  arcs_.emplace_back();
+  return node_count() - 1;
+}
+
+int IncrementalSolver::Network::AddEdge(int from, int to, int capacity, int flow) {
+  const int arc = static_cast<int>(head_.size());
+  head_.push_back(to);
+  residual_.push_back(capacity - flow);
+  head_.push_back(from);
+  residual_.push_back(flow);
+  arcs_[from].push_back(arc);
+  arcs_[to].push_back(arc + 1);
+  return arc;
+}
+
+IncrementalSolver::IncrementalSolver(ProblemInput input, const SolveOptions& options) : input_(std::move(input)) {
+  GraphBuildOptions build_options;
+  build_options.merge_identical_doctors = false;
+  GraphBuildResult graph = BuildFlowGraph(input_, build_options);
+  flow_value_ = SolveMaxFlow(graph, options);
+  CopySolvedGraph(graph);
+}
+
+// Lays out source, sink, one node per doctor and one per demand, then the
+// doctor-period nodes and arcs of the solved graph with their flow. Source
+// arcs take the doctor's own cap rather than the presolved one, which is
+// never lower than the flow.
+void IncrementalSolver::CopySolvedGraph(const GraphBuildResult& graph) {
+  const FlowNetwork& solved = graph.network;
+  const FlowLayers& layers = graph.layers;
+  const int doctor_count = static_cast<int>(input_.doctors.size());
+  const int demand_count = static_cast<int>(input_.demands.size());
+
+  AddNode();
+  AddNode();
+  std::vector<int> doctor_nodes(doctor_count);
+  for (int& node : doctor_nodes) {
+    node = AddNode();
+  }
+  std::vector<int> demand_nodes(demand_count);
+  for (int& node : demand_nodes) {
+    node = AddNode();
+  }
+
+  std::vector<int> class_flow(doctor_count, 0);
+  std::vector<char> presolved(doctor_count, 0);
+  for (int arc = solved.FirstArc(graph.source); arc < solved.EndArc(graph.source); ++arc) {
+    const int doctor = graph.doctor_classes[solved.Head(arc) - layers.doctor_offset].doctors.front();
+    class_flow[doctor] = solved.Flow(arc);
+    presolved[doctor] = 1;
+  }
+  doctor_arcs_.assign(input_.doctor_ids.size(), -1);
+  doctor_positions_.assign(input_.doctor_ids.size(), -1);
+  for (int i = 0; i < doctor_count; ++i) {
+    const Doctor& doctor = input_.doctors[i];
+    doctor_arcs_[doctor.id] = AddEdge(kSource, doctor_nodes[i], std::max(0, doctor.max_total_days), class_flow[i]);
+    doctor_positions_[doctor.id] = i;
+  }
+
+  day_demands_.assign(input_.day_ids.size(), -1);
+  day_arcs_.assign(demand_count, -1);
+  required_.assign(demand_count, 0);
+  for (const DayDemandRef& day_ref : graph.day_edges) {
+    day_demands_[day_ref.day_id] = day_ref.demand;
+    day_arcs_[day_ref.demand] =
+        AddEdge(demand_nodes[day_ref.demand], kSink, day_ref.required, solved.Flow(day_ref.arc));
+    edge_demand_[day_arcs_[day_ref.demand] / 2] = day_ref.demand;
+    required_[day_ref.demand] = day_ref.required;
+    total_demand_ += day_ref.required;
+    UpdateCoverage(day_ref.demand);
+  }
+
+  const ProblemView view = input_.View();
+  period_days_.assign(input_.period_ids.size(), {});
+  for (const Period& period : input_.periods) {
+    std::vector<std::uint32_t>& days = period_days_[period.id];
+    days.clear();
+    for (const std::uint32_t day : view.DaysOf(period)) {
+      if (day_demands_[day] != -1) {
+        days.push_back(day);
+      }
+    }
+    std::sort(days.begin(), days.end());
+  }
+
+  // The single incoming arc of a class-period node is the reverse of its
+  // class -> class-period arc, so its residual is the flow on that arc.
+  std::vector<int> copied_nodes(solved.node_count(), -1);
+  for (const AssignmentEdgeRef& edge_ref : graph.assignment_edges) {
+    const int doctor = graph.doctor_classes[edge_ref.doctor_class].doctors.front();
+    const int class_period = solved.Head(solved.ReverseArc(edge_ref.arc));
+    if (copied_nodes[class_period] == -1) {
+      int incoming = solved.FirstArc(class_period);
+      while (solved.Head(incoming) >= layers.doctor_period_offset) {
+        ++incoming;
+      }
+      copied_nodes[class_period] = AddNode();
+      AddEdge(doctor_nodes[doctor], copied_nodes[class_period], 1, solved.Residual(incoming));
+      doctor_period_nodes_[AssignmentKey(input_.doctors[doctor].id, edge_ref.period_id, 0)] =
+          copied_nodes[class_period];
+    }
+    const int day_node = demand_nodes[solved.Head(edge_ref.arc) - layers.day_offset];
+    const int arc = AddEdge(copied_nodes[class_period], day_node, 1, solved.Flow(edge_ref.arc));
+    edge_assignment_[arc / 2] = static_cast<int>(assignment_refs_.size());
+    assignment_refs_.push_back(AssignmentRef{doctor, edge_ref.period_id, edge_ref.day_id});
+    assignment_arcs_[AssignmentKey(input_.doctors[doctor].id, edge_ref.period_id, edge_ref.day_id)] = arc;
+    if (solved.Flow(edge_ref.arc) > 0) {
+      assigned_.emplace(doctor, edge_ref.period_id, edge_ref.day_id);
+    }
+  }
+
+  // The presolve drops doctors without a cap; their availability still goes
+  // in, unused, so a later SetMaxTotalDays can route through it.
+  for (const Availability& available : input_.availability) {
+    const int doctor = doctor_positions_[available.doctor_id];
+    if (doctor == -1 || presolved[doctor]) {
+      continue;
+    }
+    const int arc = AssignmentArc(available.doctor_id, available.period_id, available.day_id, true);
+    if (arc != -1) {
+      network_.SetCapacity(arc, 1);
+    }
+  }
+}
+
+IncrementalSolver IncrementalSolver::FromJson(const std::string& input_json, const SolveOptions& options) {
+  return IncrementalSolver(ParseProblemInput(input_json), options);
+}
+
+SolveResult IncrementalSolver::AddAvailability(
+    const std::string& doctor_id, const std::string& period_id, const std::string& day_id) {
+  const int arc = AssignmentArc(doctor_id, period_id, day_id, true);
+  if (arc != -1) {
+    ChangeCapacity(arc, 1);
+  }
+  return Result();
+}
+
+SolveResult IncrementalSolver::RemoveAvailability(
+    const std::string& doctor_id, const std::string& period_id, const std::string& day_id) {
+  const int arc = AssignmentArc(doctor_id, period_id, day_id, false);
+  if (arc != -1) {
+    ChangeCapacity(arc, 0);
+  }
+  return Result();
+}
+
+SolveResult IncrementalSolver::SetMaxTotalDays(const std::string& doctor_id, int max_total_days) {
+  const std::optional<std::uint32_t> symbol = input_.doctor_ids.Find(doctor_id);
+  if (symbol && doctor_arcs_[*symbol] != -1) {
+    ChangeCapacity(doctor_arcs_[*symbol], std::max(0, max_total_days));
+  }
+  return Result();
+}
+
+SolveResult IncrementalSolver::SetRequiredDoctors(const std::string& day_id, int required_doctors) {
+  const std::optional<std::uint32_t> symbol = input_.day_ids.Find(day_id);
+  if (symbol && day_demands_[*symbol] != -1) {
+    const int demand = day_demands_[*symbol];
+    const int required = std::max(0, required_doctors);
+    total_demand_ += required - required_[demand];
+    required_[demand] = required;
+    ChangeCapacity(day_arcs_[demand], required);
+    UpdateCoverage(demand);
+  }
+  return Result();
+}
+
+SolveResult IncrementalSolver::Result() const {
+  SolveResult result;
+  result.contract_version = input_.contract_version;
+  if (HasNothingToSolve(input_.View())) {
+    return result;
+  }
+
+  result.is_feasible = is_feasible();
+  result.assignments.reserve(assigned_.size());
+  for (const auto& [doctor, period_id, day_id] : assigned_) {
+    result.assignments.push_back(Assignment{
+        std::string(input_.doctor_ids.Name(input_.doctors[doctor].id)),
+        std::string(input_.day_ids.Name(day_id)),
+        std::string(input_.period_ids.Name(period_id)),
+    });
+  }
+  result.uncovered_days.reserve(uncovered_demands_.size());
+  for (const int demand : uncovered_demands_) {
+    result.uncovered_days.emplace_back(input_.day_ids.Name(input_.demands[demand].day_id));
+  }
+  result.assigned_count = static_cast<int>(result.assignments.size());
+  return result;
+}
+
+CriticalityReport IncrementalSolver::AnalyzeDoctorCriticality(bool coverage_loss) {
+  const Network& network = network_;
+  CriticalityReport report;
+  report.is_feasible = is_feasible();
+  report.assigned_count = flow_value_;
+
+  // A doctor's loss is f - maxflow(without it) whatever maximum flow it is
+  // read from, so the cheap cases are all settled on the current flow before
+  // any removal reshapes it: a doctor nobody else can resupply loses all its
+  // flow, and one carrying a single unit that someone can resupply loses none.
+  const std::vector<char> resupplied = ResuppliedDoctors();
+  std::vector<int> lost(input_.doctors.size(), 0);
+  std::vector<int> pending;
+  for (int i = 0; i < static_cast<int>(input_.doctors.size()); ++i) {
+    const int arc = doctor_arcs_[input_.doctors[i].id];
+    const int flow = arc == -1 ? 0 : network.Flow(arc);
+    if (flow > 0 && !resupplied[network.Head(arc)]) {
+      lost[i] = flow;
+    } else if (flow > 1) {
+      pending.push_back(i);
+    }
+  }
+  for (const int i : pending) {
+    lost[i] = RemovalLoss(doctor_arcs_[input_.doctors[i].id], coverage_loss);
+  }
+
+  for (int i = 0; i < static_cast<int>(input_.doctors.size()); ++i) {
+    const std::string_view doctor_id = input_.doctor_ids.Name(input_.doctors[i].id);
+    if (lost[i] > 0) {
+      report.critical_doctors.emplace_back(doctor_id);
+    }
+    if (coverage_loss) {
+      report.coverage_loss.push_back(DoctorCoverageLoss{std::string(doctor_id), lost[i]});
+    }
+  }
+  return report;
+}
+
+bool IncrementalSolver::is_feasible() const {
+  return !HasNothingToSolve(input_.View()) && flow_value_ == total_demand_;
+}
+
+// The previous flow was maximum, so after raising one capacity every new
+// augmenting path must cross that arc, and once one search fails none will
+// succeed. Lowering a capacity below its flow cancels one unit at a time and
+// tries to reroute it; the repaired flow is again maximum after each step.
+void IncrementalSolver::ChangeCapacity(int arc, int capacity) {
+  Network& network = network_;
+
+  if (capacity >= network.Flow(arc)) {
+    network.SetCapacity(arc, capacity);
+    while (network.Residual(arc) > 0 && AugmentThrough(arc)) {
+      ++flow_value_;
+    }
+    return;
+  }
+
+  std::vector<int> prefix_arcs;
+  std::vector<int> suffix_arcs;
+  while (network.Flow(arc) > capacity) {
+    CancelUnitThrough(arc, prefix_arcs, suffix_arcs);
+    --flow_value_;
+    network.SetCapacity(arc, network.Flow(arc));
+    if (Reroute(prefix_arcs, suffix_arcs)) {
+      ++flow_value_;
+    }
+  }
+  network.SetCapacity(arc, capacity);
+}
+
+// Same cancel-and-reroute loop as lowering a capacity to 0, but the arc is
+// put back afterwards: the lost units can only come back through it, so
+// exactly `lost` augmentations through the arc restore the previous maximum.
+int IncrementalSolver::RemovalLoss(int arc, bool full_loss) {
+  Network& network = network_;
+  const int capacity = network.Capacity(arc);
+  const int before = flow_value_;
+
+  std::vector<int> prefix_arcs;
+  std::vector<int> suffix_arcs;
+  while (network.Flow(arc) > 0) {
+    if (ShiftUnitToSpareDoctor(arc)) {
+      network.SetCapacity(arc, network.Flow(arc));
+      continue;
+    }
+    CancelUnitThrough(arc, prefix_arcs, suffix_arcs);
+    --flow_value_;
+    network.SetCapacity(arc, network.Flow(arc));
+    if (Reroute(prefix_arcs, suffix_arcs)) {
+      ++flow_value_;
+    } else if (!full_loss) {
+      break;
+    }
+  }
+  const int lost = before - flow_value_;
+
+  network.SetCapacity(arc, capacity);
+  while (flow_value_ < before && AugmentThrough(arc)) {
+    ++flow_value_;
+  }
+  return lost;
+}
+
+// Shortcut for the usual reroute of a doctor's unit (source arc `doctor_arc`):
+// hand one of its days to another doctor who is available that day, still
+// free in that period and below its cap. Scans the day's candidates only;
+// false when no such direct swap exists.
+bool IncrementalSolver::ShiftUnitToSpareDoctor(int doctor_arc) {
+  const Network& network = network_;
+  const int doctor = network.Head(doctor_arc);
+
+  for (const int period_arc : network.Arcs(doctor)) {
+    if (!network.IsForward(period_arc) || network.Flow(period_arc) == 0) {
+      continue;
+    }
+    const std::vector<int>& day_arcs = network.Arcs(network.Head(period_arc));
+    auto day_arc = day_arcs.begin();
+    while (!network.IsForward(*day_arc) || network.Flow(*day_arc) == 0) {
+      ++day_arc;
+    }
+
+    const int day = network.Head(*day_arc);
+    for (const int in : network.Arcs(day)) {
+      const int other_period = network.Head(in);
+      if (network.IsForward(in) || network.Residual(network.ReverseArc(in)) == 0) {
+        continue;
+      }
+      const int back = network.Arcs(other_period).front();
+      const int other = network.Head(back);
+      if (other == doctor || network.Residual(network.ReverseArc(back)) == 0) {
+        continue;
+      }
+      const int supply = network.ReverseArc(network.Arcs(other).front());
+      if (network.Residual(supply) == 0) {
+        continue;
+      }
+
+      Push(supply, 1);
+      Push(network.ReverseArc(back), 1);
+      Push(network.ReverseArc(in), 1);
+      Push(network.ReverseArc(*day_arc), 1);
+      Push(network.ReverseArc(period_arc), 1);
+      Push(network.ReverseArc(doctor_arc), 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Multi-source BFS over residual arcs from every doctor with spare capacity,
+// never entering the source. Each node keeps up to two distinct origins, so
+// a doctor is marked exactly when some other doctor's spare capacity reaches
+// it, i.e. when at least one unit of its flow can be rerouted.
+std::vector<char> IncrementalSolver::ResuppliedDoctors() const {
+  const Network& network = network_;
+  std::vector<std::array<int, 2>> origins(network.node_count(), {-1, -1});
+  std::vector<std::pair<int, int>> queue;
+  for (const int arc : network.Arcs(kSource)) {
+    if (network.Residual(arc) > 0) {
+      origins[network.Head(arc)][0] = network.Head(arc);
+      queue.emplace_back(network.Head(arc), network.Head(arc));
+    }
+  }
+
+  for (std::size_t next = 0; next < queue.size(); ++next) {
+    const auto [node, origin] = queue[next];
+    for (const int arc : network.Arcs(node)) {
+      const int head = network.Head(arc);
+      std::array<int, 2>& slots = origins[head];
+      if (network.Residual(arc) <= 0 || head == kSource || slots[0] == origin || slots[1] == origin ||
+          slots[1] != -1) {
+        continue;
+      }
+      (slots[0] == -1 ? slots[0] : slots[1]) = origin;
+      queue.emplace_back(head, origin);
+    }
+  }
+
+  std::vector<char> resupplied(network.node_count(), 0);
+  for (int node = 0; node < network.node_count(); ++node) {
+    for (const int origin : origins[node]) {
+      resupplied[node] |= origin != -1 && origin != node;
+    }
+  }
+  return resupplied;
+}
+
+bool IncrementalSolver::AugmentThrough(int arc) {
+  std::vector<int> to_tail;
+  std::vector<int> from_head;
+  if (!SearchBackward({Tail(arc)}, to_tail) || !SearchForward({network_.Head(arc)}, from_head)) {
+    return false;
+  }
+
+  to_tail.push_back(arc);
+  to_tail.insert(to_tail.end(), from_head.begin(), from_head.end());
+  PushUnitAlong(to_tail);
+  return true;
+}
+
+// Flow only runs along forward arcs, source to sink, so a unit through `arc`
+// can be traced greedily back to the source over reverse arcs with residual
+// and on to the sink over forward arcs that carry flow.
+void IncrementalSolver::CancelUnitThrough(int arc, std::vector<int>& prefix_arcs, std::vector<int>& suffix_arcs) {
+  const Network& network = network_;
+  prefix_arcs.clear();
+  suffix_arcs.clear();
+
+  for (int node = Tail(arc); node != kSource;) {
+    auto incoming = network.Arcs(node).begin();
+    while (network.IsForward(*incoming) || network.Residual(*incoming) == 0) {
+      ++incoming;
+    }
+    prefix_arcs.push_back(network.ReverseArc(*incoming));
+    node = network.Head(*incoming);
+  }
+  std::reverse(prefix_arcs.begin(), prefix_arcs.end());
+
+  for (int node = network.Head(arc); node != kSink;) {
+    auto outgoing = network.Arcs(node).begin();
+    while (!network.IsForward(*outgoing) || network.Flow(*outgoing) == 0) {
+      ++outgoing;
+    }
+    suffix_arcs.push_back(*outgoing);
+    node = network.Head(*outgoing);
+  }
+
+  Push(network.ReverseArc(arc), 1);
+  for (const int path_arc : prefix_arcs) {
+    Push(network.ReverseArc(path_arc), 1);
+  }
+  for (const int path_arc : suffix_arcs) {
+    Push(network.ReverseArc(path_arc), 1);
+  }
+}
+
+// Any augmenting path left after a cancellation visits a node of the
+// cancelled path: either it leaves one of the prefix nodes (which the source
+// still reaches through the freed prefix) or it enters one of the suffix
+// nodes (which still reach the sink through the freed suffix).
+bool IncrementalSolver::Reroute(const std::vector<int>& prefix_arcs, const std::vector<int>& suffix_arcs) {
+  const Network& network = network_;
+  std::vector<int> roots;
+  std::vector<int> path;
+
+  for (const int arc : prefix_arcs) {
+    roots.push_back(network.Head(arc));
+  }
+  if (SearchForward(roots, path)) {
+    const int root = Tail(path.front());
+    std::vector<int> augmenting;
+    for (const int arc : prefix_arcs) {
+      augmenting.push_back(arc);
+      if (network.Head(arc) == root) {
+        break;
+      }
+    }
+    augmenting.insert(augmenting.end(), path.begin(), path.end());
+    PushUnitAlong(augmenting);
+    return true;
+  }
+
+  roots.clear();
+  for (const int arc : suffix_arcs) {
+    roots.push_back(Tail(arc));
+  }
+  if (SearchBackward(roots, path)) {
+    const int root = network.Head(path.back());
+    auto first = suffix_arcs.begin();
+    while (Tail(*first) != root) {
+      ++first;
+    }
+    path.insert(path.end(), first, suffix_arcs.end());
+    PushUnitAlong(path);
+    return true;
+  }
+
+  return false;
+}
+
+// BFS over residual arcs from `roots` to the sink, never entering the source.
+// On success `path` holds the arcs from one root to the sink, in order.
+bool IncrementalSolver::SearchForward(const std::vector<int>& roots, std::vector<int>& path) {
+  const Network& network = network_;
+  path.clear();
+  ++epoch_;
+
+  int queue_head = 0;
+  int queue_tail = 0;
+  visit_epoch_[kSource] = epoch_;
+  for (const int root : roots) {
+    if (root == kSink) {
+      return true;
+    }
+    if (visit_epoch_[root] != epoch_) {
+      visit_epoch_[root] = epoch_;
+      parent_arc_[root] = -1;
+      search_queue_[queue_tail++] = root;
+    }
+  }
+
+  while (queue_head < queue_tail) {
+    const int current = search_queue_[queue_head++];
+    for (const int arc : network.Arcs(current)) {
+      const int next = network.Head(arc);
+      if (network.Residual(arc) <= 0 || visit_epoch_[next] == epoch_) {
+        continue;
+      }
+      visit_epoch_[next] = epoch_;
+      parent_arc_[next] = arc;
+      if (next == kSink) {
+        for (int node = next; parent_arc_[node] != -1; node = Tail(parent_arc_[node])) {
+          path.push_back(parent_arc_[node]);
+        }
+        std::reverse(path.begin(), path.end());
+        return true;
+      }
+      search_queue_[queue_tail++] = next;
+    }
+  }
+  return false;
+}
+
+// Mirror of SearchForward: walks residual arcs backwards from `roots` to the
+// source, never entering the sink. On success `path` holds the arcs from the
+// source to one root, in order.
+bool IncrementalSolver::SearchBackward(const std::vector<int>& roots, std::vector<int>& path) {
+  const Network& network = network_;
+  path.clear();
+  ++epoch_;
+
+  int queue_head = 0;
+  int queue_tail = 0;
+  visit_epoch_[kSink] = epoch_;
+  for (const int root : roots) {
+    if (root == kSource) {
+      return true;
+    }
+    if (visit_epoch_[root] != epoch_) {
+      visit_epoch_[root] = epoch_;
+      parent_arc_[root] = -1;
+      search_queue_[queue_tail++] = root;
+    }
+  }
+
+  while (queue_head < queue_tail) {
+    const int current = search_queue_[queue_head++];
+    for (const int arc : network.Arcs(current)) {
+      const int previous = network.Head(arc);
+      const int incoming = network.ReverseArc(arc);
+      if (network.Residual(incoming) <= 0 || visit_epoch_[previous] == epoch_) {
+        continue;
+      }
+      visit_epoch_[previous] = epoch_;
+      parent_arc_[previous] = incoming;
+      if (previous == kSource) {
+        for (int node = previous; parent_arc_[node] != -1; node = network.Head(parent_arc_[node])) {
+          path.push_back(parent_arc_[node]);
+        }
+        return true;
+      }
+      search_queue_[queue_tail++] = previous;
+    }
+  }
+  return false;
+}
+
+// The two halves of an augmenting walk may share nodes; erasing the loops
+// leaves a simple residual path, so pushing one unit along it stays valid.
+void IncrementalSolver::PushUnitAlong(const std::vector<int>& arcs) {
+  Network& network = network_;
+  std::vector<int> simple_path;
+  std::vector<int> nodes{kSource};
+  path_position_[kSource] = 0;
+
+  for (const int arc : arcs) {
+    const int next = network.Head(arc);
+    if (path_position_[next] != -1) {
+      const int keep = path_position_[next];
+      for (int i = keep + 1; i < static_cast<int>(nodes.size()); ++i) {
+        path_position_[nodes[i]] = -1;
+      }
+      nodes.resize(keep + 1);
+      simple_path.resize(keep);
+      continue;
+    }
+    path_position_[next] = static_cast<int>(nodes.size());
+    nodes.push_back(next);
+    simple_path.push_back(arc);
+  }
+
+  for (const int node : nodes) {
+    path_position_[node] = -1;
+  }
+  for (const int arc : simple_path) {
+    Push(arc, 1);
+  }
+}
+
+int IncrementalSolver::Tail(int arc) const {
+  return network_.Head(network_.ReverseArc(arc));
+}
+
+int IncrementalSolver::AssignmentArc(
+    const std::string& doctor_id, const std::string& period_id, const std::string& day_id, bool create) {
+  const std::optional<std::uint32_t> doctor = input_.doctor_ids.Find(doctor_id);
+  const std::optional<std::uint32_t> period = input_.period_ids.Find(period_id);
+  const std::optional<std::uint32_t> day = input_.day_ids.Find(day_id);
+  if (!doctor || !period || !day) {
+    return -1;
+  }
+  return AssignmentArc(*doctor, *period, *day, create);
+}
+
+int IncrementalSolver::AssignmentArc(
+    std::uint32_t doctor_id, std::uint32_t period_id, std::uint32_t day_id, bool create) {
+  const std::uint64_t key = AssignmentKey(doctor_id, period_id, day_id);
+  const auto it = assignment_arcs_.find(key);
+  if (it != assignment_arcs_.end()) {
+    return it->second;
+  }
+  const std::vector<std::uint32_t>& days = period_days_[period_id];
+  if (!create || doctor_positions_[doctor_id] == -1 || !std::binary_search(days.begin(), days.end(), day_id)) {
+    return -1;
+  }
+
+  const int arc = AddEdge(DoctorPeriodNode(doctor_id, period_id), Tail(day_arcs_[day_demands_[day_id]]), 0);
+  edge_assignment_[arc / 2] = static_cast<int>(assignment_refs_.size());
+  assignment_refs_.push_back(AssignmentRef{doctor_positions_[doctor_id], period_id, day_id});
+  assignment_arcs_.emplace(key, arc);
+  return arc;
+}
+
+int IncrementalSolver::DoctorPeriodNode(std::uint32_t doctor_id, std::uint32_t period_id) {
+  const auto [it, inserted] = doctor_period_nodes_.try_emplace(AssignmentKey(doctor_id, period_id, 0), -1);
+  if (inserted) {
+    it->second = AddNode();
+    AddEdge(network_.Head(doctor_arcs_[doctor_id]), it->second, 1);
+  }
+  return it->second;
+}
+
+int IncrementalSolver::AddNode() {
+  visit_epoch_.push_back(0);
+  parent_arc_.push_back(-1);
+  path_position_.push_back(-1);
+  search_queue_.push_back(0);
+  return network_.AddNode();
+}
+
+int IncrementalSolver::AddEdge(int from, int to, int capacity, int flow) {
+  edge_assignment_.push_back(-1);
+  edge_demand_.push_back(-1);
+  return network_.AddEdge(from, to, capacity, flow);
+}
+
+// Every flow change goes through here, so the assignments and uncovered days
+// follow the arcs a repair touches instead of being re-extracted.
+void IncrementalSolver::Push(int arc, int amount) {
+  network_.Push(arc, amount);
+  const int edge = arc / 2;
+  if (edge_assignment_[edge] != -1) {
+    const AssignmentRef& ref = assignment_refs_[edge_assignment_[edge]];
+    const std::tuple<int, std::uint32_t, std::uint32_t> key(ref.doctor, ref.period_id, ref.day_id);
+    if (network_.Flow(2 * edge) > 0) {
+      assigned_.insert(key);
+    } else {
+      assigned_.erase(key);
+    }
+  } else if (edge_demand_[edge] != -1) {
+    UpdateCoverage(edge_demand_[edge]);
+  }
+}
+
+void IncrementalSolver::UpdateCoverage(int demand) {
+  if (network_.Flow(day_arcs_[demand]) < required_[demand]) {
+    uncovered_demands_.insert(demand);
+  } else {
+    uncovered_demands_.erase(demand);
+  }
+}
+
+std::uint64_t IncrementalSolver::AssignmentKey(
+    std::uint32_t doctor_id, std::uint32_t period_id, std::uint32_t day_id) const {
+  return (static_cast<std::uint64_t>(doctor_id) * input_.period_ids.size() + period_id) * input_.day_ids.size() +
+         day_id;
+}
+
+}  // namespace scheduler
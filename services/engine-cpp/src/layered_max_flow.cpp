@@ -0,0 +1,250 @@
+#include <scheduler/layered_max_flow.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace scheduler {
+
+namespace {
+
+// Stop is also polled every this many augmentations inside a phase, as in
+// FlowNetwork::Dinic.
+constexpr int kStopCheckInterval = 256;
+
+enum class Layer { kSource, kDoctor, kDoctorPeriod, kDay, kSink, kOutside };
+
+Layer LayerOf(const FlowLayers& layers, int node) {
+  if (node == layers.source) {
+    return Layer::kSource;
+  }
+  if (node == layers.sink) {
+    return Layer::kSink;
+  }
+  if (node >= layers.doctor_offset && node < layers.doctor_offset + layers.doctor_count) {
+    return Layer::kDoctor;
+  }
+  if (node >= layers.doctor_period_offset && node < layers.doctor_period_offset + layers.doctor_period_count) {
+    return Layer::kDoctorPeriod;
+  }
+  if (node >= layers.day_offset && node < layers.day_offset + layers.day_count) {
+    return Layer::kDay;
+  }
+  return Layer::kOutside;
+}
+
+bool IsAdjacentLayer(Layer from, Layer to) {
+  switch (from) {
+    case Layer::kSource:
+      return to == Layer::kDoctor;
+    case Layer::kDoctor:
+      return to == Layer::kSource || to == Layer::kDoctorPeriod;
+    case Layer::kDoctorPeriod:
+      return to == Layer::kDoctor || to == Layer::kDay;
+    case Layer::kDay:
+      return to == Layer::kDoctorPeriod || to == Layer::kSink;
+    case Layer::kSink:
+      return to == Layer::kDay;
+    case Layer::kOutside:
+      return false;
+  }
+  return false;
+}
+
+template <bool kCount>
+int RunLayeredMaxFlow(FlowNetwork& network, const FlowLayers& layers, MaxFlowStats& stats, const StopCondition* stop) {
+  const int node_count = network.node_count();
+  const int source = layers.source;
+  const int sink = layers.sink;
+
+  std::vector<int> source_arc(layers.doctor_count, -1);
+  for (int doctor = 0; doctor < layers.doctor_count; ++doctor) {
+    const int node = layers.doctor_offset + doctor;
+    for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+      if (network.Head(arc) == source) {
+        source_arc[doctor] = network.ReverseArc(arc);
+        break;
+      }
+    }
+  }
+
+  std::vector<int> sink_arc(layers.day_count, -1);
+  for (int day = 0; day < layers.day_count; ++day) {
+    const int node = layers.day_offset + day;
+    for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+      if (network.Head(arc) == sink) {
+        sink_arc[day] = arc;
+        break;
+      }
+    }
+  }
+
+  auto spare_source = [&](int doctor) {
+    return source_arc[doctor] == -1 ? 0 : network.Residual(source_arc[doctor]);
+  };
+  auto spare_sink = [&](int node) {
+    const int day = node - layers.day_offset;
+    if (day < 0 || day >= layers.day_count || sink_arc[day] == -1) {
+      return 0;
+    }
+    return network.Residual(sink_arc[day]);
+  };
+
+  std::vector<int> level(node_count);
+  std::vector<int> current_arc(node_count);
+  std::vector<int> bfs_queue(node_count);
+  std::vector<int> path;
+  int total_flow = 0;
+  int augmentations = 0;
+
+  while (!(stop && stop->ShouldStop())) {
+    std::fill(level.begin(), level.end(), -1);
+    int queue_head = 0;
+    int queue_tail = 0;
+    for (int doctor = 0; doctor < layers.doctor_count; ++doctor) {
+      if (spare_source(doctor) > 0) {
+        level[layers.doctor_offset + doctor] = 0;
+        bfs_queue[queue_tail++] = layers.doctor_offset + doctor;
+      }
+    }
+
+    int terminal_level = -1;
+    if constexpr (kCount) {
+      ++stats.phases;
+    }
+    while (queue_head < queue_tail) {
+      const int current = bfs_queue[queue_head++];
+      if (terminal_level != -1 && level[current] >= terminal_level) {
+        break;
+      }
+      if constexpr (kCount) {
+        stats.arcs_scanned += network.EndArc(current) - network.FirstArc(current);
+      }
+      for (int arc = network.FirstArc(current); arc < network.EndArc(current); ++arc) {
+        const int next = network.Head(arc);
+        if (next == source || next == sink || level[next] != -1 || network.Residual(arc) <= 0) {
+          continue;
+        }
+        level[next] = level[current] + 1;
+        bfs_queue[queue_tail++] = next;
+        if (terminal_level == -1 && spare_sink(next) > 0) {
+          terminal_level = level[next];
+        }
+      }
+    }
+
+    if (terminal_level == -1) {
+      break;
+    }
+
+    for (int node = 0; node < node_count; ++node) {
+      current_arc[node] = network.FirstArc(node);
+    }
+
+    for (int doctor = 0; doctor < layers.doctor_count; ++doctor) {
+      const int root = layers.doctor_offset + doctor;
+      if (level[root] != 0) {
+        continue;
+      }
+
+      path.clear();
+      while (spare_source(doctor) > 0 && level[root] == 0) {
+        const int current = path.empty() ? root : network.Head(path.back());
+
+        if (level[current] == terminal_level && spare_sink(current) > 0) {
+          int path_flow = std::min(spare_source(doctor), spare_sink(current));
+          for (const int arc : path) {
+            path_flow = std::min(path_flow, network.Residual(arc));
+          }
+
+          network.Push(source_arc[doctor], path_flow);
+          for (const int arc : path) {
+            network.Push(arc, path_flow);
+          }
+          network.Push(sink_arc[current - layers.day_offset], path_flow);
+          total_flow += path_flow;
+          if constexpr (kCount) {
+            ++stats.augmentations;
+          }
+
+          std::size_t retreat_to = path.size();
+          for (std::size_t i = 0; i < path.size(); ++i) {
+            if (network.Residual(path[i]) == 0) {
+              retreat_to = i;
+              break;
+            }
+          }
+          path.resize(retreat_to);
+          if (stop && ++augmentations == kStopCheckInterval) {
+            augmentations = 0;
+            if (stop->ShouldStop()) {
+              break;
+            }
+          }
+          continue;
+        }
+
+        int& arc = current_arc[current];
+        const int end_arc = network.EndArc(current);
+        if (level[current] < terminal_level) {
+          [[maybe_unused]] const int scan_start = arc;
+          while (arc < end_arc && (network.Residual(arc) <= 0 || level[network.Head(arc)] != level[current] + 1)) {
+            ++arc;
+          }
+          if constexpr (kCount) {
+            stats.arcs_scanned += arc - scan_start + (arc < end_arc ? 1 : 0);
+          }
+        } else {
+          arc = end_arc;
+        }
+
+        if (arc < end_arc) {
+          path.push_back(arc);
+          continue;
+        }
+
+        level[current] = -1;
+        if (path.empty()) {
+          break;
+        }
+        path.pop_back();
+        ++current_arc[path.empty() ? root : network.Head(path.back())];
+      }
+      if (stop && stop->Fired()) {
+        break;
+      }
+    }
+  }
+
+  return total_flow;
+}
+
+}  // namespace
+
+bool MatchesFlowLayers(const FlowNetwork& network, const FlowLayers& layers) {
+  const int middle_count = layers.doctor_count + layers.doctor_period_count + layers.day_count;
+  if (network.node_count() != middle_count + 2) {
+    return false;
+  }
+
+  for (int node = 0; node < network.node_count(); ++node) {
+    const Layer from = LayerOf(layers, node);
+    if (from == Layer::kOutside) {
+      return false;
+    }
+    for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+      const Layer to = LayerOf(layers, network.Head(arc));
+      if (!IsAdjacentLayer(from, to)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int LayeredMaxFlow(FlowNetwork& network, const FlowLayers& layers, MaxFlowStats* stats, const StopCondition* stop) {
+  MaxFlowStats unused;
+  return stats ? RunLayeredMaxFlow<true>(network, layers, *stats, stop)
+               : RunLayeredMaxFlow<false>(network, layers, unused, stop);
+}
+
+}  // namespace scheduler
@@ -1,30 +1,303 @@
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
 #include <iostream>
-#include <sstream>
-#include <nlohmann/json.hpp>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <scheduler/cycle_solver.hpp>
+#include <scheduler/engine_server.hpp>
+#include <scheduler/incremental_solver.hpp>
+#include <scheduler/problem_binary.hpp>
+#include <scheduler/problem_input.hpp>
+#include <scheduler/result_cache.hpp>
+#include <scheduler/solve_result_json.hpp>
 #include <scheduler/solver.hpp>
 
-int main() {
-  std::stringstream buffer;
-  buffer << std::cin.rdbuf();
+namespace {
+
+constexpr const char* kUsage =
+    "usage: scheduler_engine [--algorithm auto|edmonds-karp|dinic|push-relabel|parallel-push-relabel] [--threads N] [--stats]\n"
+    "                        [--time-budget-ms N] [--no-warm-start] [--balanced] < request.json\n"
+    "       scheduler_engine --serve [--workers N] [--algorithm ...]   (newline-delimited requests)\n"
+    "       scheduler_engine --batch [--algorithm ...] < problems.json    (JSON array of requests)\n"
+    "       scheduler_engine --to-binary|--to-json < request              (convert problem format)\n"
+    "       scheduler_engine --criticality [--coverage-loss] < request.json (doctors the roster cannot lose)\n"
+    "       scheduler_engine --cycle [--algorithm ...] < cycle.json      (all sprints of a planning cycle at once)\n"
+    "--cache-size N / --cache-dir DIR answer repeated problems from an LRU of N results, kept on disk under DIR.\n"
+    "--cache-disk-size N keeps at most N files in DIR (default 4096, 0 for no bound).\n"
+    "--stats adds phase timings, network size and engine counters under \"stats\" in each result.\n"
+    "--time-budget-ms stops the solve after N ms and returns the flow found so far with \"truncated\": true.\n"
+    "--algorithm also runs after the greedy seed; add --no-warm-start to run that engine from zero flow.\n"
+    "--no-warm-start skips the greedy seed flow and leaves every unit to the max-flow engine.\n"
+    "--balanced solves min-cost flow instead: the same coverage, with days spread as evenly as possible.\n"
+    "A one-shot request may be JSON or the binary problem format; it is detected by its magic header.\n";
+
+enum class Conversion { kNone, kToBinary, kToJson };
+
+struct CommandLine {
+  bool serve = false;
+  bool batch = false;
+  bool criticality = false;
+  bool coverage_loss = false;
+  bool cycle = false;
+  Conversion conversion = Conversion::kNone;
+  scheduler::ServerOptions server_options;
+  std::optional<scheduler::ResultCacheOptions> cache_options;
+};
+
+bool ReadFlagValue(int argc, char** argv, int& i, const std::string& flag, std::string& value) {
+  const std::string arg = argv[i];
+  if (arg == flag && i + 1 < argc) {
+    value = argv[++i];
+    return true;
+  }
+  if (arg.rfind(flag + "=", 0) == 0) {
+    value = arg.substr(flag.size() + 1);
+    return true;
+  }
+  return false;
+}
+
+// Reads `value` as a whole decimal int of at least `min` (std::stoi alone
+// takes "4x" as 4); otherwise prints "Invalid <what>" with the usage.
+bool ReadInt(const std::string& value, int min, const char* what, int& number) {
+  try {
+    std::size_t end = 0;
+    const int parsed = std::stoi(value, &end);
+    if (end == value.size() && parsed >= min) {
+      number = parsed;
+      return true;
+    }
+  } catch (const std::exception&) {
+  }
+  std::cerr << "Invalid " << what << ": " << value << "\n" << kUsage;
+  return false;
+}
+
+bool ParseArguments(int argc, char** argv, CommandLine& command_line) {
+  scheduler::SolveOptions& options = command_line.server_options.solve_options;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    std::string value;
+
+    if (arg == "--serve") {
+      command_line.serve = true;
+    } else if (arg == "--batch") {
+      command_line.batch = true;
+    } else if (arg == "--criticality") {
+      command_line.criticality = true;
+    } else if (arg == "--coverage-loss") {
+      command_line.coverage_loss = true;
+    } else if (arg == "--cycle") {
+      command_line.cycle = true;
+    } else if (arg == "--stats") {
+      options.collect_stats = true;
+    } else if (arg == "--no-warm-start") {
+      options.warm_start = false;
+    } else if (arg == "--balanced") {
+      options.balance_load = true;
+    } else if (arg == "--to-binary") {
+      command_line.conversion = Conversion::kToBinary;
+    } else if (arg == "--to-json") {
+      command_line.conversion = Conversion::kToJson;
+    } else if (ReadFlagValue(argc, argv, i, "--workers", value)) {
+      if (!ReadInt(value, 1, "worker count", command_line.server_options.worker_count)) {
+        return false;
+      }
+    } else if (ReadFlagValue(argc, argv, i, "--threads", value)) {
+      // 0 uses every core.
+      if (!ReadInt(value, 0, "thread count", options.threads)) {
+        return false;
+      }
+    } else if (ReadFlagValue(argc, argv, i, "--time-budget-ms", value)) {
+      int budget_ms = 0;
+      if (!ReadInt(value, 1, "time budget", budget_ms)) {
+        return false;
+      }
+      options.time_budget = std::chrono::milliseconds(budget_ms);
+    } else if (ReadFlagValue(argc, argv, i, "--cache-size", value)) {
+      int capacity = 0;
+      if (!ReadInt(value, 0, "cache size", capacity)) {
+        return false;
+      }
+      if (!command_line.cache_options) {
+        command_line.cache_options.emplace();
+      }
+      command_line.cache_options->capacity = static_cast<std::size_t>(capacity);
+    } else if (ReadFlagValue(argc, argv, i, "--cache-disk-size", value)) {
+      int capacity = 0;
+      if (!ReadInt(value, 0, "cache disk size", capacity)) {
+        return false;
+      }
+      if (!command_line.cache_options) {
+        command_line.cache_options.emplace();
+      }
+      command_line.cache_options->disk_capacity = static_cast<std::size_t>(capacity);
+    } else if (ReadFlagValue(argc, argv, i, "--cache-dir", value)) {
+      if (!command_line.cache_options) {
+        command_line.cache_options.emplace();
+      }
+      command_line.cache_options->directory = value;
+    } else if (ReadFlagValue(argc, argv, i, "--algorithm", value)) {
+      if (value == "auto") {
+        options.algorithm.reset();
+        continue;
+      }
+
+      const std::optional<scheduler::MaxFlowAlgorithm> algorithm = scheduler::ParseMaxFlowAlgorithm(value);
+      if (!algorithm) {
+        std::cerr << "Unknown max-flow algorithm: " << value << "\n" << kUsage;
+        return false;
+      }
+      options.algorithm = *algorithm;
+    } else {
+      std::cerr << "Unknown argument: " << arg << "\n" << kUsage;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool StdinIsBinaryProblem() {
+  return std::cin.peek() == scheduler::kProblemBinaryMagic[0];
+}
+
+// Holds a binary problem read from stdin: mapped in place when stdin is a
+// regular file, otherwise read into memory (pipes).
+struct BinaryInput {
+  std::optional<scheduler::MappedFile> mapped;
+  std::string buffer;
+
+  const char* data() const { return mapped ? mapped->data() : buffer.data(); }
+  std::size_t size() const { return mapped ? mapped->size() : buffer.size(); }
+};
+
+BinaryInput ReadBinaryInput() {
+  BinaryInput input;
+  input.mapped = scheduler::MappedFile::Map(STDIN_FILENO);
+  if (!input.mapped) {
+    input.buffer.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+  }
+  return input;
+}
+
+int Convert(Conversion conversion) {
+  try {
+    std::string output;
+    if (StdinIsBinaryProblem()) {
+      const BinaryInput input = ReadBinaryInput();
+      const scheduler::ProblemView problem = scheduler::DecodeProblemBinary(input.data(), input.size());
+      output = conversion == Conversion::kToBinary ? scheduler::EncodeProblemBinary(problem)
+                                                   : scheduler::SerializeProblemJson(problem);
+    } else {
+      const scheduler::ProblemInput problem = scheduler::ParseProblemInput(std::cin);
+      output = conversion == Conversion::kToBinary ? scheduler::EncodeProblemBinary(problem.View())
+                                                   : scheduler::SerializeProblemJson(problem.View());
+    }
+    std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+    return 0;
+  } catch (const std::exception& error) {
+    std::cerr << "Conversion failed: " << error.what() << "\n";
+    return 1;
+  }
+}
 
-  const auto result = scheduler::Solve(buffer.str());
+// One solve, then every doctor is removed and restored in the residual
+// network (IncrementalSolver::AnalyzeDoctorCriticality). JSON input only.
+int AnalyzeCriticality(const scheduler::SolveOptions& options, bool coverage_loss) {
+  try {
+    scheduler::IncrementalSolver solver(scheduler::ParseProblemInput(std::cin), options);
+    std::cout << scheduler::SerializeCriticalityReport(solver.AnalyzeDoctorCriticality(coverage_loss));
+    return 0;
+  } catch (const std::exception& error) {
+    std::cerr << "Criticality analysis failed: " << error.what() << "\n";
+    return 1;
+  }
+}
 
-  nlohmann::json output;
-  output["contractVersion"] = result.contract_version;
-  output["isFeasible"] = result.is_feasible;
-  output["assignedCount"] = result.assigned_count;
-  output["uncoveredDays"] = result.uncovered_days;
+// Every sprint of a planning cycle in one max flow (SolveCycle). JSON input only.
+int SolvePlanningCycle(const scheduler::SolveOptions& options) {
+  try {
+    std::cout << scheduler::SerializeCycleSolveResult(scheduler::SolveCycle(std::cin, options));
+    return 0;
+  } catch (const std::exception& error) {
+    std::cerr << "Cycle solve failed: " << error.what() << "\n";
+    return 1;
+  }
+}
 
-  output["assignments"] = nlohmann::json::array();
-  for (const auto& assignment : result.assignments) {
-    output["assignments"].push_back(
-        {
-            {"doctorId", assignment.doctor_id},
-            {"dayId", assignment.day_id},
-            {"periodId", assignment.period_id},
-        });
+// Long-running modes leave the cache counters on stderr when they finish.
+void ReportCacheCounters(const std::optional<scheduler::ResultCache>& cache) {
+  if (!cache) {
+    return;
   }
+  const scheduler::ResultCacheCounters counters = cache->counters();
+  std::cerr << "result cache: " << counters.hits << " hits (" << counters.disk_hits << " from disk), "
+            << counters.misses << " misses, " << counters.evictions << " evictions, " << counters.disk_evictions
+            << " disk evictions\n";
+}
 
-  std::cout << output.dump();
+}  // namespace
+
+int main(int argc, char** argv) {
+  CommandLine command_line;
+  if (!ParseArguments(argc, argv, command_line)) {
+    return 2;
+  }
+
+  const int modes = static_cast<int>(command_line.serve) + static_cast<int>(command_line.batch) +
+                    static_cast<int>(command_line.conversion != Conversion::kNone) +
+                    static_cast<int>(command_line.criticality) + static_cast<int>(command_line.cycle);
+  if (modes > 1) {
+    std::cerr << "--serve, --batch, --criticality, --cycle and --to-binary/--to-json are mutually exclusive\n"
+              << kUsage;
+    return 2;
+  }
+
+  if (command_line.conversion != Conversion::kNone) {
+    return Convert(command_line.conversion);
+  }
+
+  // Lives for the whole run; only Solve, --serve and --batch consult it.
+  std::optional<scheduler::ResultCache> cache;
+  if (command_line.cache_options) {
+    cache.emplace(*command_line.cache_options);
+    command_line.server_options.solve_options.result_cache = &*cache;
+  }
+
+  if (command_line.criticality) {
+    return AnalyzeCriticality(command_line.server_options.solve_options, command_line.coverage_loss);
+  }
+
+  if (command_line.cycle) {
+    return SolvePlanningCycle(command_line.server_options.solve_options);
+  }
+
+  if (command_line.batch) {
+    const int exit_code = scheduler::RunBatch(std::cin, std::cout, command_line.server_options.solve_options);
+    ReportCacheCounters(cache);
+    return exit_code;
+  }
+
+  if (command_line.serve) {
+    std::ios::sync_with_stdio(false);
+    const int exit_code = scheduler::RunServer(std::cin, std::cout, command_line.server_options);
+    ReportCacheCounters(cache);
+    return exit_code;
+  }
+
+  const scheduler::SolveOptions& options = command_line.server_options.solve_options;
+  scheduler::SolveResult result;
+  if (StdinIsBinaryProblem()) {
+    const BinaryInput input = ReadBinaryInput();
+    result = scheduler::SolveBinary(input.data(), input.size(), options);
+  } else {
+    result = scheduler::Solve(std::cin, options);
+  }
+  std::cout << scheduler::SerializeSolveResult(result);
   return 0;
 }
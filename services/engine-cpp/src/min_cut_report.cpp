@@ -0,0 +1,193 @@
+#include <scheduler/min_cut_report.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace scheduler {
+
+namespace {
+
+std::string NodeName(std::string_view kind, std::string_view id) {
+  std::string name;
+  name.reserve(kind.size() + id.size());
+  return name.append(kind).append(id);
+}
+
+std::string DoctorPeriodName(std::string_view doctor_id, std::string_view period_id) {
+  return NodeName("doctor-period:", doctor_id).append(":").append(period_id);
+}
+
+// Marks every node reachable from `source` over arcs with residual capacity.
+std::vector<char> ResidualReachable(const FlowNetwork& network, int source) {
+  std::vector<char> reachable(network.node_count(), 0);
+  std::vector<int> queue;
+  queue.reserve(network.node_count());
+  queue.push_back(source);
+  reachable[source] = 1;
+  for (std::size_t next = 0; next < queue.size(); ++next) {
+    const int node = queue[next];
+    for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+      const int head = network.Head(arc);
+      if (network.Residual(arc) > 0 && !reachable[head]) {
+        reachable[head] = 1;
+        queue.push_back(head);
+      }
+    }
+  }
+  return reachable;
+}
+
+}  // namespace
+
+MinCutRefs BuildMinCutRefs(const std::vector<GraphBuildResult>& graphs) {
+  // Entries are keyed by doctor / demand position and period symbol and sorted
+  // once at the end, so components interleave the way the extractor's do.
+  MinCutRefs refs;
+
+  for (const GraphBuildResult& graph : graphs) {
+    const FlowNetwork& network = graph.network;
+    const FlowLayers& layers = graph.layers;
+    const std::vector<char> reachable = ResidualReachable(network, graph.source);
+
+    std::vector<std::uint32_t> cp_period(layers.doctor_period_count);
+    for (const AssignmentEdgeRef& edge_ref : graph.assignment_edges) {
+      cp_period[network.Head(network.ReverseArc(edge_ref.arc)) - layers.doctor_period_offset] = edge_ref.period_id;
+    }
+
+    // A group whose source arc is no tighter than its member arcs together
+    // can move to S at the same cut value: its members' own caps bind. Only
+    // groups held below that by their cycle cap stay in T.
+    std::vector<char> parent_in_s(layers.doctor_offset, 0);
+    for (int parent = 0; parent < layers.doctor_offset; ++parent) {
+      if (reachable[parent] || parent == graph.source) {
+        parent_in_s[parent] = reachable[parent];
+        continue;
+      }
+      int group_cap = 0;
+      int member_caps = 0;
+      for (int arc = network.FirstArc(parent); arc < network.EndArc(parent); ++arc) {
+        if (network.Head(arc) == graph.source) {
+          group_cap = network.Capacity(network.ReverseArc(arc));
+        } else if (network.Head(arc) >= layers.doctor_offset) {
+          member_caps += network.Capacity(arc);
+        }
+      }
+      parent_in_s[parent] = group_cap == member_caps;
+    }
+
+    for (int c = 0; c < layers.doctor_count; ++c) {
+      const int node = layers.doctor_offset + c;
+      const std::vector<int>& doctors = graph.doctor_classes[c].doctors;
+      const int members = static_cast<int>(doctors.size());
+      if (!reachable[node]) {
+        // The parent arc is saturated; every arc leaving the class stays in T.
+        // The parent (the source, or a cycle group) has a lower id, as in
+        // BalancedMaxFlow.
+        for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+          const int parent = network.Head(arc);
+          if (parent < layers.doctor_offset && parent_in_s[parent]) {
+            const int cap = network.Capacity(network.ReverseArc(arc)) / members;
+            for (const int doctor : doctors) {
+              if (cap > 0) {
+                refs.capped_doctors.emplace_back(doctor, cap);
+              }
+            }
+          }
+        }
+        continue;
+      }
+
+      for (const int doctor : doctors) {
+        refs.reachable_doctors.push_back(doctor);
+      }
+      for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+        const int cp = network.Head(arc) - layers.doctor_period_offset;
+        if (cp < 0 || cp >= layers.doctor_period_count) {
+          continue;
+        }
+        const bool cut = !reachable[network.Head(arc)];
+        if (cut && network.Capacity(arc) == 0) {
+          continue;
+        }
+        for (const int doctor : doctors) {
+          (cut ? refs.period_limits : refs.reachable_doctor_periods).emplace_back(doctor, cp_period[cp]);
+        }
+      }
+    }
+
+    for (const DayDemandRef& day_ref : graph.day_edges) {
+      const int node = network.Head(network.ReverseArc(day_ref.arc));
+      if (reachable[node]) {
+        refs.reachable_days.push_back(day_ref.demand);
+        if (day_ref.required > 0) {
+          refs.cut_days.emplace_back(day_ref.demand, day_ref.required);
+        }
+      } else if (day_ref.required > 0 && network.EndArc(node) - network.FirstArc(node) == 1) {
+        // The sink arc is the only one: no doctor-period reaches this day.
+        refs.uncoverable_days.emplace_back(day_ref.demand, day_ref.required);
+      }
+    }
+  }
+
+  std::sort(refs.reachable_doctors.begin(), refs.reachable_doctors.end());
+  std::sort(refs.reachable_doctor_periods.begin(), refs.reachable_doctor_periods.end());
+  std::sort(refs.reachable_days.begin(), refs.reachable_days.end());
+  std::sort(refs.capped_doctors.begin(), refs.capped_doctors.end());
+  std::sort(refs.period_limits.begin(), refs.period_limits.end());
+  std::sort(refs.cut_days.begin(), refs.cut_days.end());
+  std::sort(refs.uncoverable_days.begin(), refs.uncoverable_days.end());
+
+  for (const auto& [doctor, cap] : refs.capped_doctors) {
+    refs.value += cap;
+  }
+  refs.value += static_cast<int>(refs.period_limits.size());
+  for (const auto& [demand, required] : refs.cut_days) {
+    refs.value += required;
+  }
+  return refs;
+}
+
+MinCutReport BuildMinCutReport(const std::vector<GraphBuildResult>& graphs, const ProblemView& input) {
+  const MinCutRefs refs = BuildMinCutRefs(graphs);
+  const auto doctor_id = [&input](int doctor) { return input.doctor_ids.Name(input.doctors[doctor].id); };
+  const auto day_id = [&input](int demand) { return input.day_ids.Name(input.demands[demand].day_id); };
+
+  MinCutReport report;
+  report.value = refs.value;
+  report.reachable_nodes.reserve(1 + refs.reachable_doctors.size() + refs.reachable_doctor_periods.size() +
+                                 refs.reachable_days.size());
+  report.reachable_nodes.emplace_back("source");
+  for (const int doctor : refs.reachable_doctors) {
+    report.reachable_nodes.push_back(NodeName("doctor:", doctor_id(doctor)));
+  }
+  for (const auto& [doctor, period] : refs.reachable_doctor_periods) {
+    report.reachable_nodes.push_back(DoctorPeriodName(doctor_id(doctor), input.period_ids.Name(period)));
+  }
+  for (const int demand : refs.reachable_days) {
+    report.reachable_nodes.push_back(NodeName("day:", day_id(demand)));
+  }
+
+  for (const auto& [doctor, cap] : refs.capped_doctors) {
+    report.cut_edges.push_back(MinCutEdge{"source", NodeName("doctor:", doctor_id(doctor)), cap});
+    report.capped_doctors.push_back(CappedDoctor{std::string(doctor_id(doctor)), cap});
+  }
+  for (const auto& [doctor, period] : refs.period_limits) {
+    const std::string_view period_id = input.period_ids.Name(period);
+    report.cut_edges.push_back(
+        MinCutEdge{NodeName("doctor:", doctor_id(doctor)), DoctorPeriodName(doctor_id(doctor), period_id), 1});
+    report.period_limits.push_back(PeriodLimit{std::string(doctor_id(doctor)), std::string(period_id)});
+  }
+  for (const auto& [demand, required] : refs.cut_days) {
+    report.cut_edges.push_back(MinCutEdge{NodeName("day:", day_id(demand)), "sink", required});
+  }
+  for (const auto& [demand, required] : refs.uncoverable_days) {
+    report.uncoverable_days.push_back(UncoverableDay{std::string(day_id(demand)), required});
+  }
+  return report;
+}
+
+}  // namespace scheduler
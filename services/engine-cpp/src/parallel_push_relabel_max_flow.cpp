@@ -0,0 +1,242 @@
+#include <scheduler/flow_network.hpp>
+#include <scheduler/thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace scheduler {
+
+namespace {
+
+// Rounds with fewer active nodes than this run on the calling thread; handing
+// them to the pool costs more than the work itself.
+constexpr int kMinActivePerThread = 256;
+
+}  // namespace
+
+// Synchronous parallel push-relabel (Goldberg). Every round runs two phases
+// over the active nodes, each split across threads:
+// - push: labels are frozen, so an admissible arc v -> w can only be used by
+//   v (w -> v would need label[w] == label[v] + 1). Each node drains its own
+//   excess along its own arcs; only the excess arriving at heads is shared,
+//   and it is summed atomically into `incoming`;
+// - relabel: nodes left with excess take min(label[w] + 1) over residual
+//   arcs, computed from the labels of the previous round.
+// A node's work depends only on its own state and the frozen labels, so the
+// final flow (not only its value) is the same for any thread count.
+// Periodic global relabeling (sequential reverse BFS) keeps labels exact.
+// A stop is polled once per round; the preflow left then is repaired by
+// ReturnExcess.
+template <bool kCount>
+int FlowNetwork::ParallelPushRelabel(int source,
+                                     int sink,
+                                     int threads,
+                                     MaxFlowStats& stats,
+                                     const StopCondition* stop) {
+  const int node_count = node_count_;
+  const int max_label = 2 * node_count;
+  const int thread_count = threads > 0 ? threads : ThreadPool::DefaultThreadCount();
+
+  std::vector<int> label(node_count, 0);
+  std::vector<int> next_label(node_count, 0);
+  std::vector<int> excess(node_count, 0);
+  std::vector<int> current_arc(first_arc_.begin(), first_arc_.end() - 1);
+  std::unique_ptr<std::atomic<int>[]> incoming(new std::atomic<int>[node_count]);
+  for (int node = 0; node < node_count; ++node) {
+    incoming[node].store(0, std::memory_order_relaxed);
+  }
+
+  std::vector<int> active;
+  std::vector<int> next_active;
+  std::vector<char> queued(node_count, 0);
+  std::vector<std::vector<int>> touched(thread_count);
+  // Per-worker counters, summed once at the end.
+  std::vector<MaxFlowStats> worker_stats(kCount ? thread_count : 0);
+  std::vector<int> bfs_queue(node_count);
+
+  auto reverse_bfs = [&](int root) {
+    int queue_head = 0;
+    int queue_tail = 0;
+    bfs_queue[queue_tail++] = root;
+    while (queue_head < queue_tail) {
+      const int current = bfs_queue[queue_head++];
+      if constexpr (kCount) {
+        stats.arcs_scanned += first_arc_[current + 1] - first_arc_[current];
+      }
+      for (int arc = first_arc_[current]; arc < first_arc_[current + 1]; ++arc) {
+        const int previous = head_[arc];
+        if (label[previous] != max_label || residual_[reverse_[arc]] <= 0) {
+          continue;
+        }
+        label[previous] = label[current] + 1;
+        bfs_queue[queue_tail++] = previous;
+      }
+    }
+  };
+
+  auto global_relabel = [&]() {
+    if constexpr (kCount) {
+      ++stats.phases;
+    }
+    std::fill(label.begin(), label.end(), max_label);
+    label[sink] = 0;
+    label[source] = node_count;
+    reverse_bfs(sink);
+    reverse_bfs(source);
+    std::copy(first_arc_.begin(), first_arc_.end() - 1, current_arc.begin());
+  };
+
+  auto is_active = [&](int node) {
+    return node != source && node != sink && excess[node] > 0 && label[node] < max_label;
+  };
+
+  // Runs body(begin, end, worker) over [0, active.size()) in contiguous chunks.
+  std::unique_ptr<ThreadPool> pool;
+  auto for_each_chunk = [&](const auto& body) {
+    const int size = static_cast<int>(active.size());
+    const int chunks = std::min(thread_count, std::max(1, size / kMinActivePerThread));
+    if (chunks <= 1) {
+      body(0, size, 0);
+      return;
+    }
+    if (!pool) {
+      pool = std::make_unique<ThreadPool>(thread_count);
+    }
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+      const int begin = static_cast<int>(static_cast<long long>(size) * chunk / chunks);
+      const int end = static_cast<int>(static_cast<long long>(size) * (chunk + 1) / chunks);
+      pool->Submit([&body, begin, end, chunk] { body(begin, end, chunk); });
+    }
+    pool->Wait();
+  };
+
+  for (int arc = first_arc_[source]; arc < first_arc_[source + 1]; ++arc) {
+    if (residual_[arc] > 0) {
+      excess[head_[arc]] += residual_[arc];
+      Push(arc, residual_[arc]);
+    }
+  }
+
+  global_relabel();
+  for (int node = 0; node < node_count; ++node) {
+    if (is_active(node)) {
+      active.push_back(node);
+    }
+  }
+
+  long long relabels_since_global = 0;
+  while (!active.empty()) {
+    if (stop && stop->ShouldStop()) {
+      ReturnExcess(source, sink, excess);
+      break;
+    }
+    if constexpr (kCount) {
+      ++stats.phases;
+    }
+    for_each_chunk([&](int begin, int end, int worker) {
+      std::vector<int>& heads = touched[worker];
+      for (int i = begin; i < end; ++i) {
+        const int node = active[i];
+        int remaining = excess[node];
+        int arc = current_arc[node];
+        const int end_arc = first_arc_[node + 1];
+        for (; arc < end_arc; ++arc) {
+          const int next = head_[arc];
+          if constexpr (kCount) {
+            ++worker_stats[worker].arcs_scanned;
+          }
+          // Label test first: when it holds, nobody else writes this arc pair.
+          if (label[node] != label[next] + 1 || residual_[arc] <= 0) {
+            continue;
+          }
+          const int amount = std::min(remaining, residual_[arc]);
+          residual_[arc] -= amount;
+          residual_[reverse_[arc]] += amount;
+          remaining -= amount;
+          if constexpr (kCount) {
+            ++worker_stats[worker].augmentations;
+          }
+          if (incoming[next].fetch_add(amount, std::memory_order_relaxed) == 0) {
+            heads.push_back(next);
+          }
+          if (remaining == 0) {
+            break;
+          }
+        }
+        current_arc[node] = arc;
+        excess[node] = remaining;
+      }
+    });
+
+    for_each_chunk([&](int begin, int end, int worker) {
+      for (int i = begin; i < end; ++i) {
+        const int node = active[i];
+        if (excess[node] == 0) {
+          continue;
+        }
+        if constexpr (kCount) {
+          ++worker_stats[worker].relabels;
+          worker_stats[worker].arcs_scanned += first_arc_[node + 1] - first_arc_[node];
+        }
+        int new_label = max_label;
+        for (int arc = first_arc_[node]; arc < first_arc_[node + 1]; ++arc) {
+          if (residual_[arc] > 0) {
+            new_label = std::min(new_label, label[head_[arc]] + 1);
+          }
+        }
+        next_label[node] = new_label;
+      }
+    });
+
+    next_active.clear();
+    for (const int node : active) {
+      if (excess[node] > 0) {
+        label[node] = next_label[node];
+        current_arc[node] = first_arc_[node];
+        ++relabels_since_global;
+      }
+    }
+    for (std::vector<int>& heads : touched) {
+      for (const int node : heads) {
+        excess[node] += incoming[node].exchange(0, std::memory_order_relaxed);
+      }
+    }
+
+    if (relabels_since_global >= node_count) {
+      global_relabel();
+      relabels_since_global = 0;
+    }
+
+    auto enqueue = [&](int node) {
+      if (!queued[node] && is_active(node)) {
+        queued[node] = 1;
+        next_active.push_back(node);
+      }
+    };
+    for (const int node : active) {
+      enqueue(node);
+    }
+    for (std::vector<int>& heads : touched) {
+      for (const int node : heads) {
+        enqueue(node);
+      }
+      heads.clear();
+    }
+    for (const int node : next_active) {
+      queued[node] = 0;
+    }
+    active.swap(next_active);
+  }
+
+  for (const MaxFlowStats& counted : worker_stats) {
+    stats += counted;
+  }
+  return excess[sink];
+}
+
+template int FlowNetwork::ParallelPushRelabel<false>(int, int, int, MaxFlowStats&, const StopCondition*);
+template int FlowNetwork::ParallelPushRelabel<true>(int, int, int, MaxFlowStats&, const StopCondition*);
+
+}  // namespace scheduler
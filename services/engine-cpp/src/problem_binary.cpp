@@ -0,0 +1,254 @@
+#include <scheduler/problem_binary.hpp>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace scheduler {
+
+namespace {
+
+static_assert(sizeof(ProblemBinaryHeader) == 48, "binary header layout changed");
+static_assert(sizeof(Doctor) == 8 && sizeof(Period) == 12 && sizeof(Demand) == 8 && sizeof(Availability) == 12,
+              "binary record layout changed");
+static_assert(std::is_trivially_copyable<Doctor>::value && std::is_trivially_copyable<Period>::value &&
+                  std::is_trivially_copyable<Demand>::value && std::is_trivially_copyable<Availability>::value,
+              "binary records must be trivially copyable");
+
+template <typename T>
+void Append(std::string& out, const T* items, std::size_t count) {
+  out.append(reinterpret_cast<const char*>(items), count * sizeof(T));
+}
+
+[[noreturn]] void Corrupt(const std::string& reason) {
+  throw std::runtime_error("Invalid binary problem: " + reason);
+}
+
+// Hands out consecutive sections of the buffer, checking each fits.
+class SectionReader {
+ public:
+  SectionReader(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  Span<T> Take(std::uint64_t count, const char* name) {
+    const std::uint64_t bytes = count * sizeof(T);
+    if (bytes > size_ - offset_) {
+      Corrupt(std::string("truncated ") + name + " section");
+    }
+    const Span<T> section(reinterpret_cast<const T*>(data_ + offset_), static_cast<std::size_t>(count));
+    offset_ += static_cast<std::size_t>(bytes);
+    return section;
+  }
+
+  std::size_t remaining() const { return size_ - offset_; }
+
+ private:
+  const char* data_;
+  std::size_t size_;
+  std::size_t offset_ = 0;
+};
+
+void CheckSymbol(std::uint32_t symbol, std::uint32_t count, const char* name) {
+  if (symbol >= count) {
+    Corrupt(std::string(name) + " symbol out of range");
+  }
+}
+
+}  // namespace
+
+bool IsProblemBinary(const char* data, std::size_t size) {
+  return size >= sizeof(kProblemBinaryMagic) && std::memcmp(data, kProblemBinaryMagic, sizeof(kProblemBinaryMagic)) == 0;
+}
+
+std::string EncodeProblemBinary(const ProblemView& problem) {
+  ProblemBinaryHeader header{};
+  std::memcpy(header.magic, kProblemBinaryMagic, sizeof(header.magic));
+  header.version = kProblemBinaryVersion;
+  header.doctor_symbol_count = problem.doctor_ids.size();
+  header.period_symbol_count = problem.period_ids.size();
+  header.day_symbol_count = problem.day_ids.size();
+  header.doctor_count = static_cast<std::uint32_t>(problem.doctors.size());
+  header.period_count = static_cast<std::uint32_t>(problem.periods.size());
+  header.period_day_count = static_cast<std::uint32_t>(problem.period_days.size());
+  header.demand_count = static_cast<std::uint32_t>(problem.demands.size());
+  header.availability_count = static_cast<std::uint32_t>(problem.availability.size());
+
+  std::string strings;
+  std::vector<std::uint32_t> offsets{0};
+  auto add_string = [&](std::string_view name) {
+    strings.append(name.data(), name.size());
+    offsets.push_back(static_cast<std::uint32_t>(strings.size()));
+  };
+  for (const SymbolNames* names : {&problem.doctor_ids, &problem.period_ids, &problem.day_ids}) {
+    for (std::uint32_t symbol = 0; symbol < names->size(); ++symbol) {
+      add_string(names->Name(symbol));
+    }
+  }
+  add_string(problem.contract_version);
+  header.string_bytes = static_cast<std::uint32_t>(strings.size());
+
+  std::string out;
+  out.reserve(sizeof(header) + offsets.size() * sizeof(std::uint32_t) + problem.doctors.size() * sizeof(Doctor) +
+              problem.periods.size() * sizeof(Period) + problem.period_days.size() * sizeof(std::uint32_t) +
+              problem.demands.size() * sizeof(Demand) + problem.availability.size() * sizeof(Availability) +
+              strings.size());
+  Append(out, &header, 1);
+  Append(out, offsets.data(), offsets.size());
+  Append(out, problem.doctors.data(), problem.doctors.size());
+  Append(out, problem.periods.data(), problem.periods.size());
+  Append(out, problem.period_days.data(), problem.period_days.size());
+  Append(out, problem.demands.data(), problem.demands.size());
+  Append(out, problem.availability.data(), problem.availability.size());
+  out += strings;
+  return out;
+}
+
+ProblemView DecodeProblemBinary(const char* data, std::size_t size) {
+  if (!IsProblemBinary(data, size)) {
+    Corrupt("missing magic header");
+  }
+  if (reinterpret_cast<std::uintptr_t>(data) % alignof(ProblemBinaryHeader) != 0) {
+    Corrupt("buffer is not 4-byte aligned");
+  }
+
+  SectionReader reader(data, size);
+  const ProblemBinaryHeader& header = reader.Take<ProblemBinaryHeader>(1, "header")[0];
+  if (header.version != kProblemBinaryVersion) {
+    Corrupt("unsupported version " + std::to_string(header.version));
+  }
+
+  const std::uint64_t string_count = static_cast<std::uint64_t>(header.doctor_symbol_count) +
+                                     header.period_symbol_count + header.day_symbol_count + 1;
+  const Span<std::uint32_t> offsets = reader.Take<std::uint32_t>(string_count + 1, "string offset");
+
+  ProblemView problem;
+  problem.doctors = reader.Take<Doctor>(header.doctor_count, "doctor");
+  problem.periods = reader.Take<Period>(header.period_count, "period");
+  problem.period_days = reader.Take<std::uint32_t>(header.period_day_count, "period day");
+  problem.demands = reader.Take<Demand>(header.demand_count, "demand");
+  problem.availability = reader.Take<Availability>(header.availability_count, "availability");
+  if (reader.remaining() != header.string_bytes) {
+    Corrupt("string table size mismatch");
+  }
+  const char* strings = data + (size - header.string_bytes);
+
+  if (offsets[0] != 0 || offsets[offsets.size() - 1] != header.string_bytes) {
+    Corrupt("string offsets do not cover the string table");
+  }
+  for (std::size_t i = 1; i < offsets.size(); ++i) {
+    if (offsets[i] < offsets[i - 1]) {
+      Corrupt("string offsets are not sorted");
+    }
+  }
+
+  std::size_t base = 0;
+  auto names = [&](std::uint32_t count) {
+    const SymbolNames kind{Span<std::uint32_t>(offsets.data() + base, count + std::size_t{1}), strings};
+    base += count;
+    return kind;
+  };
+  problem.doctor_ids = names(header.doctor_symbol_count);
+  problem.period_ids = names(header.period_symbol_count);
+  problem.day_ids = names(header.day_symbol_count);
+  problem.contract_version = names(1).Name(0);
+
+  for (const Doctor& doctor : problem.doctors) {
+    CheckSymbol(doctor.id, header.doctor_symbol_count, "doctor");
+  }
+  for (const Period& period : problem.periods) {
+    CheckSymbol(period.id, header.period_symbol_count, "period");
+    if (static_cast<std::uint64_t>(period.first_day) + period.day_count > header.period_day_count) {
+      Corrupt("period days out of range");
+    }
+  }
+  for (const std::uint32_t day : problem.period_days) {
+    CheckSymbol(day, header.day_symbol_count, "day");
+  }
+  for (const Demand& demand : problem.demands) {
+    CheckSymbol(demand.day_id, header.day_symbol_count, "day");
+  }
+  for (const Availability& available : problem.availability) {
+    CheckSymbol(available.doctor_id, header.doctor_symbol_count, "doctor");
+    CheckSymbol(available.period_id, header.period_symbol_count, "period");
+    CheckSymbol(available.day_id, header.day_symbol_count, "day");
+  }
+
+  return problem;
+}
+
+std::string SerializeProblemJson(const ProblemView& problem) {
+  nlohmann::ordered_json root;
+  root["contractVersion"] = problem.contract_version;
+  root["doctors"] = nlohmann::ordered_json::array();
+  root["periods"] = nlohmann::ordered_json::array();
+  root["demands"] = nlohmann::ordered_json::array();
+  root["availability"] = nlohmann::ordered_json::array();
+
+  for (const Doctor& doctor : problem.doctors) {
+    root["doctors"].push_back({{"id", problem.doctor_ids.Name(doctor.id)}, {"maxTotalDays", doctor.max_total_days}});
+  }
+  for (const Period& period : problem.periods) {
+    nlohmann::ordered_json day_ids = nlohmann::ordered_json::array();
+    for (const std::uint32_t day : problem.DaysOf(period)) {
+      day_ids.push_back(problem.day_ids.Name(day));
+    }
+    root["periods"].push_back({{"id", problem.period_ids.Name(period.id)}, {"dayIds", std::move(day_ids)}});
+  }
+  for (const Demand& demand : problem.demands) {
+    root["demands"].push_back(
+        {{"dayId", problem.day_ids.Name(demand.day_id)}, {"requiredDoctors", demand.required_doctors}});
+  }
+  for (const Availability& available : problem.availability) {
+    root["availability"].push_back({
+        {"doctorId", problem.doctor_ids.Name(available.doctor_id)},
+        {"periodId", problem.period_ids.Name(available.period_id)},
+        {"dayId", problem.day_ids.Name(available.day_id)},
+    });
+  }
+  return root.dump();
+}
+
+std::optional<MappedFile> MappedFile::Map(int fd) {
+  struct stat status {};
+  if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode) || status.st_size <= 0) {
+    return std::nullopt;
+  }
+
+  const std::size_t size = static_cast<std::size_t>(status.st_size);
+  void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (address == MAP_FAILED) {
+    return std::nullopt;
+  }
+  return MappedFile(static_cast<const char*>(address), size);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    if (data_ != nullptr) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+}  // namespace scheduler
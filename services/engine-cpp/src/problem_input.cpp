@@ -1,45 +1,353 @@
 #include <scheduler/problem_input.hpp>
+
+#include <cmath>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <string>
+
 #include <nlohmann/json.hpp>
 
+#include "problem_input_sax.hpp"
+
 namespace scheduler {
 
-ProblemInput ParseProblemInput(const std::string& input_json) {
-  const nlohmann::json root = nlohmann::json::parse(input_json);
-  ProblemInput problem;
+namespace {
+
+using detail::Json;
+using detail::kHasDoctorId;
+using detail::kHasId;
+using detail::ProblemInputSax;
+
+enum class CycleSection { kNone, kDoctorCaps, kSprints };
+
+enum class CycleField { kIgnored, kId, kProblem, kDoctorId, kMaxCycleDays };
+
+constexpr unsigned kHasProblem = 1u << 7;
+constexpr unsigned kHasMaxCycleDays = 1u << 8;
+
+// SAX handler for the cycle envelope. Levels: 1 = root object, 2 = the
+// doctorCaps / sprints array, 3 = one item. A sprint's "problem" value is
+// forwarded event by event to a ProblemInputSax over that sprint until it
+// closes, so sprints are parsed in the same single pass.
+class CycleProblemSax {
+ public:
+  explicit CycleProblemSax(CycleProblem& problem) : problem_(problem) {}
+
+  bool null() { return StartsProblem() ? sprint_->null() : Scalar(std::nullopt, "null"); }
+  bool boolean(bool value) { return StartsProblem() ? sprint_->boolean(value) : Scalar(std::nullopt, "boolean"); }
+  bool number_integer(Json::number_integer_t value) {
+    return StartsProblem() ? sprint_->number_integer(value)
+                           : Integer(static_cast<double>(value), std::to_string(value));
+  }
+  bool number_unsigned(Json::number_unsigned_t value) {
+    return StartsProblem() ? sprint_->number_unsigned(value)
+                           : Integer(static_cast<double>(value), std::to_string(value));
+  }
+  bool number_float(Json::number_float_t value, const Json::string_t& text) {
+    return StartsProblem() ? sprint_->number_float(value, text) : Integer(value, text);
+  }
+  bool binary(Json::binary_t& value) {
+    return StartsProblem() ? sprint_->binary(value) : Scalar(std::nullopt, "binary");
+  }
+
+  bool string(Json::string_t& value) {
+    if (StartsProblem()) {
+      return sprint_->string(value);
+    }
+    if (skip_depth_ > 0) {
+      return true;
+    }
+    if (depth_ == 1 && root_key_ == "contractVersion") {
+      problem_.contract_version = value;
+      return true;
+    }
+    if (depth_ == 3 && field_ == CycleField::kId && section_ == CycleSection::kSprints) {
+      problem_.sprints.back().id = value;
+      seen_ |= kHasId;
+      return true;
+    }
+    if (depth_ == 3 && field_ == CycleField::kDoctorId && section_ == CycleSection::kDoctorCaps) {
+      problem_.doctor_caps.back().doctor_id = value;
+      seen_ |= kHasDoctorId;
+      return true;
+    }
+    return Scalar(std::nullopt, "string");
+  }
+
+  bool start_object(std::size_t size) {
+    if (StartsProblem()) {
+      ++problem_depth_;
+      return sprint_->start_object(size);
+    }
+    if (skip_depth_ > 0 || Skippable()) {
+      ++skip_depth_;
+      return true;
+    }
+    if (depth_ == 0) {
+      depth_ = 1;
+      return true;
+    }
+    if (depth_ == 2) {
+      if (section_ == CycleSection::kSprints) {
+        problem_.sprints.emplace_back();
+      } else {
+        problem_.doctor_caps.emplace_back();
+      }
+      depth_ = 3;
+      seen_ = 0;
+      return true;
+    }
+    Mismatch("object");
+  }
+
+  bool end_object() {
+    if (problem_depth_ > 0) {
+      return EndProblemLevel(sprint_->end_object());
+    }
+    if (skip_depth_ > 0) {
+      --skip_depth_;
+      return true;
+    }
+    if (depth_ == 3) {
+      if (section_ == CycleSection::kSprints) {
+        RequireField(kHasId, "id");
+        RequireField(kHasProblem, "problem");
+      } else {
+        RequireField(kHasDoctorId, "doctorId");
+        RequireField(kHasMaxCycleDays, "maxCycleDays");
+      }
+      depth_ = 2;
+      return true;
+    }
+    depth_ = 0;
+    if (!has_sprints_) {
+      MissingKey("sprints");
+    }
+    return true;
+  }
+
+  bool start_array(std::size_t size) {
+    if (StartsProblem()) {
+      ++problem_depth_;
+      return sprint_->start_array(size);
+    }
+    if (skip_depth_ > 0 || Skippable()) {
+      ++skip_depth_;
+      return true;
+    }
+    if (depth_ == 1) {
+      // A repeated root key replaces the earlier section, as in ProblemInputSax.
+      section_ = RootSection();
+      if (section_ == CycleSection::kSprints) {
+        problem_.sprints.clear();
+        has_sprints_ = true;
+      } else {
+        problem_.doctor_caps.clear();
+      }
+      depth_ = 2;
+      return true;
+    }
+    Mismatch("array");
+  }
+
+  bool end_array() {
+    if (problem_depth_ > 0) {
+      return EndProblemLevel(sprint_->end_array());
+    }
+    if (skip_depth_ > 0) {
+      --skip_depth_;
+      return true;
+    }
+    section_ = CycleSection::kNone;
+    depth_ = 1;
+    return true;
+  }
+
+  bool key(Json::string_t& value) {
+    if (problem_depth_ > 0) {
+      return sprint_->key(value);
+    }
+    if (skip_depth_ > 0) {
+      return true;
+    }
+    if (depth_ == 1) {
+      root_key_ = value;
+    } else {
+      field_ = FieldFor(value);
+    }
+    return true;
+  }
+
+  template <class Exception>
+  bool parse_error(std::size_t, const std::string&, const Exception& error) {
+    throw error;
+  }
+
+ private:
+  // True while events belong to a sprint's problem, including the first one:
+  // the handler is created when the "problem" value starts.
+  bool StartsProblem() {
+    if (problem_depth_ > 0) {
+      return true;
+    }
+    if (skip_depth_ > 0 || depth_ != 3 || field_ != CycleField::kProblem) {
+      return false;
+    }
+    sprint_.emplace(problem_.sprints.back().problem);
+    field_ = CycleField::kIgnored;
+    seen_ |= kHasProblem;
+    return true;
+  }
 
-  if (root.contains("contractVersion") && root["contractVersion"].is_string()) {
-    problem.contract_version = root["contractVersion"].get<std::string>();
+  bool EndProblemLevel(bool result) {
+    if (--problem_depth_ == 0) {
+      sprint_.reset();
+    }
+    return result;
   }
 
-  for (const auto& doctor : root.at("doctors")) {
-    problem.doctors.push_back(Doctor{
-        doctor.at("id").get<std::string>(),
-        doctor.at("maxTotalDays").get<int>(),
-    });
+  // maxCycleDays must be a whole number that fits an int; 2.7 or 2^40 would
+  // otherwise be truncated or wrap.
+  bool Integer(double value, const std::string& text) {
+    const bool whole = std::isfinite(value) && std::floor(value) == value &&
+                       value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max();
+    if (!whole && skip_depth_ == 0 && !Skippable() && depth_ == 3 && field_ == CycleField::kMaxCycleDays) {
+      throw Json::type_error::create(302, "maxCycleDays must be an integer within int range, but is " + text,
+                                     static_cast<const Json*>(nullptr));
+    }
+    return Scalar(whole ? std::optional<int>(static_cast<int>(value)) : std::nullopt, "number");
   }
 
-  for (const auto& period : root.at("periods")) {
-    problem.periods.push_back(Period{
-        period.at("id").get<std::string>(),
-        period.at("dayIds").get<std::vector<std::string>>(),
-    });
+  bool Scalar(std::optional<int> number, const char* type_name) {
+    if (skip_depth_ > 0 || Skippable()) {
+      return true;
+    }
+    if (depth_ == 3 && number && field_ == CycleField::kMaxCycleDays) {
+      problem_.doctor_caps.back().max_cycle_days = *number;
+      seen_ |= kHasMaxCycleDays;
+      return true;
+    }
+    Mismatch(type_name);
   }
 
-  for (const auto& demand : root.at("demands")) {
-    problem.demands.push_back(Demand{
-        demand.at("dayId").get<std::string>(),
-        demand.at("requiredDoctors").get<int>(),
-    });
+  bool Skippable() const {
+    if (depth_ == 1) {
+      return RootSection() == CycleSection::kNone;
+    }
+    return depth_ == 3 && field_ == CycleField::kIgnored;
   }
 
-  for (const auto& item : root.at("availability")) {
-    problem.availability.push_back(Availability{
-        item.at("doctorId").get<std::string>(),
-        item.at("periodId").get<std::string>(),
-        item.at("dayId").get<std::string>(),
-    });
+  [[noreturn]] void Mismatch(const char* type_name) const {
+    const char* expected = "object";
+    if (depth_ == 1) {
+      expected = "array";
+    } else if (depth_ == 3) {
+      expected = field_ == CycleField::kMaxCycleDays ? "number" : "string";
+    }
+    throw Json::type_error::create(
+        302, std::string("type must be ") + expected + ", but is " + type_name, static_cast<const Json*>(nullptr));
   }
 
+  CycleSection RootSection() const {
+    if (root_key_ == "doctorCaps") {
+      return CycleSection::kDoctorCaps;
+    }
+    if (root_key_ == "sprints") {
+      return CycleSection::kSprints;
+    }
+    return CycleSection::kNone;
+  }
+
+  CycleField FieldFor(const std::string& name) const {
+    if (section_ == CycleSection::kSprints) {
+      return name == "id" ? CycleField::kId : name == "problem" ? CycleField::kProblem : CycleField::kIgnored;
+    }
+    return name == "doctorId"       ? CycleField::kDoctorId
+           : name == "maxCycleDays" ? CycleField::kMaxCycleDays
+                                    : CycleField::kIgnored;
+  }
+
+  void RequireField(unsigned bit, const char* name) const {
+    if ((seen_ & bit) == 0) {
+      MissingKey(name);
+    }
+  }
+
+  [[noreturn]] static void MissingKey(const char* name) {
+    throw Json::out_of_range::create(403, std::string("key '") + name + "' not found", static_cast<const Json*>(nullptr));
+  }
+
+  CycleProblem& problem_;
+  std::optional<ProblemInputSax> sprint_;
+  int problem_depth_ = 0;
+  int depth_ = 0;
+  int skip_depth_ = 0;
+  std::string root_key_;
+  CycleSection section_ = CycleSection::kNone;
+  CycleField field_ = CycleField::kIgnored;
+  unsigned seen_ = 0;
+  bool has_sprints_ = false;
+};
+
+}  // namespace
+
+std::uint32_t SymbolTable::Intern(const std::string& name) {
+  const auto inserted = index_.emplace(name, size());
+  if (inserted.second) {
+    bytes_ += name;
+    offsets_.push_back(static_cast<std::uint32_t>(bytes_.size()));
+  }
+  return inserted.first->second;
+}
+
+std::optional<std::uint32_t> SymbolTable::Find(const std::string& name) const {
+  const auto it = index_.find(name);
+  if (it == index_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+ProblemView ProblemInput::View() const {
+  return ProblemView{
+      contract_version,
+      doctor_ids.names(),
+      period_ids.names(),
+      day_ids.names(),
+      {doctors.data(), doctors.size()},
+      {periods.data(), periods.size()},
+      {period_days.data(), period_days.size()},
+      {demands.data(), demands.size()},
+      {availability.data(), availability.size()},
+  };
+}
+
+ProblemInput ParseProblemInput(std::istream& input) {
+  ProblemInput problem;
+  ProblemInputSax handler(problem);
+  Json::sax_parse(input, &handler);
+  return problem;
+}
+
+ProblemInput ParseProblemInput(const std::string& input_json) {
+  ProblemInput problem;
+  ProblemInputSax handler(problem);
+  Json::sax_parse(input_json, &handler);
+  return problem;
+}
+
+CycleProblem ParseCycleProblem(std::istream& input) {
+  CycleProblem problem;
+  CycleProblemSax handler(problem);
+  Json::sax_parse(input, &handler);
+  return problem;
+}
+
+CycleProblem ParseCycleProblem(const std::string& input_json) {
+  CycleProblem problem;
+  CycleProblemSax handler(problem);
+  Json::sax_parse(input_json, &handler);
   return problem;
 }
 
@@ -0,0 +1,363 @@
+#pragma once
+
+// The problem SAX handler, shared inside solver_lib by problem_input.cpp and
+// the engine server's envelope parsing; not part of the public headers.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <nlohmann/json.hpp>
+#include <scheduler/problem_input.hpp>
+
+namespace scheduler {
+namespace detail {
+
+using Json = nlohmann::json;
+
+enum class Section { kNone, kDoctors, kPeriods, kDemands, kAvailability };
+
+enum class Field {
+  kIgnored,
+  kId,
+  kMaxTotalDays,
+  kDayIds,
+  kDayId,
+  kRequiredDoctors,
+  kDoctorId,
+  kPeriodId,
+};
+
+// Bits of the fields an item still lacks when its object closes.
+constexpr unsigned kHasId = 1u << 0;
+constexpr unsigned kHasMaxTotalDays = 1u << 1;
+constexpr unsigned kHasDayIds = 1u << 2;
+constexpr unsigned kHasDayId = 1u << 3;
+constexpr unsigned kHasRequiredDoctors = 1u << 4;
+constexpr unsigned kHasDoctorId = 1u << 5;
+constexpr unsigned kHasPeriodId = 1u << 6;
+
+// Single-pass SAX handler that fills ProblemInput straight from parser events,
+// interning ids as they stream by. Nesting levels it tracks: 1 = root object,
+// 2 = a section array, 3 = one item, 4 = a period's dayIds. Unknown keys are
+// skipped whatever their shape. Structural mismatches throw the same
+// nlohmann exception kinds the DOM accessors (`at`, `get`) used to raise.
+class ProblemInputSax {
+ public:
+  explicit ProblemInputSax(ProblemInput& problem) : problem_(problem) {}
+
+  // The DOM parser iterated null like an empty array, for sections and dayIds.
+  bool null() {
+    if (skip_depth_ == 0 && !Skippable() &&
+        ((depth_ == 1 && RootSection() != Section::kNone) || (depth_ == 3 && field_ == Field::kDayIds))) {
+      return start_array(0) && end_array();
+    }
+    return Scalar(std::nullopt, "null");
+  }
+  bool boolean(bool value) { return Scalar(static_cast<int>(value), "boolean"); }
+  bool number_integer(Json::number_integer_t value) { return Scalar(static_cast<int>(value), "number"); }
+  bool number_unsigned(Json::number_unsigned_t value) { return Scalar(static_cast<int>(value), "number"); }
+  bool number_float(Json::number_float_t value, const Json::string_t&) {
+    return Scalar(static_cast<int>(value), "number");
+  }
+  bool binary(Json::binary_t&) { return Scalar(std::nullopt, "binary"); }
+
+  bool string(Json::string_t& value) {
+    if (skip_depth_ > 0) {
+      return true;
+    }
+    if (depth_ == 4) {
+      problem_.period_days.push_back(problem_.day_ids.Intern(value));
+      return true;
+    }
+    if (depth_ == 1) {
+      if (root_key_ == "contractVersion") {
+        problem_.contract_version = value;
+        return true;
+      }
+      return Scalar(std::nullopt, "string");
+    }
+    if (depth_ != 3) {
+      return Scalar(std::nullopt, "string");
+    }
+
+    switch (field_) {
+      case Field::kId:
+        if (section_ == Section::kDoctors) {
+          doctor_.id = problem_.doctor_ids.Intern(value);
+        } else {
+          period_.id = problem_.period_ids.Intern(value);
+        }
+        seen_ |= kHasId;
+        return true;
+      case Field::kDayId:
+        if (section_ == Section::kDemands) {
+          demand_.day_id = problem_.day_ids.Intern(value);
+        } else {
+          availability_.day_id = problem_.day_ids.Intern(value);
+        }
+        seen_ |= kHasDayId;
+        return true;
+      case Field::kDoctorId:
+        availability_.doctor_id = problem_.doctor_ids.Intern(value);
+        seen_ |= kHasDoctorId;
+        return true;
+      case Field::kPeriodId:
+        availability_.period_id = problem_.period_ids.Intern(value);
+        seen_ |= kHasPeriodId;
+        return true;
+      case Field::kIgnored:
+        return true;
+      default:
+        Mismatch("string");
+    }
+  }
+
+  bool start_object(std::size_t) {
+    if (skip_depth_ > 0 || Skippable()) {
+      ++skip_depth_;
+      return true;
+    }
+    if (depth_ == 0) {
+      depth_ = 1;
+      return true;
+    }
+    if (depth_ == 2) {
+      depth_ = 3;
+      seen_ = 0;
+      return true;
+    }
+    Mismatch("object");
+  }
+
+  bool end_object() {
+    if (skip_depth_ > 0) {
+      --skip_depth_;
+      return true;
+    }
+    if (depth_ == 3) {
+      FinishItem();
+      depth_ = 2;
+      return true;
+    }
+    depth_ = 0;
+    RequireSection(Section::kDoctors, "doctors");
+    RequireSection(Section::kPeriods, "periods");
+    RequireSection(Section::kDemands, "demands");
+    RequireSection(Section::kAvailability, "availability");
+    return true;
+  }
+
+  bool start_array(std::size_t) {
+    if (skip_depth_ > 0 || Skippable()) {
+      ++skip_depth_;
+      return true;
+    }
+    if (depth_ == 1 && RootSection() != Section::kNone) {
+      section_ = RootSection();
+      sections_seen_ |= 1u << static_cast<unsigned>(section_);
+      ClearSection();
+      depth_ = 2;
+      return true;
+    }
+    if (depth_ == 3 && field_ == Field::kDayIds) {
+      period_.first_day = static_cast<std::uint32_t>(problem_.period_days.size());
+      seen_ |= kHasDayIds;
+      depth_ = 4;
+      return true;
+    }
+    Mismatch("array");
+  }
+
+  bool end_array() {
+    if (skip_depth_ > 0) {
+      --skip_depth_;
+      return true;
+    }
+    if (depth_ == 4) {
+      period_.day_count = static_cast<std::uint32_t>(problem_.period_days.size()) - period_.first_day;
+      depth_ = 3;
+    } else {
+      section_ = Section::kNone;
+      depth_ = 1;
+    }
+    return true;
+  }
+
+  bool key(Json::string_t& value) {
+    if (skip_depth_ > 0) {
+      return true;
+    }
+    if (depth_ == 1) {
+      root_key_ = value;
+    } else {
+      field_ = FieldFor(value);
+    }
+    return true;
+  }
+
+  template <class Exception>
+  bool parse_error(std::size_t, const std::string&, const Exception& error) {
+    throw error;
+  }
+
+ private:
+  bool Scalar(std::optional<int> number, const char* type_name) {
+    if (skip_depth_ > 0 || Skippable()) {
+      return true;
+    }
+    if (depth_ == 3 && number && (field_ == Field::kMaxTotalDays || field_ == Field::kRequiredDoctors)) {
+      if (field_ == Field::kMaxTotalDays) {
+        doctor_.max_total_days = *number;
+        seen_ |= kHasMaxTotalDays;
+      } else {
+        demand_.required_doctors = *number;
+        seen_ |= kHasRequiredDoctors;
+      }
+      return true;
+    }
+    Mismatch(type_name);
+  }
+
+  // Values the DOM parser never looked at: unknown root keys and unknown
+  // item fields.
+  bool Skippable() const {
+    if (depth_ == 1) {
+      return RootSection() == Section::kNone;
+    }
+    return depth_ == 3 && field_ == Field::kIgnored;
+  }
+
+  [[noreturn]] void Mismatch(const char* type_name) const {
+    const char* expected = "object";
+    if (depth_ == 1) {
+      expected = "array";
+    } else if (depth_ == 3) {
+      expected = (field_ == Field::kMaxTotalDays || field_ == Field::kRequiredDoctors) ? "number"
+                 : field_ == Field::kDayIds                                            ? "array"
+                                                                                       : "string";
+    } else if (depth_ == 4) {
+      expected = "string";
+    }
+    throw Json::type_error::create(
+        302, std::string("type must be ") + expected + ", but is " + type_name, static_cast<const Json*>(nullptr));
+  }
+
+  Section RootSection() const {
+    if (root_key_ == "doctors") {
+      return Section::kDoctors;
+    }
+    if (root_key_ == "periods") {
+      return Section::kPeriods;
+    }
+    if (root_key_ == "demands") {
+      return Section::kDemands;
+    }
+    if (root_key_ == "availability") {
+      return Section::kAvailability;
+    }
+    return Section::kNone;
+  }
+
+  Field FieldFor(const std::string& name) const {
+    switch (section_) {
+      case Section::kDoctors:
+        return name == "id" ? Field::kId : name == "maxTotalDays" ? Field::kMaxTotalDays : Field::kIgnored;
+      case Section::kPeriods:
+        return name == "id" ? Field::kId : name == "dayIds" ? Field::kDayIds : Field::kIgnored;
+      case Section::kDemands:
+        return name == "dayId" ? Field::kDayId : name == "requiredDoctors" ? Field::kRequiredDoctors : Field::kIgnored;
+      case Section::kAvailability:
+        return name == "doctorId"   ? Field::kDoctorId
+               : name == "periodId" ? Field::kPeriodId
+               : name == "dayId"    ? Field::kDayId
+                                    : Field::kIgnored;
+      case Section::kNone:
+        break;
+    }
+    return Field::kIgnored;
+  }
+
+  // A repeated root key replaces the earlier section, as the DOM did.
+  void ClearSection() {
+    switch (section_) {
+      case Section::kDoctors:
+        problem_.doctors.clear();
+        break;
+      case Section::kPeriods:
+        problem_.periods.clear();
+        problem_.period_days.clear();
+        break;
+      case Section::kDemands:
+        problem_.demands.clear();
+        break;
+      case Section::kAvailability:
+        problem_.availability.clear();
+        break;
+      case Section::kNone:
+        break;
+    }
+  }
+
+  void RequireSection(Section section, const char* name) const {
+    if ((sections_seen_ & (1u << static_cast<unsigned>(section))) == 0) {
+      MissingKey(name);
+    }
+  }
+
+  void RequireField(unsigned bit, const char* name) const {
+    if ((seen_ & bit) == 0) {
+      MissingKey(name);
+    }
+  }
+
+  [[noreturn]] static void MissingKey(const char* name) {
+    throw Json::out_of_range::create(403, std::string("key '") + name + "' not found", static_cast<const Json*>(nullptr));
+  }
+
+  void FinishItem() {
+    switch (section_) {
+      case Section::kDoctors:
+        RequireField(kHasId, "id");
+        RequireField(kHasMaxTotalDays, "maxTotalDays");
+        problem_.doctors.push_back(doctor_);
+        break;
+      case Section::kPeriods:
+        RequireField(kHasId, "id");
+        RequireField(kHasDayIds, "dayIds");
+        problem_.periods.push_back(period_);
+        break;
+      case Section::kDemands:
+        RequireField(kHasDayId, "dayId");
+        RequireField(kHasRequiredDoctors, "requiredDoctors");
+        problem_.demands.push_back(demand_);
+        break;
+      case Section::kAvailability:
+        RequireField(kHasDoctorId, "doctorId");
+        RequireField(kHasPeriodId, "periodId");
+        RequireField(kHasDayId, "dayId");
+        problem_.availability.push_back(availability_);
+        break;
+      case Section::kNone:
+        break;
+    }
+  }
+
+  ProblemInput& problem_;
+  int depth_ = 0;
+  int skip_depth_ = 0;
+  std::string root_key_;
+  Section section_ = Section::kNone;
+  unsigned sections_seen_ = 0;
+  Field field_ = Field::kIgnored;
+  unsigned seen_ = 0;
+
+  Doctor doctor_;
+  Period period_;
+  Demand demand_;
+  Availability availability_;
+};
+
+}  // namespace detail
+}  // namespace scheduler
@@ -0,0 +1,229 @@
+#include <scheduler/flow_network.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace scheduler {
+
+namespace {
+
+constexpr int kStopCheckInterval = 256;
+
+}  // namespace
+
+// Two-phase highest-label push-relabel with the gap and global relabeling
+// heuristics. Labels below node_count are exact-or-lower distances to the
+// sink. The first phase only discharges nodes below node_count: a node lifted
+// to node_count or above can no longer reach the sink, so it keeps its excess
+// and the buckets never hold labels past node_count. Once no such node is
+// active, excess[sink] is the maximum flow and ReturnExcess sends what the
+// lifted nodes hold back to the source, so the result is a flow (not a
+// preflow) on exit. A stop is polled every kStopCheckInterval discharges and
+// ends the first phase early; the same repair then applies.
+template <bool kCount>
+int FlowNetwork::PushRelabel(int source, int sink, MaxFlowStats& stats, const StopCondition* stop) {
+  const int node_count = node_count_;
+  const int max_label = 2 * node_count;
+
+  std::vector<int> label(node_count, 0);
+  std::vector<int> excess(node_count, 0);
+  std::vector<int> current_arc(node_count, 0);
+  std::vector<std::vector<int>> active(node_count);
+  int highest_active = -1;
+
+  std::vector<int> layer_head(node_count, -1);
+  std::vector<int> layer_next(node_count, -1);
+  std::vector<int> layer_prev(node_count, -1);
+  int highest_layer = -1;
+
+  std::vector<int> bfs_queue(node_count);
+
+  auto activate = [&](int node) {
+    if (node == source || node == sink || label[node] >= node_count) {
+      return;
+    }
+    active[label[node]].push_back(node);
+    highest_active = std::max(highest_active, label[node]);
+  };
+
+  auto layer_insert = [&](int node) {
+    const int height = label[node];
+    layer_prev[node] = -1;
+    layer_next[node] = layer_head[height];
+    if (layer_head[height] != -1) {
+      layer_prev[layer_head[height]] = node;
+    }
+    layer_head[height] = node;
+    highest_layer = std::max(highest_layer, height);
+  };
+
+  auto layer_remove = [&](int node, int height) {
+    if (layer_prev[node] != -1) {
+      layer_next[layer_prev[node]] = layer_next[node];
+    } else {
+      layer_head[height] = layer_next[node];
+    }
+    if (layer_next[node] != -1) {
+      layer_prev[layer_next[node]] = layer_prev[node];
+    }
+  };
+
+  auto reverse_bfs = [&](int root) {
+    int queue_head = 0;
+    int queue_tail = 0;
+    bfs_queue[queue_tail++] = root;
+    while (queue_head < queue_tail) {
+      const int current = bfs_queue[queue_head++];
+      if constexpr (kCount) {
+        stats.arcs_scanned += first_arc_[current + 1] - first_arc_[current];
+      }
+      for (int arc = first_arc_[current]; arc < first_arc_[current + 1]; ++arc) {
+        const int previous = head_[arc];
+        if (label[previous] != max_label || residual_[reverse_[arc]] <= 0) {
+          continue;
+        }
+        label[previous] = label[current] + 1;
+        bfs_queue[queue_tail++] = previous;
+      }
+    }
+  };
+
+  auto global_relabel = [&]() {
+    if constexpr (kCount) {
+      ++stats.phases;
+    }
+    std::fill(label.begin(), label.end(), max_label);
+    label[sink] = 0;
+    label[source] = node_count;
+    reverse_bfs(sink);
+
+    std::fill(layer_head.begin(), layer_head.end(), -1);
+    highest_layer = -1;
+    for (auto& bucket : active) {
+      bucket.clear();
+    }
+    highest_active = -1;
+    std::copy(first_arc_.begin(), first_arc_.end() - 1, current_arc.begin());
+
+    for (int node = 0; node < node_count; ++node) {
+      if (label[node] < node_count) {
+        layer_insert(node);
+      }
+      if (excess[node] > 0) {
+        activate(node);
+      }
+    }
+  };
+
+  auto relabel = [&](int node) {
+    if constexpr (kCount) {
+      ++stats.relabels;
+      stats.arcs_scanned += first_arc_[node + 1] - first_arc_[node];
+    }
+    const int old_label = label[node];
+    int new_label = max_label;
+    for (int arc = first_arc_[node]; arc < first_arc_[node + 1]; ++arc) {
+      if (residual_[arc] > 0) {
+        new_label = std::min(new_label, label[head_[arc]] + 1);
+      }
+    }
+    current_arc[node] = first_arc_[node];
+
+    if (old_label < node_count) {
+      layer_remove(node, old_label);
+      if (layer_head[old_label] == -1) {
+        // Gap: nothing above old_label can reach the sink any more.
+        for (int height = old_label + 1; height <= highest_layer; ++height) {
+          for (int lifted = layer_head[height]; lifted != -1; lifted = layer_next[lifted]) {
+            label[lifted] = node_count + 1;
+            current_arc[lifted] = first_arc_[lifted];
+          }
+          layer_head[height] = -1;
+        }
+        highest_layer = old_label - 1;
+        new_label = std::max(new_label, node_count + 1);
+      }
+    }
+
+    label[node] = new_label;
+    if (new_label < node_count) {
+      layer_insert(node);
+    }
+  };
+
+  for (int arc = first_arc_[source]; arc < first_arc_[source + 1]; ++arc) {
+    if (residual_[arc] > 0) {
+      excess[head_[arc]] += residual_[arc];
+      Push(arc, residual_[arc]);
+    }
+  }
+
+  global_relabel();
+  int relabels_since_global = 0;
+  int discharges = 0;
+
+  while (true) {
+    if (stop && ++discharges == kStopCheckInterval) {
+      discharges = 0;
+      if (stop->ShouldStop()) {
+        break;
+      }
+    }
+    while (highest_active >= 0 && active[highest_active].empty()) {
+      --highest_active;
+    }
+    if (highest_active < 0) {
+      break;
+    }
+
+    const int node = active[highest_active].back();
+    active[highest_active].pop_back();
+    if (label[node] != highest_active || excess[node] == 0) {
+      continue;
+    }
+
+    while (excess[node] > 0) {
+      const int arc = current_arc[node];
+      if (arc == first_arc_[node + 1]) {
+        relabel(node);
+        ++relabels_since_global;
+        if (label[node] >= node_count) {
+          break;
+        }
+        continue;
+      }
+
+      const int next = head_[arc];
+      if constexpr (kCount) {
+        ++stats.arcs_scanned;
+      }
+      if (residual_[arc] > 0 && label[node] == label[next] + 1) {
+        if constexpr (kCount) {
+          ++stats.augmentations;
+        }
+        const int amount = std::min(excess[node], residual_[arc]);
+        if (excess[next] == 0) {
+          activate(next);
+        }
+        Push(arc, amount);
+        excess[node] -= amount;
+        excess[next] += amount;
+      } else {
+        ++current_arc[node];
+      }
+    }
+
+    if (relabels_since_global >= node_count) {
+      global_relabel();
+      relabels_since_global = 0;
+    }
+  }
+
+  const int max_flow = excess[sink];
+  ReturnExcess(source, sink, excess);
+  return max_flow;
+}
+
+template int FlowNetwork::PushRelabel<false>(int, int, MaxFlowStats&, const StopCondition*);
+template int FlowNetwork::PushRelabel<true>(int, int, MaxFlowStats&, const StopCondition*);
+
+}  // namespace scheduler
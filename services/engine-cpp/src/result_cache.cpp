@@ -0,0 +1,373 @@
+#include <scheduler/result_cache.hpp>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <scheduler/solve_result_json.hpp>
+
+namespace scheduler {
+
+namespace {
+
+constexpr std::uint64_t kHighSeed = 0x9e3779b97f4a7c15ULL;
+constexpr std::uint64_t kLowSeed = 0xc2b2ae3d27d4eb4fULL;
+
+// Record tags keep equal fields of different kinds apart.
+enum HashTag : std::uint64_t {
+  kDoctorName = 1,
+  kPeriodName,
+  kDayName,
+  kDoctorRecord,
+  kPeriodRecord,
+  kDemandRecord,
+  kAvailabilityRecord,
+  kProblemRecord,
+  kOptionsRecord,
+};
+
+// splitmix64 finalizer.
+std::uint64_t Mix(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+// Order-independent sum of element hashes.
+struct MultisetHash {
+  std::uint64_t high = 0;
+  std::uint64_t low = 0;
+  std::uint64_t count = 0;
+
+  void Add(const ProblemHash& hash) {
+    high += hash.high;
+    low += hash.low;
+    ++count;
+  }
+};
+
+// Two differently seeded lanes absorbing 64-bit words.
+class Hasher {
+ public:
+  explicit Hasher(std::uint64_t tag) : high_(Mix(tag ^ kHighSeed)), low_(Mix(tag ^ kLowSeed)) {}
+
+  Hasher& Add(std::uint64_t word) {
+    high_ = Mix(high_ ^ word);
+    low_ = Mix((low_ + word) ^ kLowSeed);
+    return *this;
+  }
+  Hasher& AddSigned(std::int64_t value) { return Add(static_cast<std::uint64_t>(value)); }
+  Hasher& Add(std::string_view bytes) {
+    Add(bytes.size());
+    std::size_t offset = 0;
+    for (; offset + 8 <= bytes.size(); offset += 8) {
+      std::uint64_t word = 0;
+      std::memcpy(&word, bytes.data() + offset, 8);
+      Add(word);
+    }
+    if (offset < bytes.size()) {
+      std::uint64_t word = 0;
+      std::memcpy(&word, bytes.data() + offset, bytes.size() - offset);
+      Add(word);
+    }
+    return *this;
+  }
+  Hasher& Add(const ProblemHash& hash) { return Add(hash.high).Add(hash.low); }
+  Hasher& Add(const MultisetHash& hash) { return Add(hash.count).Add(hash.high).Add(hash.low); }
+
+  ProblemHash Finish() const { return ProblemHash{Mix(high_ + kLowSeed), Mix(low_ + kHighSeed)}; }
+
+ private:
+  std::uint64_t high_;
+  std::uint64_t low_;
+};
+
+// Hash of every symbol's name, so records combine two words per id instead of
+// rehashing strings.
+std::vector<ProblemHash> NameHashes(const SymbolNames& names, HashTag tag) {
+  std::vector<ProblemHash> hashes(names.size());
+  for (std::uint32_t symbol = 0; symbol < names.size(); ++symbol) {
+    hashes[symbol] = Hasher(tag).Add(names.Name(symbol)).Finish();
+  }
+  return hashes;
+}
+
+// Name -> first position (doctors) or symbol (periods, days).
+using NameIndex = std::unordered_map<std::string_view, std::uint32_t>;
+
+NameIndex IndexNames(const SymbolNames& names) {
+  NameIndex index;
+  index.reserve(names.size());
+  for (std::uint32_t symbol = 0; symbol < names.size(); ++symbol) {
+    index.emplace(names.Name(symbol), symbol);
+  }
+  return index;
+}
+
+std::uint32_t Lookup(const NameIndex& index, std::string_view name) {
+  const auto entry = index.find(name);
+  return entry == index.end() ? std::numeric_limits<std::uint32_t>::max() : entry->second;
+}
+
+}  // namespace
+
+std::string ProblemHash::ToHex() const {
+  char hex[33];
+  std::snprintf(hex, sizeof(hex), "%016llx%016llx", static_cast<unsigned long long>(high),
+                static_cast<unsigned long long>(low));
+  return std::string(hex, 32);
+}
+
+ProblemHash HashProblem(const ProblemView& input) {
+  const std::vector<ProblemHash> doctor_names = NameHashes(input.doctor_ids, kDoctorName);
+  const std::vector<ProblemHash> period_names = NameHashes(input.period_ids, kPeriodName);
+  const std::vector<ProblemHash> day_names = NameHashes(input.day_ids, kDayName);
+
+  MultisetHash doctors;
+  for (const Doctor& doctor : input.doctors) {
+    doctors.Add(Hasher(kDoctorRecord).Add(doctor_names[doctor.id]).AddSigned(doctor.max_total_days).Finish());
+  }
+  MultisetHash periods;
+  for (const Period& period : input.periods) {
+    MultisetHash days;
+    for (const std::uint32_t day : input.DaysOf(period)) {
+      days.Add(day_names[day]);
+    }
+    periods.Add(Hasher(kPeriodRecord).Add(period_names[period.id]).Add(days).Finish());
+  }
+  MultisetHash demands;
+  for (const Demand& demand : input.demands) {
+    demands.Add(Hasher(kDemandRecord).Add(day_names[demand.day_id]).AddSigned(demand.required_doctors).Finish());
+  }
+  MultisetHash availability;
+  for (const Availability& available : input.availability) {
+    availability.Add(Hasher(kAvailabilityRecord)
+                         .Add(doctor_names[available.doctor_id])
+                         .Add(period_names[available.period_id])
+                         .Add(day_names[available.day_id])
+                         .Finish());
+  }
+
+  return Hasher(kProblemRecord)
+      .Add(input.contract_version)
+      .Add(doctors)
+      .Add(periods)
+      .Add(demands)
+      .Add(availability)
+      .Finish();
+}
+
+ProblemHash SolveCacheKey(const ProblemView& input, const SolveOptions& options) {
+  return Hasher(kOptionsRecord)
+      .Add(kResultCacheVersion)
+      .Add(HashProblem(input))
+      .Add(options.algorithm ? static_cast<std::uint64_t>(*options.algorithm) + 1 : 0)
+      .Add(static_cast<std::uint64_t>(options.warm_start))
+      .Add(static_cast<std::uint64_t>(options.report_min_cut))
+      .Add(static_cast<std::uint64_t>(options.balance_load))
+      .Finish();
+}
+
+void ReorderCachedResult(SolveResult& result, const ProblemView& input) {
+  if (!result.assignments.empty()) {
+    NameIndex doctor_position;
+    doctor_position.reserve(input.doctors.size());
+    for (std::size_t i = 0; i < input.doctors.size(); ++i) {
+      doctor_position.emplace(input.doctor_ids.Name(input.doctors[i].id), static_cast<std::uint32_t>(i));
+    }
+    const NameIndex period_symbol = IndexNames(input.period_ids);
+    const NameIndex day_symbol = IndexNames(input.day_ids);
+
+    using SortKey = std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>;
+    std::vector<std::pair<SortKey, Assignment>> keyed;
+    keyed.reserve(result.assignments.size());
+    for (Assignment& assignment : result.assignments) {
+      const SortKey key{Lookup(doctor_position, assignment.doctor_id), Lookup(period_symbol, assignment.period_id),
+                        Lookup(day_symbol, assignment.day_id)};
+      keyed.emplace_back(key, std::move(assignment));
+    }
+    std::stable_sort(keyed.begin(), keyed.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (std::size_t i = 0; i < keyed.size(); ++i) {
+      result.assignments[i] = std::move(keyed[i].second);
+    }
+  }
+
+  if (result.uncovered_days.size() > 1) {
+    NameIndex demand_position;
+    demand_position.reserve(input.demands.size());
+    for (std::size_t i = 0; i < input.demands.size(); ++i) {
+      demand_position.emplace(input.day_ids.Name(input.demands[i].day_id), static_cast<std::uint32_t>(i));
+    }
+    std::stable_sort(result.uncovered_days.begin(), result.uncovered_days.end(),
+                     [&demand_position](const std::string& a, const std::string& b) {
+                       return Lookup(demand_position, a) < Lookup(demand_position, b);
+                     });
+  }
+}
+
+ResultCache::ResultCache(ResultCacheOptions options) : options_(std::move(options)) {
+  if (!options_.directory.empty()) {
+    std::error_code error;
+    std::filesystem::create_directories(options_.directory, error);
+  }
+}
+
+std::optional<SolveResult> ResultCache::Find(const ProblemHash& key) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto entry = index_.find(key);
+    if (entry != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, entry->second);
+      ++counters_.hits;
+      return entry->second->second;
+    }
+    if (options_.directory.empty()) {
+      ++counters_.misses;
+      return std::nullopt;
+    }
+  }
+
+  // A missing, partial or unreadable file is a miss.
+  std::optional<SolveResult> stored;
+  std::ifstream file(PathOf(key), std::ios::binary);
+  if (file) {
+    try {
+      stored = ParseSolveResult(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+    } catch (const std::exception&) {
+      stored.reset();
+    }
+  }
+
+  if (stored && options_.disk_capacity > 0) {
+    // Reads count as uses, so a hot entry outlives colder ones on disk.
+    std::error_code error;
+    std::filesystem::last_write_time(PathOf(key), std::filesystem::file_time_type::clock::now(), error);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!stored) {
+    ++counters_.misses;
+    return std::nullopt;
+  }
+  ++counters_.hits;
+  ++counters_.disk_hits;
+  InsertInMemory(key, *stored);
+  return stored;
+}
+
+void ResultCache::Insert(const ProblemHash& key, SolveResult result) {
+  result.stats.reset();
+  bool added_file = false;
+  if (!options_.directory.empty()) {
+    // Written aside and renamed, so readers never see a partial file.
+    const std::string path = PathOf(key);
+    const std::string staging = path + ".tmp." + std::to_string(::getpid()) + "." +
+                                std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+      std::ofstream file(staging, std::ios::binary | std::ios::trunc);
+      file << SerializeSolveResult(result);
+    }
+    std::error_code error;
+    added_file = !std::filesystem::exists(path, error);
+    std::filesystem::rename(staging, path, error);
+    if (error) {
+      added_file = false;
+      std::filesystem::remove(staging, error);
+    }
+  }
+
+  bool prune = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    InsertInMemory(key, std::move(result));
+    // The first file this cache adds lists the directory once; after that
+    // only a count past disk_capacity does.
+    if (added_file && options_.disk_capacity > 0) {
+      prune = !disk_entries_ || ++*disk_entries_ > options_.disk_capacity;
+    }
+  }
+  if (prune) {
+    const auto [kept, removed] = PruneDirectory();
+    std::lock_guard<std::mutex> lock(mutex_);
+    disk_entries_ = kept;
+    counters_.disk_evictions += static_cast<long long>(removed);
+  }
+}
+
+ResultCacheCounters ResultCache::counters() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return counters_;
+}
+
+std::size_t ResultCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+void ResultCache::InsertInMemory(const ProblemHash& key, SolveResult result) {
+  if (options_.capacity == 0) {
+    return;
+  }
+  const auto entry = index_.find(key);
+  if (entry != index_.end()) {
+    entry->second->second = std::move(result);
+    entries_.splice(entries_.begin(), entries_, entry->second);
+    return;
+  }
+  entries_.emplace_front(key, std::move(result));
+  index_.emplace(key, entries_.begin());
+  while (entries_.size() > options_.capacity) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+    ++counters_.evictions;
+  }
+}
+
+std::string ResultCache::PathOf(const ProblemHash& key) const {
+  return (std::filesystem::path(options_.directory) / (key.ToHex() + ".json")).string();
+}
+
+std::pair<std::size_t, std::size_t> ResultCache::PruneDirectory() const {
+  // The directory may be shared with other processes, so it is listed again
+  // rather than trusted to match disk_entries_.
+  std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> files;
+  std::error_code error;
+  for (std::filesystem::directory_iterator entry(options_.directory, error), end; !error && entry != end;
+       entry.increment(error)) {
+    if (entry->path().extension() == ".json" && entry->is_regular_file(error)) {
+      files.emplace_back(entry->last_write_time(error), entry->path());
+    }
+  }
+  if (files.size() <= options_.disk_capacity) {
+    return {files.size(), 0};
+  }
+
+  const std::size_t excess = files.size() - options_.disk_capacity;
+  std::partial_sort(files.begin(), files.begin() + excess, files.end());
+  std::size_t removed = 0;
+  for (std::size_t i = 0; i < excess; ++i) {
+    if (std::filesystem::remove(files[i].second, error)) {
+      ++removed;
+    }
+  }
+  return {files.size() - removed, removed};
+}
+
+}  // namespace scheduler
@@ -0,0 +1,309 @@
+#include <scheduler/scheduler_c.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include <scheduler/flow_network.hpp>
+#include <scheduler/problem_input.hpp>
+#include <scheduler/solver.hpp>
+
+// Entity symbols are their indices and every name is empty, so the problem is
+// a ProblemView over these arrays with no string table at all.
+struct scheduler_problem {
+  std::vector<scheduler::Doctor> doctors;
+  std::vector<scheduler::Period> periods;
+  std::vector<std::uint32_t> period_days;
+  std::vector<scheduler::Demand> demands;
+  std::vector<scheduler::Availability> availability;
+};
+
+struct scheduler_result {
+  bool is_feasible = false;
+  bool truncated = false;
+  std::vector<std::int32_t> doctors;
+  std::vector<std::int32_t> periods;
+  std::vector<std::int32_t> days;
+  std::vector<std::int32_t> uncovered_days;
+  bool has_min_cut = false;
+  std::int32_t min_cut_value = 0;
+  // Indexed by scheduler_min_cut_list, pairs flattened.
+  std::array<std::vector<std::int32_t>, 7> min_cut_lists;
+};
+
+namespace {
+
+bool InRange(std::int32_t index, std::size_t size) {
+  return index >= 0 && static_cast<std::size_t>(index) < size;
+}
+
+// 1 for lists of single indices, 2 for lists of pairs.
+std::size_t MinCutListWidth(scheduler_min_cut_list list) {
+  return list == SCHEDULER_MIN_CUT_REACHABLE_DOCTORS || list == SCHEDULER_MIN_CUT_REACHABLE_DAYS ? 1 : 2;
+}
+
+const std::vector<std::int32_t>* MinCutList(const scheduler_result* result, scheduler_min_cut_list list) {
+  if (!result || list < SCHEDULER_MIN_CUT_REACHABLE_DOCTORS || list > SCHEDULER_MIN_CUT_UNCOVERABLE_DAYS) {
+    return nullptr;
+  }
+  return &result->min_cut_lists[list];
+}
+
+template <typename First, typename Second>
+void AppendPairs(const std::vector<std::pair<First, Second>>& pairs, std::vector<std::int32_t>& out) {
+  out.reserve(2 * pairs.size());
+  for (const auto& [first, second] : pairs) {
+    out.push_back(static_cast<std::int32_t>(first));
+    out.push_back(static_cast<std::int32_t>(second));
+  }
+}
+
+void CopyMinCut(const scheduler::MinCutRefs& cut, scheduler_result& output) {
+  auto& lists = output.min_cut_lists;
+  output.has_min_cut = true;
+  output.min_cut_value = cut.value;
+  lists[SCHEDULER_MIN_CUT_REACHABLE_DOCTORS].assign(cut.reachable_doctors.begin(), cut.reachable_doctors.end());
+  AppendPairs(cut.reachable_doctor_periods, lists[SCHEDULER_MIN_CUT_REACHABLE_DOCTOR_PERIODS]);
+  lists[SCHEDULER_MIN_CUT_REACHABLE_DAYS].assign(cut.reachable_days.begin(), cut.reachable_days.end());
+  AppendPairs(cut.capped_doctors, lists[SCHEDULER_MIN_CUT_CAPPED_DOCTORS]);
+  AppendPairs(cut.period_limits, lists[SCHEDULER_MIN_CUT_PERIOD_LIMITS]);
+  AppendPairs(cut.cut_days, lists[SCHEDULER_MIN_CUT_CUT_DAYS]);
+  AppendPairs(cut.uncoverable_days, lists[SCHEDULER_MIN_CUT_UNCOVERABLE_DAYS]);
+}
+
+scheduler::SolveOptions ToSolveOptions(const scheduler_solve_options& options) {
+  scheduler::SolveOptions solve_options;
+  switch (options.algorithm) {
+    case SCHEDULER_ALGORITHM_EDMONDS_KARP:
+      solve_options.algorithm = scheduler::MaxFlowAlgorithm::kEdmondsKarp;
+      break;
+    case SCHEDULER_ALGORITHM_DINIC:
+      solve_options.algorithm = scheduler::MaxFlowAlgorithm::kDinic;
+      break;
+    case SCHEDULER_ALGORITHM_PUSH_RELABEL:
+      solve_options.algorithm = scheduler::MaxFlowAlgorithm::kPushRelabel;
+      break;
+    case SCHEDULER_ALGORITHM_PARALLEL_PUSH_RELABEL:
+      solve_options.algorithm = scheduler::MaxFlowAlgorithm::kParallelPushRelabel;
+      break;
+    default:
+      break;
+  }
+  solve_options.threads = options.threads;
+  if (options.time_budget_ms > 0) {
+    solve_options.time_budget = std::chrono::milliseconds(options.time_budget_ms);
+  }
+  solve_options.warm_start = options.warm_start != 0;
+  solve_options.index_results = true;
+  return solve_options;
+}
+
+}  // namespace
+
+extern "C" {
+
+int32_t scheduler_abi_version(void) {
+  return SCHEDULER_C_ABI_VERSION;
+}
+
+const char* scheduler_status_message(scheduler_status status) {
+  switch (status) {
+    case SCHEDULER_OK:
+      return "ok";
+    case SCHEDULER_INVALID_ARGUMENT:
+      return "invalid argument";
+    case SCHEDULER_SOLVE_FAILED:
+      return "solve failed";
+  }
+  return "unknown status";
+}
+
+scheduler_problem* scheduler_problem_create(void) {
+  return new (std::nothrow) scheduler_problem();
+}
+
+void scheduler_problem_free(scheduler_problem* problem) {
+  delete problem;
+}
+
+int32_t scheduler_problem_add_doctor(scheduler_problem* problem, int32_t max_total_days) {
+  if (!problem) {
+    return -1;
+  }
+  try {
+    const auto index = static_cast<std::uint32_t>(problem->doctors.size());
+    problem->doctors.push_back(scheduler::Doctor{index, max_total_days});
+    return static_cast<int32_t>(index);
+  } catch (...) {
+    return -1;
+  }
+}
+
+int32_t scheduler_problem_add_day(scheduler_problem* problem, int32_t required_doctors) {
+  if (!problem) {
+    return -1;
+  }
+  try {
+    const auto index = static_cast<std::uint32_t>(problem->demands.size());
+    problem->demands.push_back(scheduler::Demand{index, required_doctors});
+    return static_cast<int32_t>(index);
+  } catch (...) {
+    return -1;
+  }
+}
+
+int32_t scheduler_problem_add_period(scheduler_problem* problem, const int32_t* days, size_t day_count) {
+  if (!problem || (!days && day_count > 0)) {
+    return -1;
+  }
+  for (size_t i = 0; i < day_count; ++i) {
+    if (!InRange(days[i], problem->demands.size())) {
+      return -1;
+    }
+  }
+  try {
+    const auto index = static_cast<std::uint32_t>(problem->periods.size());
+    problem->periods.push_back(scheduler::Period{index, static_cast<std::uint32_t>(problem->period_days.size()),
+                                                 static_cast<std::uint32_t>(day_count)});
+    problem->period_days.insert(problem->period_days.end(), days, days + day_count);
+    return static_cast<int32_t>(index);
+  } catch (...) {
+    return -1;
+  }
+}
+
+scheduler_status scheduler_problem_add_availability(scheduler_problem* problem,
+                                                    int32_t doctor,
+                                                    int32_t period,
+                                                    int32_t day) {
+  if (!problem || !InRange(doctor, problem->doctors.size()) || !InRange(period, problem->periods.size()) ||
+      !InRange(day, problem->demands.size())) {
+    return SCHEDULER_INVALID_ARGUMENT;
+  }
+  try {
+    problem->availability.push_back(scheduler::Availability{
+        static_cast<std::uint32_t>(doctor), static_cast<std::uint32_t>(period), static_cast<std::uint32_t>(day)});
+    return SCHEDULER_OK;
+  } catch (...) {
+    return SCHEDULER_SOLVE_FAILED;
+  }
+}
+
+void scheduler_solve_options_init(scheduler_solve_options* options) {
+  if (options) {
+    *options = scheduler_solve_options{SCHEDULER_ALGORITHM_AUTO, 1, 0, 1};
+  }
+}
+
+scheduler_status scheduler_solve(const scheduler_problem* problem,
+                                 const scheduler_solve_options* options,
+                                 scheduler_result** result) {
+  if (!result) {
+    return SCHEDULER_INVALID_ARGUMENT;
+  }
+  *result = nullptr;
+  if (!problem) {
+    return SCHEDULER_INVALID_ARGUMENT;
+  }
+
+  try {
+    scheduler_solve_options defaults;
+    scheduler_solve_options_init(&defaults);
+    const scheduler::SolveOptions solve_options = ToSolveOptions(options ? *options : defaults);
+
+    const std::vector<std::uint32_t> doctor_names(problem->doctors.size() + 1, 0);
+    const std::vector<std::uint32_t> period_names(problem->periods.size() + 1, 0);
+    const std::vector<std::uint32_t> day_names(problem->demands.size() + 1, 0);
+    const scheduler::ProblemView view{
+        "1.0",
+        {{doctor_names.data(), doctor_names.size()}, ""},
+        {{period_names.data(), period_names.size()}, ""},
+        {{day_names.data(), day_names.size()}, ""},
+        {problem->doctors.data(), problem->doctors.size()},
+        {problem->periods.data(), problem->periods.size()},
+        {problem->period_days.data(), problem->period_days.size()},
+        {problem->demands.data(), problem->demands.size()},
+        {problem->availability.data(), problem->availability.size()},
+    };
+    const scheduler::SolveResult solved = scheduler::Solve(view, solve_options);
+
+    auto* output = new scheduler_result();
+    output->is_feasible = solved.is_feasible;
+    output->truncated = solved.truncated;
+    const std::size_t count = solved.assignment_refs.size();
+    output->doctors.reserve(count);
+    output->periods.reserve(count);
+    output->days.reserve(count);
+    for (const scheduler::AssignmentRef& ref : solved.assignment_refs) {
+      output->doctors.push_back(ref.doctor);
+      output->periods.push_back(static_cast<int32_t>(ref.period_id));
+      output->days.push_back(static_cast<int32_t>(ref.day_id));
+    }
+    output->uncovered_days.assign(solved.uncovered_demands.begin(), solved.uncovered_demands.end());
+    if (solved.min_cut_refs) {
+      CopyMinCut(*solved.min_cut_refs, *output);
+    }
+    *result = output;
+    return SCHEDULER_OK;
+  } catch (...) {
+    return SCHEDULER_SOLVE_FAILED;
+  }
+}
+
+int32_t scheduler_result_is_feasible(const scheduler_result* result) {
+  return result && result->is_feasible ? 1 : 0;
+}
+
+int32_t scheduler_result_is_truncated(const scheduler_result* result) {
+  return result && result->truncated ? 1 : 0;
+}
+
+size_t scheduler_result_assignment_count(const scheduler_result* result) {
+  return result ? result->doctors.size() : 0;
+}
+
+const int32_t* scheduler_result_assignment_doctors(const scheduler_result* result) {
+  return result ? result->doctors.data() : nullptr;
+}
+
+const int32_t* scheduler_result_assignment_periods(const scheduler_result* result) {
+  return result ? result->periods.data() : nullptr;
+}
+
+const int32_t* scheduler_result_assignment_days(const scheduler_result* result) {
+  return result ? result->days.data() : nullptr;
+}
+
+size_t scheduler_result_uncovered_day_count(const scheduler_result* result) {
+  return result ? result->uncovered_days.size() : 0;
+}
+
+const int32_t* scheduler_result_uncovered_days(const scheduler_result* result) {
+  return result ? result->uncovered_days.data() : nullptr;
+}
+
+int32_t scheduler_result_has_min_cut(const scheduler_result* result) {
+  return result && result->has_min_cut ? 1 : 0;
+}
+
+int32_t scheduler_result_min_cut_value(const scheduler_result* result) {
+  return result ? result->min_cut_value : 0;
+}
+
+size_t scheduler_result_min_cut_count(const scheduler_result* result, scheduler_min_cut_list list) {
+  const std::vector<std::int32_t>* entries = MinCutList(result, list);
+  return entries ? entries->size() / MinCutListWidth(list) : 0;
+}
+
+const int32_t* scheduler_result_min_cut_entries(const scheduler_result* result, scheduler_min_cut_list list) {
+  const std::vector<std::int32_t>* entries = MinCutList(result, list);
+  return entries ? entries->data() : nullptr;
+}
+
+void scheduler_result_free(scheduler_result* result) {
+  delete result;
+}
+
+}  // extern "C"
@@ -0,0 +1,177 @@
+#include <scheduler/solve_result_json.hpp>
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <scheduler/cycle_solver.hpp>
+#include <scheduler/incremental_solver.hpp>
+
+namespace scheduler {
+
+namespace {
+
+nlohmann::json SolveResultJson(const SolveResult& result) {
+  const auto serialize_start = std::chrono::steady_clock::now();
+  nlohmann::json output;
+  output["contractVersion"] = result.contract_version;
+  output["isFeasible"] = result.is_feasible;
+  output["assignedCount"] = result.assigned_count;
+  output["uncoveredDays"] = result.uncovered_days;
+
+  output["assignments"] = nlohmann::json::array();
+  for (const auto& assignment : result.assignments) {
+    output["assignments"].push_back(
+        {
+            {"doctorId", assignment.doctor_id},
+            {"dayId", assignment.day_id},
+            {"periodId", assignment.period_id},
+        });
+  }
+
+  if (result.min_cut) {
+    const MinCutReport& min_cut = *result.min_cut;
+    nlohmann::json cut_edges = nlohmann::json::array();
+    for (const MinCutEdge& edge : min_cut.cut_edges) {
+      cut_edges.push_back({{"from", edge.from}, {"to", edge.to}, {"capacity", edge.capacity}});
+    }
+    nlohmann::json capped_doctors = nlohmann::json::array();
+    for (const CappedDoctor& doctor : min_cut.capped_doctors) {
+      capped_doctors.push_back({{"doctorId", doctor.doctor_id}, {"cap", doctor.cap}});
+    }
+    nlohmann::json period_limits = nlohmann::json::array();
+    for (const PeriodLimit& limit : min_cut.period_limits) {
+      period_limits.push_back({{"doctorId", limit.doctor_id}, {"periodId", limit.period_id}});
+    }
+    nlohmann::json uncoverable_days = nlohmann::json::array();
+    for (const UncoverableDay& day : min_cut.uncoverable_days) {
+      uncoverable_days.push_back({{"dayId", day.day_id}, {"requiredDoctors", day.required_doctors}});
+    }
+    output["minCut"] = {
+        {"value", min_cut.value},
+        {"reachableNodes", min_cut.reachable_nodes},
+        {"cutEdges", std::move(cut_edges)},
+        {"bottlenecks",
+         {
+             {"cappedDoctors", std::move(capped_doctors)},
+             {"periodLimits", std::move(period_limits)},
+             {"uncoverableDays", std::move(uncoverable_days)},
+         }},
+    };
+  }
+
+  if (result.truncated) {
+    output["truncated"] = true;
+  }
+
+  if (result.stats) {
+    const SolveStats& stats = *result.stats;
+    // Covers building the JSON document; the final dump is not included.
+    const double serialize_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - serialize_start).count();
+    output["stats"] = {
+        {"phasesMs",
+         {
+             {"parse", stats.parse_ms},
+             {"build", stats.build_ms},
+             {"maxFlow", stats.max_flow_ms},
+             {"extract", stats.extract_ms},
+             {"serialize", serialize_ms},
+         }},
+        {"network", {{"components", stats.components}, {"nodes", stats.nodes}, {"arcs", stats.arcs}}},
+        {"maxFlow",
+         {
+             {"phases", stats.max_flow.phases},
+             {"augmentations", stats.max_flow.augmentations},
+             {"relabels", stats.max_flow.relabels},
+             {"arcsScanned", stats.max_flow.arcs_scanned},
+             {"warmStartFlow", stats.max_flow.warm_start_flow},
+         }},
+        {"peakRssKb", stats.peak_rss_kb},
+    };
+  }
+
+  return output;
+}
+
+}  // namespace
+
+std::string SerializeSolveResult(const SolveResult& result) {
+  return SolveResultJson(result).dump();
+}
+
+std::string SerializeCriticalityReport(const CriticalityReport& report) {
+  nlohmann::json output;
+  output["isFeasible"] = report.is_feasible;
+  output["assignedCount"] = report.assigned_count;
+  output["criticalDoctors"] = report.critical_doctors;
+  if (!report.coverage_loss.empty()) {
+    output["coverageLoss"] = nlohmann::json::array();
+    for (const DoctorCoverageLoss& loss : report.coverage_loss) {
+      output["coverageLoss"].push_back({{"doctorId", loss.doctor_id}, {"lostDays", loss.lost_days}});
+    }
+  }
+  return output.dump();
+}
+
+std::string SerializeCycleSolveResult(const CycleSolveResult& result) {
+  nlohmann::json output;
+  output["contractVersion"] = result.contract_version;
+  output["isFeasible"] = result.is_feasible;
+  output["assignedCount"] = result.assigned_count;
+  output["sprints"] = nlohmann::json::array();
+  for (const CycleSprintResult& sprint : result.sprints) {
+    output["sprints"].push_back({{"sprintId", sprint.sprint_id}, {"result", SolveResultJson(sprint.result)}});
+  }
+  if (result.truncated) {
+    output["truncated"] = true;
+  }
+  return output.dump();
+}
+
+SolveResult ParseSolveResult(const std::string& result_json) {
+  const nlohmann::json input = nlohmann::json::parse(result_json);
+  SolveResult result;
+  result.contract_version = input.at("contractVersion").get<std::string>();
+  result.is_feasible = input.at("isFeasible").get<bool>();
+  result.assigned_count = input.at("assignedCount").get<int>();
+  result.uncovered_days = input.at("uncoveredDays").get<std::vector<std::string>>();
+  for (const nlohmann::json& assignment : input.at("assignments")) {
+    result.assignments.push_back(Assignment{
+        assignment.at("doctorId").get<std::string>(),
+        assignment.at("dayId").get<std::string>(),
+        assignment.at("periodId").get<std::string>(),
+    });
+  }
+
+  if (input.contains("minCut")) {
+    const nlohmann::json& cut = input["minCut"];
+    const nlohmann::json& bottlenecks = cut.at("bottlenecks");
+    MinCutReport& min_cut = result.min_cut.emplace();
+    min_cut.value = cut.at("value").get<int>();
+    min_cut.reachable_nodes = cut.at("reachableNodes").get<std::vector<std::string>>();
+    for (const nlohmann::json& edge : cut.at("cutEdges")) {
+      min_cut.cut_edges.push_back(MinCutEdge{
+          edge.at("from").get<std::string>(), edge.at("to").get<std::string>(), edge.at("capacity").get<int>()});
+    }
+    for (const nlohmann::json& doctor : bottlenecks.at("cappedDoctors")) {
+      min_cut.capped_doctors.push_back(
+          CappedDoctor{doctor.at("doctorId").get<std::string>(), doctor.at("cap").get<int>()});
+    }
+    for (const nlohmann::json& limit : bottlenecks.at("periodLimits")) {
+      min_cut.period_limits.push_back(
+          PeriodLimit{limit.at("doctorId").get<std::string>(), limit.at("periodId").get<std::string>()});
+    }
+    for (const nlohmann::json& day : bottlenecks.at("uncoverableDays")) {
+      min_cut.uncoverable_days.push_back(
+          UncoverableDay{day.at("dayId").get<std::string>(), day.at("requiredDoctors").get<int>()});
+    }
+  }
+
+  result.truncated = input.value("truncated", false);
+  return result;
+}
+
+}  // namespace scheduler
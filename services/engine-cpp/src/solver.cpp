@@ -1,44 +1,292 @@
 #include <scheduler/solver.hpp>
 
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
 #include <exception>
+#include <functional>
+#include <istream>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <scheduler/assignment_extractor.hpp>
+#include <scheduler/balanced_max_flow.hpp>
 #include <scheduler/graph_builder.hpp>
+#include <scheduler/greedy_warm_start.hpp>
+#include <scheduler/layered_max_flow.hpp>
+#include <scheduler/min_cut_report.hpp>
+#include <scheduler/problem_binary.hpp>
 #include <scheduler/problem_input.hpp>
+#include <scheduler/result_cache.hpp>
+#include <scheduler/thread_pool.hpp>
+
+#include "solver_internal.hpp"
 
 namespace scheduler {
 
-SolveResult Solve(const std::string& input_json) {
-  SolveResult fallback{false, 0, {}, {}, "1.0"};
+int SolveMaxFlow(GraphBuildResult& graph, const SolveOptions& options, MaxFlowStats* stats, const StopCondition* stop) {
+  if (options.balance_load) {
+    return BalancedMaxFlow(graph, stats, stop);
+  }
+  const bool layered = MatchesFlowLayers(graph.network, graph.layers);
+  int seeded = 0;
+  if (options.warm_start && layered) {
+    seeded = GreedyWarmStart(graph.network, graph.layers);
+    if (stats) {
+      stats->warm_start_flow += seeded;
+    }
+  }
+  if (options.algorithm) {
+    return seeded + graph.network.MaxFlow(graph.source, graph.sink, *options.algorithm, options.threads, stats, stop);
+  }
+  if (layered) {
+    return seeded + LayeredMaxFlow(graph.network, graph.layers, stats, stop);
+  }
+  return seeded + graph.network.MaxFlow(graph.source, graph.sink, MaxFlowAlgorithm::kDinic, 1, stats, stop);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
 
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+long PeakRssKb() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+SolveResult SolveProblem(const ProblemView& input, const SolveOptions& options, const StopCondition& stop);
+
+// SolveProblem behind SolveOptions::result_cache.
+SolveResult SolveCached(const ProblemView& input, const SolveOptions& options, const StopCondition& stop) {
+  ResultCache* cache = options.index_results ? nullptr : options.result_cache;
+  if (!cache) {
+    return SolveProblem(input, options, stop);
+  }
+
+  const ProblemHash key = SolveCacheKey(input, options);
+  if (std::optional<SolveResult> cached = cache->Find(key)) {
+    ReorderCachedResult(*cached, input);
+    if (options.collect_stats) {
+      cached->stats.emplace();
+      cached->stats->peak_rss_kb = PeakRssKb();
+    }
+    return std::move(*cached);
+  }
+  SolveResult result = SolveProblem(input, options, stop);
+  if (!result.truncated) {
+    cache->Insert(key, result);
+  }
+  return result;
+}
+
+}  // namespace
+
+SolveResult InvalidInputResult(const SolveOptions& options, Clock::time_point parse_start) {
+  SolveResult result;
+  result.contract_version = "1.0";
+  if (options.collect_stats) {
+    result.stats.emplace();
+    result.stats->parse_ms = MillisecondsSince(parse_start);
+    result.stats->peak_rss_kb = PeakRssKb();
+  }
+  return result;
+}
+
+StopCondition MakeStopCondition(const SolveOptions& options, Clock::time_point start) {
+  std::optional<Clock::time_point> deadline;
+  if (options.time_budget) {
+    deadline = start + *options.time_budget;
+  }
+  return StopCondition(deadline, options.cancellation);
+}
+
+SolveResult SolveParsed(const ProblemView& input, const SolveOptions& options, Clock::time_point parse_start) {
+  const double parse_ms = options.collect_stats ? MillisecondsSince(parse_start) : 0;
+  const StopCondition stop = MakeStopCondition(options, parse_start);
+  SolveResult result = SolveCached(input, options, stop);
+  if (result.stats) {
+    result.stats->parse_ms = parse_ms;
+  }
+  return result;
+}
+
+namespace {
+
+template <typename Source>
+SolveResult SolveFrom(Source& source, const SolveOptions& options) {
+  const Clock::time_point parse_start = Clock::now();
   ProblemInput input;
   try {
-    input = ParseProblemInput(input_json);
+    input = ParseProblemInput(source);
   } catch (const std::exception&) {
-    return fallback;
+    return InvalidInputResult(options, parse_start);
   }
+  return SolveParsed(input.View(), options, parse_start);
+}
 
-  fallback.contract_version = input.contract_version;
+SolveResult SolveProblem(const ProblemView& input, const SolveOptions& options, const StopCondition& stop) {
+  const StopCondition* engine_stop = EngineStop(options, stop);
+  std::optional<SolveStats> stats;
+  if (options.collect_stats) {
+    stats.emplace();
+  }
+  Clock::time_point phase_start = Clock::now();
 
-  if (input.demands.empty() || input.doctors.empty()) {
+  if (HasNothingToSolve(input)) {
+    SolveResult fallback;
+    fallback.contract_version = std::string(input.contract_version);
+    if (stats) {
+      stats->peak_rss_kb = PeakRssKb();
+      fallback.stats = stats;
+    }
     return fallback;
   }
 
-  GraphBuildResult graph = BuildFlowGraph(input);
-  const int max_flow = graph.network.MaxFlow(graph.source, graph.sink);
+  std::vector<GraphBuildResult> graphs = BuildComponentGraphs(input);
+  const int component_count = static_cast<int>(graphs.size());
+  if (stats) {
+    stats->build_ms = MillisecondsSince(phase_start);
+    stats->components = component_count;
+    for (const GraphBuildResult& graph : graphs) {
+      stats->nodes += graph.network.node_count();
+      stats->arcs += graph.network.arc_count();
+    }
+    phase_start = Clock::now();
+  }
 
-  const ExtractionResult extraction =
-      ExtractAssignmentsAndCoverage(graph.network, graph.assignment_edges, graph.day_edges);
+  std::vector<int> flows(component_count, 0);
+  // One slot per component so parallel engines never share counters.
+  std::vector<MaxFlowStats> component_stats(stats ? component_count : 0);
+  const auto stats_of = [&component_stats](int c) { return component_stats.empty() ? nullptr : &component_stats[c]; };
+  const int threads =
+      std::min(options.threads <= 0 ? ThreadPool::DefaultThreadCount() : options.threads, component_count);
+  if (component_count == 1) {
+    flows[0] = SolveMaxFlow(graphs[0], options, stats_of(0), engine_stop);
+  } else if (threads <= 1) {
+    for (int c = 0; c < component_count; ++c) {
+      flows[c] = SolveMaxFlow(graphs[c], options, stats_of(c), engine_stop);
+    }
+  } else {
+    // The thread budget goes to components; each engine runs single-threaded.
+    // A component that throws (bad_alloc) surfaces from Wait() to the caller.
+    SolveOptions component_options = options;
+    component_options.threads = 1;
+    ThreadPool pool(threads);
+    for (int c = 0; c < component_count; ++c) {
+      pool.Submit([&graphs, &flows, &component_options, &stats_of, engine_stop, c] {
+        flows[c] = SolveMaxFlow(graphs[c], component_options, stats_of(c), engine_stop);
+      });
+    }
+    pool.Wait();
+  }
 
+  int max_flow = 0;
+  int total_demand = 0;
+  for (int c = 0; c < component_count; ++c) {
+    max_flow += flows[c];
+    total_demand += graphs[c].total_demand;
+  }
+  if (stats) {
+    stats->max_flow_ms = MillisecondsSince(phase_start);
+    for (const MaxFlowStats& component : component_stats) {
+      stats->max_flow += component;
+    }
+    phase_start = Clock::now();
+  }
   SolveResult result;
-  result.is_feasible = (max_flow == graph.total_demand);
-  result.contract_version = input.contract_version;
-  result.assignments = extraction.assignments;
-  result.uncovered_days = extraction.uncovered_days;
-  result.assigned_count = static_cast<int>(result.assignments.size());
+  result.is_feasible = (max_flow == total_demand);
+  result.truncated = IsTruncated(stop, max_flow, total_demand);
+  result.contract_version = std::string(input.contract_version);
+  if (options.index_results) {
+    ExtractionRefs refs = ExtractAssignmentRefs(graphs);
+    result.assignment_refs = std::move(refs.assignments);
+    result.uncovered_demands = std::move(refs.uncovered_demands);
+    result.assigned_count = static_cast<int>(result.assignment_refs.size());
+  } else {
+    ExtractionResult extraction = ExtractAssignmentsAndCoverage(graphs, input);
+    result.assignments = std::move(extraction.assignments);
+    result.uncovered_days = std::move(extraction.uncovered_days);
+    result.assigned_count = static_cast<int>(result.assignments.size());
+  }
+  // A truncated flow is not maximum, so its residual cut would not be minimum.
+  if (options.report_min_cut && !result.is_feasible && !result.truncated) {
+    if (options.index_results) {
+      result.min_cut_refs = BuildMinCutRefs(graphs);
+    } else {
+      result.min_cut = BuildMinCutReport(graphs, input);
+    }
+  }
+  if (stats) {
+    stats->extract_ms = MillisecondsSince(phase_start);
+    stats->peak_rss_kb = PeakRssKb();
+    result.stats = stats;
+  }
 
   return result;
 }
 
+}  // namespace
+
+SolveResult Solve(const ProblemView& input, const SolveOptions& options) {
+  const StopCondition stop = MakeStopCondition(options, Clock::now());
+  return SolveCached(input, options, stop);
+}
+
+SolveResult Solve(const std::string& input_json, const SolveOptions& options) {
+  return SolveFrom(input_json, options);
+}
+
+SolveResult Solve(std::istream& input, const SolveOptions& options) {
+  return SolveFrom(input, options);
+}
+
+SolveResult SolveBinary(const char* data, std::size_t size, const SolveOptions& options) {
+  const Clock::time_point parse_start = Clock::now();
+  ProblemView input;
+  try {
+    input = DecodeProblemBinary(data, size);
+  } catch (const std::exception&) {
+    return InvalidInputResult(options, parse_start);
+  }
+  return SolveParsed(input, options, parse_start);
+}
+
+std::vector<BatchSolveItem> SolveEach(std::size_t count, const std::function<SolveResult(std::size_t)>& solve) {
+  std::vector<BatchSolveItem> items(count);
+  if (count == 0) {
+    return items;
+  }
+
+  ThreadPool pool(std::min(ThreadPool::DefaultThreadCount(), static_cast<int>(count)));
+  for (std::size_t i = 0; i < count; ++i) {
+    pool.Submit([&solve, &items, i] {
+      BatchSolveItem& item = items[i];
+      try {
+        item.result = solve(i);
+        item.ok = true;
+      } catch (const std::exception& error) {
+        item.error = error.what();
+      } catch (...) {
+        item.error = "Unknown solver failure";
+      }
+    });
+  }
+  pool.Wait();
+
+  return items;
+}
+
+std::vector<BatchSolveItem> SolveBatch(const std::vector<std::string>& input_jsons, const SolveOptions& options) {
+  return SolveEach(input_jsons.size(),
+                   [&input_jsons, &options](std::size_t i) { return Solve(input_jsons[i], options); });
+}
+
 }  // namespace scheduler
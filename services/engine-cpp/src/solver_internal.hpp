@@ -0,0 +1,47 @@
+#pragma once
+
+// Solve plumbing shared inside solver_lib (cycle solver, engine server); not
+// part of the public headers.
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include <scheduler/flow_network.hpp>
+#include <scheduler/problem_input.hpp>
+#include <scheduler/solver.hpp>
+
+namespace scheduler {
+
+// The budget starts when the public entry point is called.
+StopCondition MakeStopCondition(const SolveOptions& options, StopCondition::Clock::time_point start);
+
+// Engines skip polling entirely when there is nothing to wait for.
+inline const StopCondition* EngineStop(const SolveOptions& options, const StopCondition& stop) {
+  return (options.time_budget || options.cancellation) ? &stop : nullptr;
+}
+
+// A flow that already covers every demand is maximum however it stopped.
+inline bool IsTruncated(const StopCondition& stop, int max_flow, int total_demand) {
+  return stop.Fired() && max_flow < total_demand;
+}
+
+// Solve has nothing to route without doctors or demands and reports neither
+// assignments nor uncovered days.
+inline bool HasNothingToSolve(const ProblemView& input) {
+  return input.demands.empty() || input.doctors.empty();
+}
+
+// What Solve returns for a problem that fails to parse or decode.
+SolveResult InvalidInputResult(const SolveOptions& options, StopCondition::Clock::time_point parse_start);
+
+// Solves an already parsed problem; the budget and parse_ms count from parse_start.
+SolveResult SolveParsed(const ProblemView& input,
+                        const SolveOptions& options,
+                        StopCondition::Clock::time_point parse_start);
+
+// Runs solve(0) .. solve(count - 1) on a thread pool; each item keeps its
+// result or the message of what it threw, in index order.
+std::vector<BatchSolveItem> SolveEach(std::size_t count, const std::function<SolveResult(std::size_t)>& solve);
+
+}  // namespace scheduler
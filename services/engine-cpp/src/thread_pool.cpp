@@ -0,0 +1,154 @@
+#include <scheduler/thread_pool.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace scheduler {
+
+namespace {
+
+constexpr std::chrono::milliseconds kIdlePollInterval(50);
+
+struct WorkerIdentity {
+  const ThreadPool* pool = nullptr;
+  int index = -1;
+};
+
+thread_local WorkerIdentity current_worker;
+
+// Sleeps in bounded slices so idle threads re-check their predicate even if a
+// notification races with the wait.
+template <typename Predicate>
+void WaitUntil(std::condition_variable& condition, std::unique_lock<std::mutex>& lock, Predicate ready) {
+  while (!condition.wait_for(lock, kIdlePollInterval, ready)) {
+  }
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(int thread_count) {
+  const int count = thread_count > 0 ? thread_count : DefaultThreadCount();
+  queues_.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    queues_.push_back(std::make_unique<WorkerQueue>());
+  }
+  workers_.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    workers_.emplace_back([this, i] { WorkerLoop(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  WaitIdle();
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stopping_ = true;
+  }
+  task_available_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+int ThreadPool::DefaultThreadCount() {
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  const unsigned queue_count = static_cast<unsigned>(queues_.size());
+  const int target = current_worker.pool == this
+                         ? current_worker.index
+                         : static_cast<int>(next_queue_.fetch_add(1, std::memory_order_relaxed) % queue_count);
+
+  pending_.fetch_add(1, std::memory_order_acq_rel);
+  {
+    std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+    queues_[target]->tasks.push_back(std::move(task));
+  }
+  queued_.fetch_add(1, std::memory_order_acq_rel);
+  {
+    // Pairs with the predicate check in WorkerLoop so the notify is not lost.
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+  }
+  task_available_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  WaitIdle();
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    std::swap(error, first_error_);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void ThreadPool::WaitIdle() {
+  std::unique_lock<std::mutex> lock(sleep_mutex_);
+  WaitUntil(idle_, lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+}
+
+bool ThreadPool::TryRunOne(int worker_index) {
+  std::function<void()> task;
+  const int queue_count = static_cast<int>(queues_.size());
+
+  {
+    WorkerQueue& own = *queues_[worker_index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+    }
+  }
+
+  for (int offset = 1; !task && offset < queue_count; ++offset) {
+    WorkerQueue& victim = *queues_[(worker_index + offset) % queue_count];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+    }
+  }
+
+  if (!task) {
+    return false;
+  }
+  queued_.fetch_sub(1, std::memory_order_acq_rel);
+
+  try {
+    task();
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    if (!first_error_) {
+      first_error_ = std::current_exception();
+    }
+  }
+
+  if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    idle_.notify_all();
+  }
+  return true;
+}
+
+void ThreadPool::WorkerLoop(int worker_index) {
+  current_worker = WorkerIdentity{this, worker_index};
+
+  while (true) {
+    if (TryRunOne(worker_index)) {
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    task_available_.wait_for(
+        lock, kIdlePollInterval, [this] { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+    if (stopping_ && queued_.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+  }
+}
+
+}  // namespace scheduler
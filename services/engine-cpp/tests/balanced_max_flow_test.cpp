@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <scheduler/balanced_max_flow.hpp>
+#include <scheduler/graph_builder.hpp>
+#include <scheduler/problem_input.hpp>
+#include <scheduler/solve_result_json.hpp>
+#include <scheduler/solver.hpp>
+
+#include "test_support.hpp"
+
+namespace {
+
+using scheduler::test::RandomRoster;
+
+
+std::map<std::string, int> LoadsOf(const scheduler::SolveResult& result) {
+  std::map<std::string, int> loads;
+  for (const scheduler::Assignment& assignment : result.assignments) {
+    ++loads[assignment.doctor_id];
+  }
+  return loads;
+}
+
+long long SquaredLoads(const std::map<std::string, int>& loads) {
+  long long sum = 0;
+  for (const auto& [doctor, load] : loads) {
+    sum += static_cast<long long>(load) * load;
+  }
+  return sum;
+}
+
+int MaxLoad(const std::map<std::string, int>& loads) {
+  int max_load = 0;
+  for (const auto& [doctor, load] : loads) {
+    max_load = std::max(max_load, load);
+  }
+  return max_load;
+}
+
+// Bellman-Ford over the residual network with the convex class-arc costs: a
+// flow of minimum cost leaves no negative cycle.
+bool HasNegativeCycle(const scheduler::GraphBuildResult& graph) {
+  const scheduler::FlowNetwork& network = graph.network;
+  std::vector<int> members(network.arc_count(), 0);
+  for (int c = 0; c < graph.layers.doctor_count; ++c) {
+    const int node = graph.layers.doctor_offset + c;
+    for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+      if (network.Head(arc) < graph.layers.doctor_offset) {
+        members[network.ReverseArc(arc)] = static_cast<int>(graph.doctor_classes[c].doctors.size());
+      }
+    }
+  }
+  auto cost = [&](int arc) -> long long {
+    if (members[arc] > 0) {
+      return 2LL * (network.Flow(arc) / members[arc]) + 1;
+    }
+    const int forward = network.ReverseArc(arc);
+    if (members[forward] > 0) {
+      return -(2LL * ((network.Flow(forward) - 1) / members[forward]) + 1);
+    }
+    return 0;
+  };
+
+  std::vector<long long> distance(network.node_count(), 0);
+  for (int round = 0; round < network.node_count(); ++round) {
+    bool relaxed = false;
+    for (int node = 0; node < network.node_count(); ++node) {
+      for (int arc = network.FirstArc(node); arc < network.EndArc(node); ++arc) {
+        if (network.Residual(arc) > 0 && distance[node] + cost(arc) < distance[network.Head(arc)]) {
+          distance[network.Head(arc)] = distance[node] + cost(arc);
+          relaxed = true;
+        }
+      }
+    }
+    if (!relaxed) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST(BalancedMaxFlow, SpreadsDaysThatThePlainSolveMayStack) {
+  // doc-a and doc-b are identical and merge into one class; doc-c is the only
+  // one available on d3 and d6 and shares every other day with them.
+  const std::string request = nlohmann::json::parse(R"({
+    "contractVersion": "1.0",
+    "doctors": [{"id": "doc-c", "maxTotalDays": 6}, {"id": "doc-a", "maxTotalDays": 6},
+                {"id": "doc-b", "maxTotalDays": 6}],
+    "periods": [{"id": "p1", "dayIds": ["d1", "d2", "d3"]}, {"id": "p2", "dayIds": ["d4", "d5", "d6"]}],
+    "demands": [{"dayId": "d1", "requiredDoctors": 1}, {"dayId": "d2", "requiredDoctors": 1},
+                {"dayId": "d3", "requiredDoctors": 1}, {"dayId": "d4", "requiredDoctors": 1},
+                {"dayId": "d5", "requiredDoctors": 1}, {"dayId": "d6", "requiredDoctors": 1}],
+    "availability": [
+      {"doctorId": "doc-c", "periodId": "p1", "dayId": "d1"}, {"doctorId": "doc-c", "periodId": "p1", "dayId": "d2"},
+      {"doctorId": "doc-c", "periodId": "p1", "dayId": "d3"}, {"doctorId": "doc-c", "periodId": "p2", "dayId": "d4"},
+      {"doctorId": "doc-c", "periodId": "p2", "dayId": "d5"}, {"doctorId": "doc-c", "periodId": "p2", "dayId": "d6"},
+      {"doctorId": "doc-a", "periodId": "p1", "dayId": "d1"}, {"doctorId": "doc-a", "periodId": "p1", "dayId": "d2"},
+      {"doctorId": "doc-a", "periodId": "p2", "dayId": "d4"}, {"doctorId": "doc-a", "periodId": "p2", "dayId": "d5"},
+      {"doctorId": "doc-b", "periodId": "p1", "dayId": "d1"}, {"doctorId": "doc-b", "periodId": "p1", "dayId": "d2"},
+      {"doctorId": "doc-b", "periodId": "p2", "dayId": "d4"}, {"doctorId": "doc-b", "periodId": "p2", "dayId": "d5"}
+    ]
+  })").dump();
+
+  scheduler::SolveOptions options;
+  options.balance_load = true;
+  const scheduler::SolveResult result = scheduler::Solve(request, options);
+  ASSERT_TRUE(result.is_feasible);
+  const std::map<std::string, int> loads = LoadsOf(result);
+  EXPECT_EQ(loads.at("doc-a"), 2);
+  EXPECT_EQ(loads.at("doc-b"), 2);
+  EXPECT_EQ(loads.at("doc-c"), 2);
+
+  options.collect_stats = true;
+  const scheduler::SolveResult counted = scheduler::Solve(request, options);
+  ASSERT_TRUE(counted.stats);
+  EXPECT_GT(counted.stats->max_flow.augmentations, 0);
+  EXPECT_EQ(counted.stats->max_flow.warm_start_flow, 0);
+  EXPECT_EQ(LoadsOf(counted), loads);
+}
+
+TEST(BalancedMaxFlow, KeepsTheMaximumAndLeavesNoCheaperRoster) {
+  std::mt19937 rng(20261017);
+
+  for (int round = 0; round < 40; ++round) {
+    const int doctors = 2 + static_cast<int>(rng() % 12);
+    const int periods = 1 + static_cast<int>(rng() % 4);
+    const int days_per_period = 1 + static_cast<int>(rng() % 5);
+    const double density = 0.3 + 0.5 * (rng() % 100) / 100.0;
+    const std::string request = RandomRoster(rng, doctors, periods, days_per_period, density, 3, 8, 1);
+    const scheduler::SolveResult plain = scheduler::Solve(request);
+    scheduler::SolveOptions options;
+    options.balance_load = true;
+    const scheduler::SolveResult balanced = scheduler::Solve(request, options);
+
+    EXPECT_EQ(balanced.assigned_count, plain.assigned_count) << "round " << round;
+    EXPECT_EQ(balanced.is_feasible, plain.is_feasible) << "round " << round;
+    EXPECT_LE(SquaredLoads(LoadsOf(balanced)), SquaredLoads(LoadsOf(plain))) << "round " << round;
+    EXPECT_LE(MaxLoad(LoadsOf(balanced)), MaxLoad(LoadsOf(plain))) << "round " << round;
+    EXPECT_EQ(scheduler::SerializeSolveResult(scheduler::Solve(request, options)),
+              scheduler::SerializeSolveResult(balanced))
+        << "round " << round;
+
+    const scheduler::ProblemInput input = scheduler::ParseProblemInput(request);
+    scheduler::GraphBuildResult graph = scheduler::BuildFlowGraph(input);
+    graph.network.Finalize();
+    EXPECT_EQ(scheduler::BalancedMaxFlow(graph), plain.assigned_count) << "round " << round;
+    EXPECT_FALSE(HasNegativeCycle(graph)) << "round " << round;
+  }
+}
+
+}  // namespace
@@ -0,0 +1,276 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <scheduler/cycle_solver.hpp>
+#include <scheduler/solve_result_json.hpp>
+#include <scheduler/solver.hpp>
+
+#include "test_support.hpp"
+
+namespace {
+
+// Sprints reuse doctor, period and day ids on purpose: only doctors are
+// shared. About a quarter of the doctors sit each sprint out.
+nlohmann::json BuildSprint(std::mt19937& rng, int doctors, int periods, int days_per_period) {
+  nlohmann::json request =
+      nlohmann::json::parse(scheduler::test::RandomRoster(rng, doctors, periods, days_per_period, 0.5));
+  std::set<std::string> absent;
+  nlohmann::json present = nlohmann::json::array();
+  for (nlohmann::json& doctor : request["doctors"]) {
+    if (rng() % 4 == 0) {
+      absent.insert(doctor["id"].get<std::string>());
+    } else {
+      present.push_back(std::move(doctor));
+    }
+  }
+  request["doctors"] = std::move(present);
+  nlohmann::json availability = nlohmann::json::array();
+  for (nlohmann::json& entry : request["availability"]) {
+    if (!absent.count(entry["doctorId"].get<std::string>())) {
+      availability.push_back(std::move(entry));
+    }
+  }
+  request["availability"] = std::move(availability);
+  return request;
+}
+
+nlohmann::json BuildCycle(std::mt19937& rng, bool with_caps) {
+  const int doctors = 2 + static_cast<int>(rng() % 6);
+  const int sprints = 1 + static_cast<int>(rng() % 4);
+  nlohmann::json cycle;
+  cycle["contractVersion"] = "1.0";
+  cycle["sprints"] = nlohmann::json::array();
+  for (int s = 0; s < sprints; ++s) {
+    cycle["sprints"].push_back({{"id", "s-" + std::to_string(s)},
+                                {"problem", BuildSprint(rng, doctors, 1 + static_cast<int>(rng() % 3),
+                                                        1 + static_cast<int>(rng() % 4))}});
+  }
+  if (with_caps) {
+    cycle["doctorCaps"] = nlohmann::json::array();
+    for (int i = 0; i < doctors; ++i) {
+      if (rng() % 3 != 0) {
+        cycle["doctorCaps"].push_back(
+            {{"doctorId", "doc-" + std::to_string(i)}, {"maxCycleDays", static_cast<int>(rng() % 5)}});
+      }
+    }
+  }
+  return cycle;
+}
+
+TEST(CycleSolver, SharesADoctorCappedAcrossSprintsWhereOnlyTheyCanWork) {
+  // doc-a can work sprint-1 or sprint-2 but only one day in the cycle; only
+  // doc-a covers sprint-2, so a sprint-by-sprint solve could spend doc-a on
+  // sprint-1 and leave sprint-2 uncovered.
+  const std::string request = R"({
+    "contractVersion": "1.0",
+    "doctorCaps": [{"doctorId": "doc-a", "maxCycleDays": 1}],
+    "sprints": [
+      {"id": "sprint-1", "problem": {
+        "doctors": [{"id": "doc-a", "maxTotalDays": 1}, {"id": "doc-b", "maxTotalDays": 1}],
+        "periods": [{"id": "p", "dayIds": ["d1"]}],
+        "demands": [{"dayId": "d1", "requiredDoctors": 1}],
+        "availability": [{"doctorId": "doc-a", "periodId": "p", "dayId": "d1"},
+                         {"doctorId": "doc-b", "periodId": "p", "dayId": "d1"}]}},
+      {"id": "sprint-2", "problem": {
+        "doctors": [{"id": "doc-a", "maxTotalDays": 1}],
+        "periods": [{"id": "p", "dayIds": ["d1"]}],
+        "demands": [{"dayId": "d1", "requiredDoctors": 1}],
+        "availability": [{"doctorId": "doc-a", "periodId": "p", "dayId": "d1"}]}}
+    ]})";
+
+  const scheduler::CycleSolveResult result = scheduler::SolveCycle(scheduler::ParseCycleProblem(request));
+  EXPECT_TRUE(result.is_feasible);
+  EXPECT_EQ(result.assigned_count, 2);
+  ASSERT_EQ(result.sprints.size(), 2u);
+  EXPECT_EQ(result.sprints[0].sprint_id, "sprint-1");
+  ASSERT_EQ(result.sprints[0].result.assignments.size(), 1u);
+  EXPECT_EQ(result.sprints[0].result.assignments[0].doctor_id, "doc-b");
+  ASSERT_EQ(result.sprints[1].result.assignments.size(), 1u);
+  EXPECT_EQ(result.sprints[1].result.assignments[0].doctor_id, "doc-a");
+  EXPECT_EQ(result.sprints[1].result.assignments[0].period_id, "p");
+  EXPECT_EQ(result.sprints[1].result.assignments[0].day_id, "d1");
+
+  nlohmann::json capped = nlohmann::json::parse(request);
+  capped["doctorCaps"][0]["maxCycleDays"] = 0;
+  const scheduler::CycleSolveResult without_a = scheduler::SolveCycle(scheduler::ParseCycleProblem(capped.dump()));
+  EXPECT_FALSE(without_a.is_feasible);
+  EXPECT_TRUE(without_a.sprints[0].result.is_feasible);
+  EXPECT_FALSE(without_a.sprints[1].result.is_feasible);
+  EXPECT_EQ(without_a.sprints[1].result.uncovered_days, std::vector<std::string>{"d1"});
+
+  const nlohmann::json output = nlohmann::json::parse(scheduler::SerializeCycleSolveResult(without_a));
+  EXPECT_EQ(output["sprints"][1]["sprintId"], "sprint-2");
+  EXPECT_EQ(output["sprints"][1]["result"]["uncoveredDays"], nlohmann::json::array({"d1"}));
+  EXPECT_FALSE(output.contains("truncated"));
+}
+
+TEST(CycleSolver, ReportsASprintWithoutDoctorsTheWaySolveDoes) {
+  const std::string no_doctors = R"({
+    "contractVersion": "1.0",
+    "doctors": [],
+    "periods": [{"id": "p", "dayIds": ["d1", "d2"]}],
+    "demands": [{"dayId": "d1", "requiredDoctors": 1}, {"dayId": "d2", "requiredDoctors": 2}],
+    "availability": []})";
+  const std::string request = R"({
+    "contractVersion": "1.0",
+    "sprints": [
+      {"id": "empty", "problem": )" + no_doctors + R"(},
+      {"id": "staffed", "problem": {
+        "doctors": [{"id": "doc-a", "maxTotalDays": 1}],
+        "periods": [{"id": "p", "dayIds": ["d1", "d2"]}],
+        "demands": [{"dayId": "d1", "requiredDoctors": 1}, {"dayId": "d2", "requiredDoctors": 1}],
+        "availability": [{"doctorId": "doc-a", "periodId": "p", "dayId": "d1"}]}}
+    ]})";
+
+  const scheduler::SolveResult alone = scheduler::Solve(no_doctors);
+  const scheduler::CycleSolveResult result = scheduler::SolveCycle(scheduler::ParseCycleProblem(request));
+  ASSERT_EQ(result.sprints.size(), 2u);
+  const scheduler::SolveResult& empty = result.sprints[0].result;
+  EXPECT_FALSE(empty.is_feasible);
+  EXPECT_EQ(empty.is_feasible, alone.is_feasible);
+  EXPECT_EQ(empty.assigned_count, alone.assigned_count);
+  EXPECT_EQ(empty.uncovered_days, alone.uncovered_days);
+  // The other sprint still reports its own gaps.
+  EXPECT_EQ(result.sprints[1].result.uncovered_days, std::vector<std::string>{"d2"});
+}
+
+TEST(CycleSolver, MatchesPerSprintSolvesWithoutCapsAndHonorsCaps) {
+  std::mt19937 rng(20260601);
+  for (int round = 0; round < 60; ++round) {
+    const bool with_caps = round % 2 == 1;
+    const nlohmann::json cycle = BuildCycle(rng, with_caps);
+    const scheduler::CycleSolveResult result = scheduler::SolveCycle(scheduler::ParseCycleProblem(cycle.dump()));
+    ASSERT_EQ(result.sprints.size(), cycle["sprints"].size());
+
+    std::map<std::string, int> cycle_days;
+    int capped_total = 0;
+    int uncapped_total = 0;
+    for (std::size_t s = 0; s < result.sprints.size(); ++s) {
+      const nlohmann::json& problem = cycle["sprints"][s]["problem"];
+      const scheduler::SolveResult& sprint = result.sprints[s].result;
+      const scheduler::SolveResult alone = scheduler::Solve(problem.dump());
+      EXPECT_EQ(sprint.assigned_count, static_cast<int>(sprint.assignments.size()));
+      capped_total += sprint.assigned_count;
+      uncapped_total += alone.assigned_count;
+      if (!with_caps) {
+        EXPECT_EQ(sprint.assigned_count, alone.assigned_count);
+        EXPECT_EQ(sprint.is_feasible, alone.is_feasible);
+      }
+
+      std::set<std::tuple<std::string, std::string, std::string>> available;
+      for (const nlohmann::json& entry : problem["availability"]) {
+        available.emplace(entry["doctorId"], entry["periodId"], entry["dayId"]);
+      }
+      std::map<std::string, int> sprint_days;
+      std::set<std::pair<std::string, std::string>> doctor_periods;
+      for (const scheduler::Assignment& assignment : sprint.assignments) {
+        EXPECT_TRUE(available.count({assignment.doctor_id, assignment.period_id, assignment.day_id}));
+        EXPECT_TRUE(doctor_periods.emplace(assignment.doctor_id, assignment.period_id).second);
+        ++sprint_days[assignment.doctor_id];
+        ++cycle_days[assignment.doctor_id];
+      }
+      for (const nlohmann::json& doctor : problem["doctors"]) {
+        EXPECT_LE(sprint_days[doctor["id"]], doctor["maxTotalDays"].get<int>());
+      }
+    }
+    EXPECT_LE(capped_total, uncapped_total);
+    if (with_caps) {
+      for (const nlohmann::json& cap : cycle["doctorCaps"]) {
+        EXPECT_LE(cycle_days[cap["doctorId"]], cap["maxCycleDays"].get<int>());
+      }
+    }
+  }
+}
+
+TEST(CycleSolver, BalancesDaysPerDoctorOverTheWholeCycle) {
+  // Only doc-a covers sprint-1; evening out sprint-2 on its own would give
+  // doc-a a third day, so over the cycle doc-b takes both of sprint-2.
+  const std::string request = R"({
+    "contractVersion": "1.0",
+    "sprints": [
+      {"id": "sprint-1", "problem": {
+        "doctors": [{"id": "doc-a", "maxTotalDays": 2}, {"id": "doc-b", "maxTotalDays": 2}],
+        "periods": [{"id": "p1", "dayIds": ["d1"]}, {"id": "p2", "dayIds": ["d2"]}],
+        "demands": [{"dayId": "d1", "requiredDoctors": 1}, {"dayId": "d2", "requiredDoctors": 1}],
+        "availability": [{"doctorId": "doc-a", "periodId": "p1", "dayId": "d1"},
+                         {"doctorId": "doc-a", "periodId": "p2", "dayId": "d2"}]}},
+      {"id": "sprint-2", "problem": {
+        "doctors": [{"id": "doc-a", "maxTotalDays": 2}, {"id": "doc-b", "maxTotalDays": 2}],
+        "periods": [{"id": "p1", "dayIds": ["d1"]}, {"id": "p2", "dayIds": ["d2"]}],
+        "demands": [{"dayId": "d1", "requiredDoctors": 1}, {"dayId": "d2", "requiredDoctors": 1}],
+        "availability": [{"doctorId": "doc-a", "periodId": "p1", "dayId": "d1"},
+                         {"doctorId": "doc-a", "periodId": "p2", "dayId": "d2"},
+                         {"doctorId": "doc-b", "periodId": "p1", "dayId": "d1"},
+                         {"doctorId": "doc-b", "periodId": "p2", "dayId": "d2"}]}}
+    ]})";
+
+  scheduler::SolveOptions options;
+  options.balance_load = true;
+  const scheduler::CycleSolveResult result = scheduler::SolveCycle(scheduler::ParseCycleProblem(request), options);
+  ASSERT_TRUE(result.is_feasible);
+  std::map<std::string, int> cycle_days;
+  for (const scheduler::CycleSprintResult& sprint : result.sprints) {
+    for (const scheduler::Assignment& assignment : sprint.result.assignments) {
+      ++cycle_days[assignment.doctor_id];
+    }
+  }
+  EXPECT_EQ(cycle_days, (std::map<std::string, int>{{"doc-a", 2}, {"doc-b", 2}}));
+
+  std::mt19937 rng(20261019);
+  for (int round = 0; round < 30; ++round) {
+    const scheduler::CycleProblem cycle = scheduler::ParseCycleProblem(BuildCycle(rng, round % 2 == 1).dump());
+    EXPECT_EQ(scheduler::SolveCycle(cycle, options).assigned_count, scheduler::SolveCycle(cycle).assigned_count)
+        << "round " << round;
+  }
+}
+
+TEST(CycleSolver, RejectsCycleCapsThatAreNotWholeInts) {
+  const auto parse_with_cap = [](const std::string& cap) {
+    return scheduler::ParseCycleProblem(R"({"doctorCaps": [{"doctorId": "a", "maxCycleDays": )" + cap +
+                                        R"(}], "sprints": []})");
+  };
+  EXPECT_EQ(parse_with_cap("3").doctor_caps.at(0).max_cycle_days, 3);
+  EXPECT_EQ(parse_with_cap("4.0").doctor_caps.at(0).max_cycle_days, 4);
+  EXPECT_EQ(parse_with_cap("2147483647").doctor_caps.at(0).max_cycle_days, 2147483647);
+  EXPECT_THROW(parse_with_cap("2.7"), nlohmann::json::type_error);
+  EXPECT_THROW(parse_with_cap("2147483648"), nlohmann::json::type_error);
+  EXPECT_THROW(parse_with_cap("18446744073709551615"), nlohmann::json::type_error);
+  EXPECT_THROW(parse_with_cap("-2147483649"), nlohmann::json::type_error);
+  EXPECT_THROW(parse_with_cap("1e12"), nlohmann::json::type_error);
+  EXPECT_THROW(parse_with_cap("true"), nlohmann::json::type_error);
+  EXPECT_THROW(parse_with_cap(R"("3")"), nlohmann::json::type_error);
+}
+
+TEST(CycleSolver, StreamFormChargesParsingToTheTimeBudget) {
+  std::mt19937 rng(20261018);
+  nlohmann::json cycle;
+  cycle["contractVersion"] = "1.0";
+  cycle["sprints"] = nlohmann::json::array();
+  for (int s = 0; s < 6; ++s) {
+    cycle["sprints"].push_back({{"id", "s-" + std::to_string(s)}, {"problem", BuildSprint(rng, 300, 4, 7)}});
+  }
+  const std::string payload = cycle.dump();
+
+  scheduler::SolveOptions options;
+  options.time_budget = std::chrono::milliseconds(1);
+  std::istringstream input(payload);
+  const auto start = std::chrono::steady_clock::now();
+  const scheduler::CycleSolveResult result = scheduler::SolveCycle(input, options);
+  ASSERT_GT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1));
+  // Parsing alone used up the budget: the engine stops before its first phase.
+  EXPECT_TRUE(result.truncated);
+  EXPECT_EQ(result.assigned_count, 0);
+  ASSERT_EQ(result.sprints.size(), 6u);
+}
+
+}  // namespace
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <nlohmann/json.hpp>
+#include <scheduler/engine_server.hpp>
+#include <scheduler/thread_pool.hpp>
+
+namespace {
+
+const char* kFeasibleProblem = R"({
+  "contractVersion": "1.0",
+  "doctors": [{"id": "d1", "maxTotalDays": 1}, {"id": "d2", "maxTotalDays": 1}],
+  "periods": [{"id": "p1", "dayIds": ["day-1", "day-2"]}],
+  "demands": [{"dayId": "day-1", "requiredDoctors": 1}, {"dayId": "day-2", "requiredDoctors": 1}],
+  "availability": [
+    {"doctorId": "d1", "periodId": "p1", "dayId": "day-1"},
+    {"doctorId": "d2", "periodId": "p1", "dayId": "day-2"}
+  ]
+})";
+
+std::string Envelope(const nlohmann::json& id, const std::string& extra = "") {
+  nlohmann::json envelope = {{"id", id}, {"problem", nlohmann::json::parse(kFeasibleProblem)}};
+  if (!extra.empty()) {
+    envelope["options"] = nlohmann::json::parse(extra);
+  }
+  return envelope.dump();
+}
+
+TEST(EngineServer, AnswersWithCorrelationIdAndSolveResult) {
+  const auto response = nlohmann::json::parse(scheduler::HandleServerRequest(Envelope("req-1"), {}));
+
+  EXPECT_EQ(response.at("id"), "req-1");
+  EXPECT_EQ(response.at("status"), "ok");
+  EXPECT_TRUE(response.at("result").at("isFeasible").get<bool>());
+  EXPECT_EQ(response.at("result").at("assignedCount"), 2);
+}
+
+TEST(EngineServer, HonorsPerRequestAlgorithm) {
+  const auto response =
+      nlohmann::json::parse(scheduler::HandleServerRequest(Envelope(7, R"({"algorithm": "push-relabel"})"), {}));
+  EXPECT_EQ(response.at("status"), "ok");
+  EXPECT_EQ(response.at("result").at("assignedCount"), 2);
+
+  const auto rejected =
+      nlohmann::json::parse(scheduler::HandleServerRequest(Envelope(8, R"({"algorithm": "simplex"})"), {}));
+  EXPECT_EQ(rejected.at("id"), 8);
+  EXPECT_EQ(rejected.at("status"), "error");
+  EXPECT_EQ(rejected.at("error").at("code"), "INVALID_REQUEST");
+}
+
+TEST(EngineServer, AddsStatsOnlyWhenRequested) {
+  const auto plain = nlohmann::json::parse(scheduler::HandleServerRequest(Envelope("a"), {}));
+  EXPECT_FALSE(plain.at("result").contains("stats"));
+
+  const auto measured =
+      nlohmann::json::parse(scheduler::HandleServerRequest(Envelope("b", R"({"stats": true})"), {}));
+  ASSERT_EQ(measured.at("status"), "ok");
+  const auto& stats = measured.at("result").at("stats");
+  EXPECT_EQ(stats.at("network").at("components"), 2);
+  // Both days are seeded by the greedy warm start; the engine finds nothing left.
+  EXPECT_EQ(stats.at("maxFlow").at("warmStartFlow"), 2);
+  EXPECT_EQ(stats.at("maxFlow").at("augmentations"), 0);
+  for (const char* phase : {"parse", "build", "maxFlow", "extract", "serialize"}) {
+    EXPECT_GE(stats.at("phasesMs").at(phase).get<double>(), 0.0) << phase;
+  }
+  EXPECT_GT(stats.at("peakRssKb").get<long>(), 0);
+}
+
+TEST(EngineServer, TurnsMalformedEnvelopesIntoErrorResponses) {
+  const auto not_json = nlohmann::json::parse(scheduler::HandleServerRequest("{broken", {}));
+  EXPECT_TRUE(not_json.at("id").is_null());
+  EXPECT_EQ(not_json.at("error").at("code"), "INVALID_REQUEST");
+
+  const auto missing_problem = nlohmann::json::parse(scheduler::HandleServerRequest(R"({"id": "x"})", {}));
+  EXPECT_EQ(missing_problem.at("id"), "x");
+  EXPECT_EQ(missing_problem.at("status"), "error");
+}
+
+TEST(EngineServer, ReadsTheEnvelopeInAnyKeyOrder) {
+  const std::string problem_first = std::string(R"({"problem": )") + kFeasibleProblem +
+                                    R"(, "extra": [{"problem": 1}], "options": {"stats": true}, "id": {"n": 1}})";
+  const auto response = nlohmann::json::parse(scheduler::HandleServerRequest(problem_first, {}));
+  EXPECT_EQ(response.at("id"), nlohmann::json({{"n", 1}}));
+  EXPECT_EQ(response.at("result").at("assignedCount"), 2);
+  EXPECT_TRUE(response.at("result").contains("stats"));
+
+  // A problem object that does not parse is an infeasible result, as in Solve.
+  const auto bad_content = nlohmann::json::parse(
+      scheduler::HandleServerRequest(R"({"problem": {"doctors": "oops", "periods": [[1]]}, "id": 3})", {}));
+  EXPECT_EQ(bad_content.at("id"), 3);
+  EXPECT_EQ(bad_content.at("status"), "ok");
+  EXPECT_FALSE(bad_content.at("result").at("isFeasible").get<bool>());
+
+  for (const char* envelope : {R"({"id": 4, "problem": 5})", R"({"problem": {}, "id": 4, "problem": null})"}) {
+    const auto rejected = nlohmann::json::parse(scheduler::HandleServerRequest(envelope, {}));
+    EXPECT_EQ(rejected.at("id"), 4) << envelope;
+    EXPECT_EQ(rejected.at("error").at("code"), "INVALID_REQUEST") << envelope;
+  }
+  for (const char* envelope : {"[1]", R"("problem")", R"({"id": 5, "problem": {}} trailing)"}) {
+    const auto rejected = nlohmann::json::parse(scheduler::HandleServerRequest(envelope, {}));
+    EXPECT_TRUE(rejected.at("id").is_null()) << envelope;
+    EXPECT_EQ(rejected.at("error").at("code"), "INVALID_REQUEST") << envelope;
+  }
+}
+
+TEST(EngineServer, KeepsServingAfterBadRequests) {
+  std::stringstream input;
+  input << Envelope("a") << "\n"
+        << "not-json\n"
+        << "\n"
+        << Envelope("b") << "\n"
+        << R"({"id": "c", "problem": []})" << "\n"
+        << Envelope("d");
+
+  std::stringstream output;
+  scheduler::ServerOptions options;
+  options.worker_count = 3;
+  EXPECT_EQ(scheduler::RunServer(input, output, options), 0);
+
+  std::set<std::string> ok_ids;
+  int error_count = 0;
+  std::string line;
+  while (std::getline(output, line)) {
+    const auto response = nlohmann::json::parse(line);
+    if (response.at("status") == "ok") {
+      ok_ids.insert(response.at("id").get<std::string>());
+    } else {
+      error_count += 1;
+    }
+  }
+
+  EXPECT_EQ(ok_ids, (std::set<std::string>{"a", "b", "d"}));
+  EXPECT_EQ(error_count, 2);
+}
+
+TEST(EngineServer, BatchModeAnswersInInputOrder) {
+  std::stringstream input;
+  input << "[" << kFeasibleProblem << R"(, {"doctors": "oops"}, )" << kFeasibleProblem << R"(, [{}], null])";
+  std::stringstream output;
+
+  EXPECT_EQ(scheduler::RunBatch(input, output, {}), 0);
+
+  const auto items = nlohmann::json::parse(output.str());
+  ASSERT_EQ(items.size(), 5u);
+  EXPECT_EQ(items[0].at("result").at("assignedCount"), 2);
+  EXPECT_FALSE(items[1].at("result").at("isFeasible").get<bool>());
+  EXPECT_EQ(items[2].at("result").at("assignedCount"), 2);
+  for (std::size_t i : {3u, 4u}) {
+    EXPECT_EQ(items[i].at("status"), "ok") << i;
+    EXPECT_FALSE(items[i].at("result").at("isFeasible").get<bool>()) << i;
+  }
+
+  std::stringstream not_array(R"({"doctors": []})");
+  std::stringstream rejected;
+  EXPECT_EQ(scheduler::RunBatch(not_array, rejected, {}), 1);
+  EXPECT_EQ(nlohmann::json::parse(rejected.str()).at("status"), "error");
+
+  std::stringstream truncated("[" + std::string(kFeasibleProblem));
+  std::stringstream malformed;
+  EXPECT_EQ(scheduler::RunBatch(truncated, malformed, {}), 1);
+  EXPECT_EQ(nlohmann::json::parse(malformed.str()).at("error").at("code"), "INVALID_REQUEST");
+}
+
+TEST(ThreadPool, RunsNestedSubmissionsBeforeWaitReturns) {
+  scheduler::ThreadPool pool(4);
+  std::atomic<int> completed{0};
+
+  for (int i = 0; i < 64; ++i) {
+    pool.Submit([&pool, &completed] {
+      pool.Submit([&completed] { completed.fetch_add(1); });
+      completed.fetch_add(1);
+    });
+  }
+  pool.Wait();
+
+  EXPECT_EQ(completed.load(), 128);
+}
+
+TEST(ThreadPool, RethrowsTheFirstTaskExceptionOnWait) {
+  scheduler::ThreadPool pool(2);
+  std::atomic<int> completed{0};
+
+  for (int i = 0; i < 16; ++i) {
+    pool.Submit([&completed, i] {
+      if (i == 5) {
+        throw std::runtime_error("component failed");
+      }
+      completed.fetch_add(1);
+    });
+  }
+  EXPECT_THROW(pool.Wait(), std::runtime_error);
+  EXPECT_EQ(completed.load(), 15);
+
+  // The error is reported once; the pool keeps working.
+  pool.Submit([&completed] { completed.fetch_add(1); });
+  EXPECT_NO_THROW(pool.Wait());
+  EXPECT_EQ(completed.load(), 16);
+}
+
+}  // namespace
@@ -0,0 +1,284 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <scheduler/flow_network.hpp>
+#include <scheduler/layered_max_flow.hpp>
+
+namespace {
+
+using scheduler::FlowNetwork;
+using scheduler::MaxFlowAlgorithm;
+
+const std::vector<MaxFlowAlgorithm> kAlgorithms = {
+    MaxFlowAlgorithm::kEdmondsKarp,
+    MaxFlowAlgorithm::kDinic,
+    MaxFlowAlgorithm::kPushRelabel,
+    MaxFlowAlgorithm::kParallelPushRelabel,
+};
+
+struct RandomEdge {
+  int from;
+  int to;
+  int capacity;
+};
+
+std::vector<RandomEdge> GenerateRandomEdges(std::mt19937& rng, int node_count, int edge_count, int max_capacity) {
+  std::uniform_int_distribution<int> node_dist(0, node_count - 1);
+  std::uniform_int_distribution<int> capacity_dist(0, max_capacity);
+  std::vector<RandomEdge> edges;
+  for (int i = 0; i < edge_count; ++i) {
+    edges.push_back(RandomEdge{node_dist(rng), node_dist(rng), capacity_dist(rng)});
+  }
+  return edges;
+}
+
+void ExpectConservedFlow(const FlowNetwork& network,
+                         const std::vector<RandomEdge>& edges,
+                         const std::vector<int>& edge_ids,
+                         int node_count,
+                         int source,
+                         int sink,
+                         int max_flow) {
+  std::vector<long long> balance(node_count, 0);
+  for (std::size_t i = 0; i < edges.size(); ++i) {
+    const int flow = network.Flow(network.ForwardArc(edge_ids[i]));
+    ASSERT_GE(flow, 0);
+    ASSERT_LE(flow, edges[i].capacity);
+    balance[edges[i].from] -= flow;
+    balance[edges[i].to] += flow;
+  }
+
+  for (int node = 0; node < node_count; ++node) {
+    if (node == source) {
+      EXPECT_EQ(balance[node], -max_flow);
+    } else if (node == sink) {
+      EXPECT_EQ(balance[node], max_flow);
+    } else {
+      EXPECT_EQ(balance[node], 0) << "node " << node;
+    }
+  }
+}
+
+TEST(FlowNetwork, ParsesAlgorithmNames) {
+  for (const auto algorithm : kAlgorithms) {
+    EXPECT_EQ(scheduler::ParseMaxFlowAlgorithm(scheduler::MaxFlowAlgorithmName(algorithm)), algorithm);
+  }
+  EXPECT_FALSE(scheduler::ParseMaxFlowAlgorithm("ford-fulkerson").has_value());
+}
+
+TEST(FlowNetwork, LaysOutPairedArcsContiguouslyPerNode) {
+  FlowNetwork network(3);
+  const int first = network.AddEdge(0, 1, 4);
+  const int second = network.AddEdge(1, 2, 3);
+  const int third = network.AddEdge(0, 2, 2);
+  network.Finalize();
+
+  EXPECT_EQ(network.arc_count(), 6);
+  EXPECT_EQ(network.EndArc(0) - network.FirstArc(0), 2);
+  EXPECT_EQ(network.EndArc(1) - network.FirstArc(1), 2);
+  EXPECT_EQ(network.EndArc(2) - network.FirstArc(2), 2);
+
+  for (const int edge_id : {first, second, third}) {
+    const int arc = network.ForwardArc(edge_id);
+    EXPECT_EQ(network.ReverseArc(network.ReverseArc(arc)), arc);
+    EXPECT_EQ(network.Flow(arc), 0);
+  }
+  EXPECT_EQ(network.Head(network.ForwardArc(second)), 2);
+  EXPECT_EQ(network.Capacity(network.ForwardArc(first)), 4);
+
+  EXPECT_EQ(network.MaxFlow(0, 2), 5);
+  EXPECT_EQ(network.Flow(network.ForwardArc(second)), 3);
+  EXPECT_EQ(network.Capacity(network.ForwardArc(second)), 3);
+  EXPECT_THROW(network.AddEdge(0, 1, 1), std::logic_error);
+}
+
+TEST(FlowNetwork, AllAlgorithmsAgreeOnRandomNetworks) {
+  std::mt19937 rng(20260301);
+
+  for (int round = 0; round < 60; ++round) {
+    const int node_count = 2 + static_cast<int>(rng() % 40);
+    const int edge_count = static_cast<int>(rng() % 200);
+    const auto edges = GenerateRandomEdges(rng, node_count, edge_count, 1 + static_cast<int>(rng() % 8));
+    const int source = 0;
+    const int sink = node_count - 1;
+
+    std::vector<int> flows;
+    for (const auto algorithm : kAlgorithms) {
+      SCOPED_TRACE(scheduler::MaxFlowAlgorithmName(algorithm));
+      FlowNetwork network(node_count);
+      std::vector<int> edge_ids;
+      for (const auto& edge : edges) {
+        edge_ids.push_back(network.AddEdge(edge.from, edge.to, edge.capacity));
+      }
+
+      const int max_flow = network.MaxFlow(source, sink, algorithm);
+      ExpectConservedFlow(network, edges, edge_ids, node_count, source, sink, max_flow);
+      flows.push_back(max_flow);
+    }
+
+    for (std::size_t i = 1; i < flows.size(); ++i) {
+      EXPECT_EQ(flows[i], flows[0]) << "round " << round;
+    }
+  }
+}
+
+TEST(FlowNetwork, ParallelPushRelabelIsDeterministicAcrossThreadCounts) {
+  std::mt19937 rng(20260422);
+
+  for (int round = 0; round < 4; ++round) {
+    // Wide enough that rounds carry thousands of active nodes and get split.
+    const int node_count = 4000;
+    auto edges = GenerateRandomEdges(rng, node_count, 24000, 6);
+    for (int node = 1; node < node_count - 1; node += 2) {
+      edges.push_back(RandomEdge{0, node, 1 + static_cast<int>(rng() % 4)});
+    }
+    const int source = 0;
+    const int sink = node_count - 1;
+
+    FlowNetwork reference(node_count);
+    for (const auto& edge : edges) {
+      reference.AddEdge(edge.from, edge.to, edge.capacity);
+    }
+    const int expected = reference.MaxFlow(source, sink, MaxFlowAlgorithm::kDinic);
+
+    std::vector<int> baseline_flows;
+    for (const int threads : {1, 2, 4}) {
+      SCOPED_TRACE(threads);
+      FlowNetwork network(node_count);
+      std::vector<int> edge_ids;
+      for (const auto& edge : edges) {
+        edge_ids.push_back(network.AddEdge(edge.from, edge.to, edge.capacity));
+      }
+
+      const int max_flow = network.MaxFlow(source, sink, MaxFlowAlgorithm::kParallelPushRelabel, threads);
+      EXPECT_EQ(max_flow, expected) << "round " << round;
+      ExpectConservedFlow(network, edges, edge_ids, node_count, source, sink, max_flow);
+
+      std::vector<int> arc_flows;
+      for (const int edge_id : edge_ids) {
+        arc_flows.push_back(network.Flow(network.ForwardArc(edge_id)));
+      }
+      if (baseline_flows.empty()) {
+        baseline_flows = arc_flows;
+      } else {
+        EXPECT_EQ(arc_flows, baseline_flows) << "round " << round;
+      }
+    }
+  }
+}
+
+TEST(FlowNetwork, StoppedEnginesLeaveAValidPartialFlow) {
+  std::mt19937 rng(20260501);
+  const int node_count = 1500;
+  auto edges = GenerateRandomEdges(rng, node_count, 9000, 5);
+  // Many short source -> sink routes, so push-relabel is holding a real
+  // preflow by the time it first polls the stop.
+  for (int node = 1; node < node_count - 1; node += 3) {
+    edges.push_back(RandomEdge{0, node, 1 + static_cast<int>(rng() % 4)});
+    edges.push_back(RandomEdge{node + 1, node_count - 1, 1 + static_cast<int>(rng() % 4)});
+  }
+  const int source = 0;
+  const int sink = node_count - 1;
+
+  FlowNetwork reference(node_count);
+  for (const auto& edge : edges) {
+    reference.AddEdge(edge.from, edge.to, edge.capacity);
+  }
+  const int expected = reference.MaxFlow(source, sink, MaxFlowAlgorithm::kDinic);
+
+  scheduler::CancellationToken token;
+  token.Cancel();
+  for (const auto algorithm : kAlgorithms) {
+    SCOPED_TRACE(scheduler::MaxFlowAlgorithmName(algorithm));
+    // Where a deadline lands is timing dependent; every stopping point must
+    // still leave a conserved flow.
+    for (const int budget_us : {-1, 0, 50, 200, 1000}) {
+      SCOPED_TRACE(budget_us);
+      FlowNetwork network(node_count);
+      std::vector<int> edge_ids;
+      for (const auto& edge : edges) {
+        edge_ids.push_back(network.AddEdge(edge.from, edge.to, edge.capacity));
+      }
+
+      std::optional<scheduler::StopCondition::Clock::time_point> deadline;
+      if (budget_us >= 0) {
+        deadline = scheduler::StopCondition::Clock::now() + std::chrono::microseconds(budget_us);
+      }
+      const scheduler::StopCondition stop(deadline, budget_us < 0 ? &token : nullptr);
+      const int flow = network.MaxFlow(source, sink, algorithm, 1, nullptr, &stop);
+      EXPECT_TRUE(stop.Fired() || flow == expected);
+      EXPECT_LE(flow, expected);
+      ExpectConservedFlow(network, edges, edge_ids, node_count, source, sink, flow);
+    }
+  }
+
+  FlowNetwork unbounded(node_count);
+  for (const auto& edge : edges) {
+    unbounded.AddEdge(edge.from, edge.to, edge.capacity);
+  }
+  const scheduler::StopCondition never(std::nullopt, nullptr);
+  EXPECT_EQ(unbounded.MaxFlow(source, sink, MaxFlowAlgorithm::kPushRelabel, 1, nullptr, &never), expected);
+  EXPECT_FALSE(never.Fired());
+}
+
+TEST(FlowNetwork, DinicAndLayeredStopInsideAPhase) {
+  // 300k disjoint source -> doctor -> doctor-period -> day -> sink paths are
+  // one phase of 300k augmentations: polling only between phases would return
+  // either none or all of them.
+  const int paths = 300000;
+  scheduler::FlowLayers layers;
+  layers.source = 0;
+  layers.doctor_offset = 1;
+  layers.doctor_count = paths;
+  layers.doctor_period_offset = 1 + paths;
+  layers.doctor_period_count = paths;
+  layers.day_offset = 1 + 2 * paths;
+  layers.day_count = paths;
+  layers.sink = 1 + 3 * paths;
+  const auto build = [&] {
+    FlowNetwork network(layers.sink + 1);
+    network.ReserveEdges(4 * paths);
+    for (int i = 0; i < paths; ++i) {
+      network.AddEdge(layers.source, layers.doctor_offset + i, 1);
+      network.AddEdge(layers.doctor_offset + i, layers.doctor_period_offset + i, 1);
+      network.AddEdge(layers.doctor_period_offset + i, layers.day_offset + i, 1);
+      network.AddEdge(layers.day_offset + i, layers.sink, 1);
+    }
+    network.Finalize();
+    return network;
+  };
+
+  for (const bool layered : {false, true}) {
+    SCOPED_TRACE(layered ? "layered" : "dinic");
+    const auto run = [&](FlowNetwork& network, const scheduler::StopCondition* stop) {
+      return layered ? scheduler::LayeredMaxFlow(network, layers, nullptr, stop)
+                     : network.MaxFlow(layers.source, layers.sink, MaxFlowAlgorithm::kDinic, 1, nullptr, stop);
+    };
+    FlowNetwork unbounded = build();
+    const auto start = scheduler::StopCondition::Clock::now();
+    ASSERT_EQ(run(unbounded, nullptr), paths);
+    const auto full_run = scheduler::StopCondition::Clock::now() - start;
+
+    // Where a deadline lands is timing dependent, so try fractions of a full
+    // run until one lands inside the phase.
+    bool stopped_inside = false;
+    for (int sixteenths = 1; sixteenths < 16 && !stopped_inside; ++sixteenths) {
+      FlowNetwork network = build();
+      const scheduler::StopCondition stop(scheduler::StopCondition::Clock::now() + full_run * sixteenths / 16,
+                                          nullptr);
+      const int flow = run(network, &stop);
+      int sink_flow = 0;
+      for (int arc = network.FirstArc(layers.sink); arc < network.EndArc(layers.sink); ++arc) {
+        sink_flow += network.Residual(arc);
+      }
+      EXPECT_EQ(sink_flow, flow);
+      stopped_inside = flow > 0 && flow < paths;
+    }
+    EXPECT_TRUE(stopped_inside);
+  }
+}
+
+}  // namespace
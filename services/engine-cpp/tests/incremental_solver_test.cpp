@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <scheduler/incremental_solver.hpp>
+#include <scheduler/solver.hpp>
+
+#include "test_support.hpp"
+
+namespace {
+
+using scheduler::test::RandomRoster;
+
+void ExpectConsistentAssignments(const nlohmann::json& request, const scheduler::SolveResult& result) {
+  std::set<std::tuple<std::string, std::string, std::string>> available;
+  for (const auto& item : request["availability"]) {
+    available.emplace(item["doctorId"], item["periodId"], item["dayId"]);
+  }
+  std::map<std::string, int> doctor_load;
+  std::map<std::string, int> day_load;
+  std::set<std::pair<std::string, std::string>> doctor_periods;
+  for (const auto& assignment : result.assignments) {
+    EXPECT_EQ(available.count({assignment.doctor_id, assignment.period_id, assignment.day_id}), 1u);
+    EXPECT_TRUE(doctor_periods.emplace(assignment.doctor_id, assignment.period_id).second);
+    ++doctor_load[assignment.doctor_id];
+    ++day_load[assignment.day_id];
+  }
+  for (const auto& doctor : request["doctors"]) {
+    EXPECT_LE(doctor_load[doctor["id"]], doctor["maxTotalDays"].get<int>());
+  }
+  std::set<std::string> uncovered;
+  for (const auto& demand : request["demands"]) {
+    EXPECT_LE(day_load[demand["dayId"]], demand["requiredDoctors"].get<int>());
+    if (day_load[demand["dayId"]] < demand["requiredDoctors"].get<int>()) {
+      uncovered.insert(demand["dayId"].get<std::string>());
+    }
+  }
+  EXPECT_EQ(std::set<std::string>(result.uncovered_days.begin(), result.uncovered_days.end()), uncovered);
+}
+
+}  // namespace
+
+TEST(IncrementalSolver, InitialSolveMatchesFullSolve) {
+  std::mt19937 rng(20260411);
+  const nlohmann::json request = nlohmann::json::parse(RandomRoster(rng, 8, 3, 4, 0.4));
+  const auto expected = scheduler::Solve(request.dump());
+
+  const auto solver = scheduler::IncrementalSolver::FromJson(request.dump());
+  const auto result = solver.Result();
+
+  EXPECT_EQ(result.is_feasible, expected.is_feasible);
+  EXPECT_EQ(result.assigned_count, expected.assigned_count);
+}
+
+TEST(IncrementalSolver, RandomEditsMatchFullResolve) {
+  std::mt19937 rng(20260412);
+
+  for (int round = 0; round < 25; ++round) {
+    const int doctors = 3 + static_cast<int>(rng() % 8);
+    const int periods = 1 + static_cast<int>(rng() % 3);
+    const int days_per_period = 1 + static_cast<int>(rng() % 4);
+    nlohmann::json request = nlohmann::json::parse(RandomRoster(rng, doctors, periods, days_per_period, 0.4));
+
+    scheduler::SolveOptions options;
+    if (round % 2 == 1) {
+      options.algorithm = scheduler::MaxFlowAlgorithm::kPushRelabel;
+    }
+    auto solver = scheduler::IncrementalSolver::FromJson(request.dump(), options);
+
+    for (int step = 0; step < 40; ++step) {
+      const std::string doctor_id = "doc-" + std::to_string(rng() % doctors);
+      const int period = static_cast<int>(rng() % periods);
+      const std::string period_id = "p-" + std::to_string(period);
+      const std::string day_id = "day-" + std::to_string(period) + "-" + std::to_string(rng() % days_per_period);
+
+      scheduler::SolveResult result;
+      switch (rng() % 4) {
+        case 0: {
+          request["availability"].push_back({{"doctorId", doctor_id}, {"periodId", period_id}, {"dayId", day_id}});
+          result = solver.AddAvailability(doctor_id, period_id, day_id);
+          break;
+        }
+        case 1: {
+          nlohmann::json kept = nlohmann::json::array();
+          for (const auto& item : request["availability"]) {
+            if (item["doctorId"] != doctor_id || item["periodId"] != period_id || item["dayId"] != day_id) {
+              kept.push_back(item);
+            }
+          }
+          request["availability"] = kept;
+          result = solver.RemoveAvailability(doctor_id, period_id, day_id);
+          break;
+        }
+        case 2: {
+          const int max_total_days = static_cast<int>(rng() % 5);
+          for (auto& doctor : request["doctors"]) {
+            if (doctor["id"] == doctor_id) {
+              doctor["maxTotalDays"] = max_total_days;
+            }
+          }
+          result = solver.SetMaxTotalDays(doctor_id, max_total_days);
+          break;
+        }
+        default: {
+          const int required = static_cast<int>(rng() % 4);
+          for (auto& demand : request["demands"]) {
+            if (demand["dayId"] == day_id) {
+              demand["requiredDoctors"] = required;
+            }
+          }
+          result = solver.SetRequiredDoctors(day_id, required);
+          break;
+        }
+      }
+
+      const auto expected = scheduler::Solve(request.dump());
+      ASSERT_EQ(result.assigned_count, expected.assigned_count) << "round " << round << " step " << step;
+      ASSERT_EQ(result.is_feasible, expected.is_feasible) << "round " << round << " step " << step;
+      EXPECT_EQ(solver.flow_value(), result.assigned_count);
+      ExpectConsistentAssignments(request, result);
+    }
+  }
+}
+
+TEST(IncrementalSolver, CriticalityMatchesResolvingWithoutEachDoctor) {
+  std::mt19937 rng(20260413);
+
+  for (int round = 0; round < 40; ++round) {
+    const int doctors = 3 + static_cast<int>(rng() % 8);
+    const double density = 0.2 + 0.6 * (rng() % 100) / 100.0;
+    const int periods = 1 + static_cast<int>(rng() % 3);
+    const int days_per_period = 1 + static_cast<int>(rng() % 4);
+    const nlohmann::json request = nlohmann::json::parse(RandomRoster(rng, doctors, periods, days_per_period, density));
+    auto solver = scheduler::IncrementalSolver::FromJson(request.dump());
+    const int flow = solver.flow_value();
+
+    const auto report = solver.AnalyzeDoctorCriticality(true);
+    const auto critical_only = solver.AnalyzeDoctorCriticality();
+    EXPECT_EQ(critical_only.critical_doctors, report.critical_doctors) << "round " << round;
+    EXPECT_TRUE(critical_only.coverage_loss.empty());
+    EXPECT_EQ(report.assigned_count, flow);
+    EXPECT_EQ(solver.flow_value(), flow) << "round " << round;
+    ExpectConsistentAssignments(request, solver.Result());
+
+    ASSERT_EQ(report.coverage_loss.size(), static_cast<std::size_t>(doctors));
+    std::vector<std::string> expected_critical;
+    for (int i = 0; i < doctors; ++i) {
+      nlohmann::json without = request;
+      without["doctors"][i]["maxTotalDays"] = 0;
+      const int lost = flow - scheduler::Solve(without.dump()).assigned_count;
+      EXPECT_EQ(report.coverage_loss[i].doctor_id, request["doctors"][i]["id"]);
+      EXPECT_EQ(report.coverage_loss[i].lost_days, lost) << "round " << round << " doctor " << i;
+      if (lost > 0) {
+        expected_critical.push_back(request["doctors"][i]["id"]);
+      }
+    }
+    EXPECT_EQ(report.critical_doctors, expected_critical) << "round " << round;
+  }
+}
+
+TEST(IncrementalSolver, IgnoresEditsOutsideTheProblem) {
+  std::mt19937 rng(20260413);
+  const nlohmann::json request = nlohmann::json::parse(RandomRoster(rng, 4, 2, 2, 0.5));
+  auto solver = scheduler::IncrementalSolver::FromJson(request.dump());
+  const auto before = solver.Result();
+
+  solver.AddAvailability("doc-missing", "p-0", "day-0-0");
+  solver.AddAvailability("doc-0", "p-0", "day-1-0");
+  solver.SetMaxTotalDays("doc-missing", 3);
+  const auto after = solver.SetRequiredDoctors("day-missing", 2);
+
+  EXPECT_EQ(after.assigned_count, before.assigned_count);
+  EXPECT_EQ(after.is_feasible, before.is_feasible);
+}
+
+TEST(IncrementalSolver, FromJsonRejectsInvalidPayload) {
+  EXPECT_ANY_THROW(scheduler::IncrementalSolver::FromJson("{invalid-json"));
+}
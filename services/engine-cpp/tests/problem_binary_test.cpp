@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include <scheduler/problem_binary.hpp>
+#include <scheduler/problem_input.hpp>
+#include <scheduler/solver.hpp>
+
+#include "test_support.hpp"
+
+namespace {
+
+using scheduler::test::RandomSmallRoster;
+using scheduler::test::ReadFixtureFile;
+
+void ExpectSameResult(const scheduler::SolveResult& actual, const scheduler::SolveResult& expected) {
+  EXPECT_EQ(actual.contract_version, expected.contract_version);
+  EXPECT_EQ(actual.is_feasible, expected.is_feasible);
+  EXPECT_EQ(actual.assigned_count, expected.assigned_count);
+  EXPECT_EQ(actual.uncovered_days, expected.uncovered_days);
+  ASSERT_EQ(actual.assignments.size(), expected.assignments.size());
+  for (std::size_t i = 0; i < actual.assignments.size(); ++i) {
+    EXPECT_EQ(actual.assignments[i].doctor_id, expected.assignments[i].doctor_id);
+    EXPECT_EQ(actual.assignments[i].day_id, expected.assignments[i].day_id);
+    EXPECT_EQ(actual.assignments[i].period_id, expected.assignments[i].period_id);
+  }
+}
+
+}  // namespace
+
+TEST(ProblemBinary, SolvesLikeJsonOnFixturesAndRandomRosters) {
+  std::vector<std::string> requests = {
+      ReadFixtureFile("happy.basic.request.json"),
+      ReadFixtureFile("edge.capacity-shortage.request.json"),
+      ReadFixtureFile("invalid.duplicate-doctor.request.json"),
+  };
+  std::mt19937 rng(20260425);
+  for (int i = 0; i < 20; ++i) {
+    requests.push_back(RandomSmallRoster(rng));
+  }
+
+  for (std::size_t i = 0; i < requests.size(); ++i) {
+    SCOPED_TRACE(i);
+    const scheduler::ProblemInput input = scheduler::ParseProblemInput(requests[i]);
+    const std::string binary = scheduler::EncodeProblemBinary(input.View());
+    ASSERT_TRUE(scheduler::IsProblemBinary(binary.data(), binary.size()));
+
+    ExpectSameResult(scheduler::SolveBinary(binary.data(), binary.size()), scheduler::Solve(requests[i]));
+
+    const std::string json = scheduler::SerializeProblemJson(scheduler::DecodeProblemBinary(binary.data(), binary.size()));
+    EXPECT_EQ(scheduler::SerializeProblemJson(scheduler::ParseProblemInput(json).View()), json);
+  }
+}
+
+TEST(ProblemBinary, RejectsCorruptBuffers) {
+  const scheduler::ProblemInput input = scheduler::ParseProblemInput(ReadFixtureFile("happy.basic.request.json"));
+  const std::string binary = scheduler::EncodeProblemBinary(input.View());
+
+  EXPECT_THROW(scheduler::DecodeProblemBinary(binary.data(), 3), std::runtime_error);
+  EXPECT_THROW(scheduler::DecodeProblemBinary(binary.data(), binary.size() - 1), std::runtime_error);
+
+  std::string wrong_version = binary;
+  wrong_version[4] = 9;
+  EXPECT_THROW(scheduler::DecodeProblemBinary(wrong_version.data(), wrong_version.size()), std::runtime_error);
+
+  std::string bad_symbol = binary;
+  scheduler::ProblemBinaryHeader header;
+  std::memcpy(&header, bad_symbol.data(), sizeof(header));
+  const std::size_t first_doctor =
+      sizeof(header) + (header.doctor_symbol_count + header.period_symbol_count + header.day_symbol_count + 2) * 4;
+  const std::uint32_t out_of_range = header.doctor_symbol_count;
+  std::memcpy(&bad_symbol[first_doctor], &out_of_range, sizeof(out_of_range));
+  EXPECT_THROW(scheduler::DecodeProblemBinary(bad_symbol.data(), bad_symbol.size()), std::runtime_error);
+
+  const auto fallback = scheduler::SolveBinary(bad_symbol.data(), bad_symbol.size());
+  EXPECT_FALSE(fallback.is_feasible);
+  EXPECT_EQ(fallback.assigned_count, 0);
+}
+
+TEST(ProblemBinary, MapsRegularFilesOnly) {
+  const scheduler::ProblemInput input = scheduler::ParseProblemInput(ReadFixtureFile("happy.basic.request.json"));
+  const std::string binary = scheduler::EncodeProblemBinary(input.View());
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  std::fwrite(binary.data(), 1, binary.size(), file);
+  std::fflush(file);
+
+  const auto mapped = scheduler::MappedFile::Map(fileno(file));
+  ASSERT_TRUE(mapped.has_value());
+  ASSERT_EQ(mapped->size(), binary.size());
+  EXPECT_TRUE(scheduler::SolveBinary(mapped->data(), mapped->size()).is_feasible);
+  std::fclose(file);
+
+  int pipe_fds[2];
+  ASSERT_EQ(pipe(pipe_fds), 0);
+  EXPECT_FALSE(scheduler::MappedFile::Map(pipe_fds[0]).has_value());
+  close(pipe_fds[0]);
+  close(pipe_fds[1]);
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <random>
+#include <string>
+
+#include <scheduler/problem_input.hpp>
+#include <scheduler/result_cache.hpp>
+#include <scheduler/solve_result_json.hpp>
+#include <scheduler/solver.hpp>
+
+namespace {
+
+// doc-c has no availability, so d3 stays uncovered and the solve reports a min cut.
+nlohmann::json BuildRequest() {
+  return nlohmann::json::parse(R"({
+    "contractVersion": "1.0",
+    "doctors": [{"id": "doc-a", "maxTotalDays": 2}, {"id": "doc-b", "maxTotalDays": 1},
+                {"id": "doc-c", "maxTotalDays": 1}],
+    "periods": [{"id": "p1", "dayIds": ["d1", "d2"]}, {"id": "p2", "dayIds": ["d3", "d4"]}],
+    "demands": [{"dayId": "d1", "requiredDoctors": 1}, {"dayId": "d2", "requiredDoctors": 1},
+                {"dayId": "d3", "requiredDoctors": 1}, {"dayId": "d4", "requiredDoctors": 1}],
+    "availability": [{"doctorId": "doc-a", "periodId": "p1", "dayId": "d1"},
+                     {"doctorId": "doc-b", "periodId": "p1", "dayId": "d2"},
+                     {"doctorId": "doc-a", "periodId": "p2", "dayId": "d4"}]
+  })");
+}
+
+nlohmann::json Shuffled(nlohmann::json request, std::mt19937& rng) {
+  for (const char* key : {"doctors", "periods", "demands", "availability"}) {
+    std::shuffle(request[key].begin(), request[key].end(), rng);
+  }
+  for (nlohmann::json& period : request["periods"]) {
+    std::shuffle(period["dayIds"].begin(), period["dayIds"].end(), rng);
+  }
+  return request;
+}
+
+scheduler::ProblemHash HashOf(const nlohmann::json& request) {
+  const scheduler::ProblemInput input = scheduler::ParseProblemInput(request.dump());
+  return scheduler::HashProblem(input.View());
+}
+
+TEST(ResultCache, HashIgnoresEntityOrderButNotContent) {
+  const nlohmann::json request = BuildRequest();
+  const scheduler::ProblemHash hash = HashOf(request);
+  EXPECT_EQ(hash.ToHex().size(), 32u);
+
+  std::mt19937 rng(20260701);
+  for (int round = 0; round < 20; ++round) {
+    EXPECT_EQ(HashOf(Shuffled(request, rng)), hash);
+  }
+
+  nlohmann::json cap = request;
+  cap["doctors"][1]["maxTotalDays"] = 2;
+  EXPECT_NE(HashOf(cap), hash);
+  nlohmann::json moved = request;
+  moved["availability"][2]["periodId"] = "p1";
+  EXPECT_NE(HashOf(moved), hash);
+  nlohmann::json duplicated = request;
+  duplicated["availability"].push_back(request["availability"][0]);
+  EXPECT_NE(HashOf(duplicated), hash);
+  nlohmann::json swapped = request;
+  swapped["periods"][0]["dayIds"] = {"d1", "d3"};
+  swapped["periods"][1]["dayIds"] = {"d2", "d4"};
+  EXPECT_NE(HashOf(swapped), hash);
+
+  const scheduler::ProblemInput input = scheduler::ParseProblemInput(request.dump());
+  scheduler::SolveOptions dinic;
+  dinic.algorithm = scheduler::MaxFlowAlgorithm::kDinic;
+  scheduler::SolveOptions threads;
+  threads.threads = 4;
+  EXPECT_NE(scheduler::SolveCacheKey(input.View(), dinic), scheduler::SolveCacheKey(input.View(), {}));
+  EXPECT_EQ(scheduler::SolveCacheKey(input.View(), threads), scheduler::SolveCacheKey(input.View(), {}));
+}
+
+TEST(ResultCache, EvictsTheLeastRecentlyUsedEntry) {
+  scheduler::ResultCache cache({2, ""});
+  const scheduler::ProblemHash a{0, 1};
+  const scheduler::ProblemHash b{0, 2};
+  const scheduler::ProblemHash c{0, 3};
+  scheduler::SolveResult result;
+  result.assigned_count = 7;
+  cache.Insert(a, result);
+  cache.Insert(b, result);
+  ASSERT_TRUE(cache.Find(a));
+  cache.Insert(c, result);
+
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_FALSE(cache.Find(b));
+  const std::optional<scheduler::SolveResult> found = cache.Find(a);
+  ASSERT_TRUE(found);
+  EXPECT_EQ(found->assigned_count, 7);
+  EXPECT_TRUE(cache.Find(c));
+
+  const scheduler::ResultCacheCounters counters = cache.counters();
+  EXPECT_EQ(counters.hits, 3);
+  EXPECT_EQ(counters.misses, 1);
+  EXPECT_EQ(counters.evictions, 1);
+}
+
+TEST(ResultCache, SolveAnswersReorderedRepeatsInTheirOwnOrder) {
+  scheduler::ResultCache cache;
+  scheduler::SolveOptions options;
+  options.result_cache = &cache;
+
+  const nlohmann::json request = BuildRequest();
+  const std::string first = scheduler::SerializeSolveResult(scheduler::Solve(request.dump(), options));
+  EXPECT_EQ(scheduler::SerializeSolveResult(scheduler::Solve(request.dump(), options)), first);
+
+  std::mt19937 rng(7);
+  for (int round = 0; round < 10; ++round) {
+    const nlohmann::json reordered = Shuffled(request, rng);
+    const scheduler::SolveResult cached = scheduler::Solve(reordered.dump(), options);
+    const scheduler::SolveResult fresh = scheduler::Solve(reordered.dump());
+    // The roster is unique, so only the order could differ; the min cut keeps the cached order.
+    EXPECT_EQ(nlohmann::json::parse(scheduler::SerializeSolveResult(cached))["assignments"],
+              nlohmann::json::parse(scheduler::SerializeSolveResult(fresh))["assignments"]);
+    EXPECT_EQ(cached.uncovered_days, fresh.uncovered_days);
+    ASSERT_TRUE(cached.min_cut);
+    EXPECT_EQ(cached.min_cut->value, fresh.min_cut->value);
+  }
+
+  scheduler::SolveOptions with_stats = options;
+  with_stats.collect_stats = true;
+  with_stats.algorithm = scheduler::MaxFlowAlgorithm::kPushRelabel;
+  EXPECT_TRUE(scheduler::Solve(request.dump(), with_stats).stats);
+  const scheduler::SolveResult hit = scheduler::Solve(request.dump(), with_stats);
+  ASSERT_TRUE(hit.stats);
+  EXPECT_EQ(hit.stats->nodes, 0);
+
+  const scheduler::ResultCacheCounters counters = cache.counters();
+  EXPECT_EQ(counters.misses, 2);
+  EXPECT_EQ(counters.hits, 12);
+}
+
+TEST(ResultCache, PersistsResultsInTheDirectory) {
+  const std::filesystem::path directory = std::filesystem::path(::testing::TempDir()) / "scheduler-result-cache";
+  std::filesystem::remove_all(directory);
+  const std::string request = BuildRequest().dump();
+
+  std::string solved;
+  {
+    scheduler::ResultCache cache({0, directory.string()});
+    scheduler::SolveOptions options;
+    options.result_cache = &cache;
+    solved = scheduler::SerializeSolveResult(scheduler::Solve(request, options));
+    EXPECT_EQ(cache.size(), 0u);
+  }
+
+  scheduler::ResultCache reopened({4, directory.string()});
+  scheduler::SolveOptions options;
+  options.result_cache = &reopened;
+  EXPECT_EQ(scheduler::SerializeSolveResult(scheduler::Solve(request, options)), solved);
+  EXPECT_EQ(scheduler::SerializeSolveResult(scheduler::Solve(request, options)), solved);
+  const scheduler::ResultCacheCounters counters = reopened.counters();
+  EXPECT_EQ(counters.hits, 2);
+  EXPECT_EQ(counters.disk_hits, 1);
+  EXPECT_EQ(counters.misses, 0);
+  std::filesystem::remove_all(directory);
+}
+
+TEST(ResultCache, BoundsTheDirectoryByEvictingTheOldestFiles) {
+  const std::filesystem::path directory = std::filesystem::path(::testing::TempDir()) / "scheduler-result-bound";
+  std::filesystem::remove_all(directory);
+  const scheduler::ProblemHash first{0, 1};
+  const scheduler::ProblemHash second{0, 2};
+  const scheduler::ProblemHash third{0, 3};
+  const auto path_of = [&](const scheduler::ProblemHash& key) { return directory / (key.ToHex() + ".json"); };
+  // File times are set by hand: back-to-back writes may share a timestamp.
+  const auto age = [&](const scheduler::ProblemHash& key, std::chrono::hours hours) {
+    std::filesystem::last_write_time(path_of(key), std::filesystem::file_time_type::clock::now() - hours);
+  };
+
+  scheduler::ResultCache cache({0, directory.string(), 2});
+  cache.Insert(first, scheduler::SolveResult{});
+  age(first, std::chrono::hours(3));
+  cache.Insert(second, scheduler::SolveResult{});
+  age(second, std::chrono::hours(2));
+  // A disk hit counts as a use, so `second` is now the oldest file.
+  ASSERT_TRUE(cache.Find(first).has_value());
+  cache.Insert(third, scheduler::SolveResult{});
+
+  EXPECT_TRUE(std::filesystem::exists(path_of(first)));
+  EXPECT_FALSE(std::filesystem::exists(path_of(second)));
+  EXPECT_TRUE(std::filesystem::exists(path_of(third)));
+  EXPECT_EQ(cache.counters().disk_evictions, 1);
+  EXPECT_FALSE(cache.Find(second).has_value());
+
+  // 0 keeps everything. Reopening leaves the directory alone; the first file
+  // the new cache adds prunes what was left past the bound.
+  scheduler::ResultCache unbounded({0, directory.string(), 0});
+  unbounded.Insert(second, scheduler::SolveResult{});
+  EXPECT_EQ(unbounded.counters().disk_evictions, 0);
+  age(first, std::chrono::hours(1));
+  age(second, std::chrono::hours(2));
+  scheduler::ResultCache reopened({0, directory.string(), 2});
+  EXPECT_EQ(reopened.counters().disk_evictions, 0);
+  EXPECT_TRUE(std::filesystem::exists(path_of(first)));
+  reopened.Insert(third, scheduler::SolveResult{});
+  EXPECT_EQ(reopened.counters().disk_evictions, 0);
+  reopened.Insert(scheduler::ProblemHash{0, 4}, scheduler::SolveResult{});
+  EXPECT_EQ(reopened.counters().disk_evictions, 2);
+  EXPECT_FALSE(std::filesystem::exists(path_of(first)));
+  EXPECT_FALSE(std::filesystem::exists(path_of(second)));
+  EXPECT_TRUE(std::filesystem::exists(path_of(third)));
+  std::filesystem::remove_all(directory);
+}
+
+}  // namespace
@@ -0,0 +1,266 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <scheduler/scheduler_c.h>
+#include <scheduler/solver.hpp>
+
+#include "test_support.hpp"
+
+namespace {
+
+using AssignmentTuple = std::tuple<int, int, int>;
+
+struct RandomRoster {
+  std::vector<int32_t> max_total_days;
+  std::vector<int32_t> required_doctors;
+  std::vector<std::vector<int32_t>> period_days;
+  std::vector<AssignmentTuple> availability;
+};
+
+// The request's entities by position, as the C ABI takes them.
+RandomRoster IndexRoster(const std::string& request_json) {
+  const nlohmann::json request = nlohmann::json::parse(request_json);
+  RandomRoster roster;
+  std::map<std::string, int> doctor_index;
+  std::map<std::string, int> period_index;
+  std::map<std::string, int32_t> day_index;
+  for (const nlohmann::json& doctor : request["doctors"]) {
+    doctor_index.emplace(doctor["id"], static_cast<int>(roster.max_total_days.size()));
+    roster.max_total_days.push_back(doctor["maxTotalDays"].get<int32_t>());
+  }
+  for (const nlohmann::json& demand : request["demands"]) {
+    day_index.emplace(demand["dayId"], static_cast<int32_t>(roster.required_doctors.size()));
+    roster.required_doctors.push_back(demand["requiredDoctors"].get<int32_t>());
+  }
+  for (const nlohmann::json& period : request["periods"]) {
+    period_index.emplace(period["id"], static_cast<int>(roster.period_days.size()));
+    std::vector<int32_t>& days = roster.period_days.emplace_back();
+    for (const nlohmann::json& day : period["dayIds"]) {
+      days.push_back(day_index.at(day));
+    }
+  }
+  for (const nlohmann::json& available : request["availability"]) {
+    roster.availability.emplace_back(doctor_index.at(available["doctorId"]), period_index.at(available["periodId"]),
+                                     day_index.at(available["dayId"]));
+  }
+  return roster;
+}
+
+// Keeps the contract key order so the parser meets the ids in the same order
+// the C problem adds them; the min cut lists entities in that order.
+std::string ToRequestJson(const RandomRoster& roster) {
+  nlohmann::ordered_json request;
+  request["contractVersion"] = "1.0";
+  request["doctors"] = nlohmann::ordered_json::array();
+  request["periods"] = nlohmann::ordered_json::array();
+  request["demands"] = nlohmann::ordered_json::array();
+  request["availability"] = nlohmann::ordered_json::array();
+  for (std::size_t i = 0; i < roster.max_total_days.size(); ++i) {
+    request["doctors"].push_back({{"id", std::to_string(i)}, {"maxTotalDays", roster.max_total_days[i]}});
+  }
+  for (std::size_t d = 0; d < roster.required_doctors.size(); ++d) {
+    request["demands"].push_back({{"dayId", std::to_string(d)}, {"requiredDoctors", roster.required_doctors[d]}});
+  }
+  for (std::size_t k = 0; k < roster.period_days.size(); ++k) {
+    nlohmann::ordered_json day_ids = nlohmann::ordered_json::array();
+    for (const int32_t day : roster.period_days[k]) {
+      day_ids.push_back(std::to_string(day));
+    }
+    request["periods"].push_back({{"id", std::to_string(k)}, {"dayIds", day_ids}});
+  }
+  for (const auto& [doctor, period, day] : roster.availability) {
+    request["availability"].push_back(
+        {{"doctorId", std::to_string(doctor)}, {"periodId", std::to_string(period)}, {"dayId", std::to_string(day)}});
+  }
+  return request.dump();
+}
+
+scheduler_problem* ToProblem(const RandomRoster& roster) {
+  scheduler_problem* problem = scheduler_problem_create();
+  for (std::size_t i = 0; i < roster.max_total_days.size(); ++i) {
+    EXPECT_EQ(scheduler_problem_add_doctor(problem, roster.max_total_days[i]), static_cast<int32_t>(i));
+  }
+  for (std::size_t d = 0; d < roster.required_doctors.size(); ++d) {
+    EXPECT_EQ(scheduler_problem_add_day(problem, roster.required_doctors[d]), static_cast<int32_t>(d));
+  }
+  for (std::size_t k = 0; k < roster.period_days.size(); ++k) {
+    const std::vector<int32_t>& days = roster.period_days[k];
+    EXPECT_EQ(scheduler_problem_add_period(problem, days.data(), days.size()), static_cast<int32_t>(k));
+  }
+  for (const auto& [doctor, period, day] : roster.availability) {
+    EXPECT_EQ(scheduler_problem_add_availability(problem, doctor, period, day), SCHEDULER_OK);
+  }
+  return problem;
+}
+
+std::vector<int32_t> MinCutEntries(const scheduler_result* result, scheduler_min_cut_list list, std::size_t width) {
+  const int32_t* entries = scheduler_result_min_cut_entries(result, list);
+  return std::vector<int32_t>(entries, entries + width * scheduler_result_min_cut_count(result, list));
+}
+
+// Names the C min cut the way the JSON report does, with ids = indices.
+scheduler::MinCutReport NameMinCut(const scheduler_result* result) {
+  scheduler::MinCutReport report;
+  report.value = scheduler_result_min_cut_value(result);
+  const auto doctor = [](int32_t index) { return "doctor:" + std::to_string(index); };
+  const auto doctor_period = [](int32_t doctor, int32_t period) {
+    return "doctor-period:" + std::to_string(doctor) + ":" + std::to_string(period);
+  };
+  const auto day = [](int32_t index) { return "day:" + std::to_string(index); };
+
+  report.reachable_nodes.emplace_back("source");
+  for (const int32_t index : MinCutEntries(result, SCHEDULER_MIN_CUT_REACHABLE_DOCTORS, 1)) {
+    report.reachable_nodes.push_back(doctor(index));
+  }
+  const std::vector<int32_t> pairs = MinCutEntries(result, SCHEDULER_MIN_CUT_REACHABLE_DOCTOR_PERIODS, 2);
+  for (std::size_t i = 0; i < pairs.size(); i += 2) {
+    report.reachable_nodes.push_back(doctor_period(pairs[i], pairs[i + 1]));
+  }
+  for (const int32_t index : MinCutEntries(result, SCHEDULER_MIN_CUT_REACHABLE_DAYS, 1)) {
+    report.reachable_nodes.push_back(day(index));
+  }
+
+  const std::vector<int32_t> capped = MinCutEntries(result, SCHEDULER_MIN_CUT_CAPPED_DOCTORS, 2);
+  for (std::size_t i = 0; i < capped.size(); i += 2) {
+    report.cut_edges.push_back(scheduler::MinCutEdge{"source", doctor(capped[i]), capped[i + 1]});
+    report.capped_doctors.push_back(scheduler::CappedDoctor{std::to_string(capped[i]), capped[i + 1]});
+  }
+  const std::vector<int32_t> limits = MinCutEntries(result, SCHEDULER_MIN_CUT_PERIOD_LIMITS, 2);
+  for (std::size_t i = 0; i < limits.size(); i += 2) {
+    report.cut_edges.push_back(
+        scheduler::MinCutEdge{doctor(limits[i]), doctor_period(limits[i], limits[i + 1]), 1});
+    report.period_limits.push_back(
+        scheduler::PeriodLimit{std::to_string(limits[i]), std::to_string(limits[i + 1])});
+  }
+  const std::vector<int32_t> cut_days = MinCutEntries(result, SCHEDULER_MIN_CUT_CUT_DAYS, 2);
+  for (std::size_t i = 0; i < cut_days.size(); i += 2) {
+    report.cut_edges.push_back(scheduler::MinCutEdge{day(cut_days[i]), "sink", cut_days[i + 1]});
+  }
+  const std::vector<int32_t> uncoverable = MinCutEntries(result, SCHEDULER_MIN_CUT_UNCOVERABLE_DAYS, 2);
+  for (std::size_t i = 0; i < uncoverable.size(); i += 2) {
+    report.uncoverable_days.push_back(scheduler::UncoverableDay{std::to_string(uncoverable[i]), uncoverable[i + 1]});
+  }
+  return report;
+}
+
+TEST(SchedulerCApi, MatchesTheJsonSolveOnRandomRosters) {
+  std::mt19937 rng(20260517);
+  for (int round = 0; round < 60; ++round) {
+    const RandomRoster roster = IndexRoster(scheduler::test::RandomSmallRoster(rng));
+    const scheduler::SolveResult expected = scheduler::Solve(ToRequestJson(roster));
+
+    scheduler_problem* problem = ToProblem(roster);
+    scheduler_solve_options options;
+    scheduler_solve_options_init(&options);
+    options.algorithm = round % 2 == 0 ? SCHEDULER_ALGORITHM_AUTO : SCHEDULER_ALGORITHM_DINIC;
+    scheduler_result* result = nullptr;
+    ASSERT_EQ(scheduler_solve(problem, &options, &result), SCHEDULER_OK);
+    ASSERT_NE(result, nullptr);
+
+    EXPECT_EQ(scheduler_result_is_feasible(result), expected.is_feasible ? 1 : 0);
+    EXPECT_EQ(scheduler_result_is_truncated(result), 0);
+
+    std::vector<AssignmentTuple> expected_assignments;
+    for (const scheduler::Assignment& assignment : expected.assignments) {
+      expected_assignments.emplace_back(std::stoi(assignment.doctor_id), std::stoi(assignment.period_id),
+                                        std::stoi(assignment.day_id));
+    }
+    std::vector<AssignmentTuple> actual_assignments;
+    const std::size_t count = scheduler_result_assignment_count(result);
+    for (std::size_t i = 0; i < count; ++i) {
+      actual_assignments.emplace_back(scheduler_result_assignment_doctors(result)[i],
+                                      scheduler_result_assignment_periods(result)[i],
+                                      scheduler_result_assignment_days(result)[i]);
+    }
+    EXPECT_TRUE(std::is_sorted(actual_assignments.begin(), actual_assignments.end()));
+    std::sort(expected_assignments.begin(), expected_assignments.end());
+    EXPECT_EQ(actual_assignments, expected_assignments);
+
+    std::vector<int> expected_uncovered;
+    for (const std::string& day_id : expected.uncovered_days) {
+      expected_uncovered.push_back(std::stoi(day_id));
+    }
+    std::sort(expected_uncovered.begin(), expected_uncovered.end());
+    const int32_t* uncovered = scheduler_result_uncovered_days(result);
+    EXPECT_EQ(std::vector<int>(uncovered, uncovered + scheduler_result_uncovered_day_count(result)),
+              expected_uncovered);
+
+    ASSERT_EQ(scheduler_result_has_min_cut(result), expected.min_cut ? 1 : 0);
+    if (expected.min_cut) {
+      const scheduler::MinCutReport actual_cut = NameMinCut(result);
+      EXPECT_EQ(actual_cut.value, expected.min_cut->value);
+      EXPECT_EQ(actual_cut.reachable_nodes, expected.min_cut->reachable_nodes);
+      ASSERT_EQ(actual_cut.cut_edges.size(), expected.min_cut->cut_edges.size());
+      for (std::size_t i = 0; i < actual_cut.cut_edges.size(); ++i) {
+        EXPECT_EQ(actual_cut.cut_edges[i].from, expected.min_cut->cut_edges[i].from);
+        EXPECT_EQ(actual_cut.cut_edges[i].to, expected.min_cut->cut_edges[i].to);
+        EXPECT_EQ(actual_cut.cut_edges[i].capacity, expected.min_cut->cut_edges[i].capacity);
+      }
+      ASSERT_EQ(actual_cut.capped_doctors.size(), expected.min_cut->capped_doctors.size());
+      for (std::size_t i = 0; i < actual_cut.capped_doctors.size(); ++i) {
+        EXPECT_EQ(actual_cut.capped_doctors[i].doctor_id, expected.min_cut->capped_doctors[i].doctor_id);
+        EXPECT_EQ(actual_cut.capped_doctors[i].cap, expected.min_cut->capped_doctors[i].cap);
+      }
+      ASSERT_EQ(actual_cut.period_limits.size(), expected.min_cut->period_limits.size());
+      for (std::size_t i = 0; i < actual_cut.period_limits.size(); ++i) {
+        EXPECT_EQ(actual_cut.period_limits[i].doctor_id, expected.min_cut->period_limits[i].doctor_id);
+        EXPECT_EQ(actual_cut.period_limits[i].period_id, expected.min_cut->period_limits[i].period_id);
+      }
+      ASSERT_EQ(actual_cut.uncoverable_days.size(), expected.min_cut->uncoverable_days.size());
+      for (std::size_t i = 0; i < actual_cut.uncoverable_days.size(); ++i) {
+        EXPECT_EQ(actual_cut.uncoverable_days[i].day_id, expected.min_cut->uncoverable_days[i].day_id);
+        EXPECT_EQ(actual_cut.uncoverable_days[i].required_doctors,
+                  expected.min_cut->uncoverable_days[i].required_doctors);
+      }
+    } else {
+      EXPECT_EQ(scheduler_result_min_cut_count(result, SCHEDULER_MIN_CUT_CAPPED_DOCTORS), 0u);
+    }
+
+    scheduler_result_free(result);
+    scheduler_problem_free(problem);
+  }
+}
+
+TEST(SchedulerCApi, RejectsUnknownIndicesAndNullArguments) {
+  scheduler_problem* problem = scheduler_problem_create();
+  ASSERT_NE(problem, nullptr);
+  EXPECT_EQ(scheduler_problem_add_doctor(nullptr, 1), -1);
+  EXPECT_EQ(scheduler_problem_add_doctor(problem, 1), 0);
+  EXPECT_EQ(scheduler_problem_add_day(problem, 1), 0);
+
+  const int32_t unknown_day[] = {1};
+  EXPECT_EQ(scheduler_problem_add_period(problem, unknown_day, 1), -1);
+  EXPECT_EQ(scheduler_problem_add_period(problem, nullptr, 1), -1);
+  const int32_t days[] = {0};
+  EXPECT_EQ(scheduler_problem_add_period(problem, days, 1), 0);
+
+  EXPECT_EQ(scheduler_problem_add_availability(problem, 1, 0, 0), SCHEDULER_INVALID_ARGUMENT);
+  EXPECT_EQ(scheduler_problem_add_availability(problem, 0, -1, 0), SCHEDULER_INVALID_ARGUMENT);
+  EXPECT_EQ(scheduler_problem_add_availability(problem, 0, 0, 0), SCHEDULER_OK);
+
+  scheduler_result* result = nullptr;
+  EXPECT_EQ(scheduler_solve(nullptr, nullptr, &result), SCHEDULER_INVALID_ARGUMENT);
+  EXPECT_EQ(result, nullptr);
+  EXPECT_EQ(scheduler_solve(problem, nullptr, nullptr), SCHEDULER_INVALID_ARGUMENT);
+
+  ASSERT_EQ(scheduler_solve(problem, nullptr, &result), SCHEDULER_OK);
+  EXPECT_EQ(scheduler_result_is_feasible(result), 1);
+  ASSERT_EQ(scheduler_result_assignment_count(result), 1u);
+  EXPECT_EQ(scheduler_result_assignment_doctors(result)[0], 0);
+  EXPECT_EQ(scheduler_result_uncovered_day_count(result), 0u);
+  EXPECT_STREQ(scheduler_status_message(SCHEDULER_INVALID_ARGUMENT), "invalid argument");
+  EXPECT_EQ(scheduler_abi_version(), SCHEDULER_C_ABI_VERSION);
+
+  scheduler_result_free(result);
+  scheduler_problem_free(problem);
+}
+
+}  // namespace
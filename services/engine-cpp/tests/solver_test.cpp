@@ -1,29 +1,26 @@
 #include <gtest/gtest.h>
-#include <fstream>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <random>
+#include <set>
 #include <sstream>
-#include <stdexcept>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <nlohmann/json.hpp>
+#include <scheduler/graph_builder.hpp>
+#include <scheduler/greedy_warm_start.hpp>
+#include <scheduler/min_cut_report.hpp>
+#include <scheduler/problem_input.hpp>
 #include <scheduler/solver.hpp>
 
-namespace {
+#include "test_support.hpp"
 
-#ifndef DOMAIN_FIXTURES_DIR
-#define DOMAIN_FIXTURES_DIR ""
-#endif
+namespace {
 
-std::string ReadFixtureFile(const std::string& file_name) {
-  const std::string full_path = std::string(DOMAIN_FIXTURES_DIR) + "/" + file_name;
-  std::ifstream stream(full_path);
-  if (!stream.is_open()) {
-    throw std::runtime_error("Unable to open fixture file: " + full_path);
-  }
-
-  std::ostringstream buffer;
-  buffer << stream.rdbuf();
-  return buffer.str();
-}
+using scheduler::test::RandomRoster;
+using scheduler::test::ReadFixtureFile;
 
 struct FixtureExpectation {
   std::string id;
@@ -63,26 +60,519 @@ std::vector<FixtureExpectation> LoadFixtureCatalog() {
   return fixtures;
 }
 
+const std::vector<std::optional<scheduler::MaxFlowAlgorithm>> kAlgorithms = {
+    std::nullopt,
+    scheduler::MaxFlowAlgorithm::kEdmondsKarp,
+    scheduler::MaxFlowAlgorithm::kDinic,
+    scheduler::MaxFlowAlgorithm::kPushRelabel,
+    scheduler::MaxFlowAlgorithm::kParallelPushRelabel,
+};
+
+std::string AlgorithmLabel(const std::optional<scheduler::MaxFlowAlgorithm>& algorithm) {
+  return algorithm ? scheduler::MaxFlowAlgorithmName(*algorithm) : "layered";
+}
+
 TEST(SolverFlow, MatchesExpectedOutcomesFromSharedFixtureCatalog) {
   const auto fixtures = LoadFixtureCatalog();
-  int validated_count = 0;
+  for (const auto& algorithm : kAlgorithms) {
+    SCOPED_TRACE(AlgorithmLabel(algorithm));
+    int validated_count = 0;
+
+    for (const auto& fixture : fixtures) {
+      if (!fixture.expect_schema_valid || !fixture.has_expected_solver) {
+        continue;
+      }
+
+      SCOPED_TRACE(fixture.id);
+      scheduler::SolveOptions options;
+      options.algorithm = algorithm;
+      const auto result = scheduler::Solve(ReadFixtureFile(fixture.request_file), options);
+
+      EXPECT_EQ(result.contract_version, "1.0");
+      EXPECT_EQ(result.is_feasible, fixture.expected_is_feasible);
+      EXPECT_EQ(result.assigned_count, fixture.expected_assigned_count);
+      EXPECT_EQ(static_cast<int>(result.uncovered_days.size()), fixture.expected_uncovered_days_count);
+      validated_count += 1;
+    }
+
+    EXPECT_GT(validated_count, 0);
+  }
+}
+
+TEST(SolverFlow, AllAlgorithmsAgreeOnRandomRosters) {
+  std::mt19937 rng(20260302);
+
+  for (int round = 0; round < 40; ++round) {
+    const int doctors = 1 + static_cast<int>(rng() % 12);
+    const int periods = 1 + static_cast<int>(rng() % 4);
+    const int days_per_period = 1 + static_cast<int>(rng() % 5);
+    const double density = 0.2 + 0.6 * (rng() % 100) / 100.0;
+    const std::string request = RandomRoster(rng, doctors, periods, days_per_period, density, 3, 4);
+
+    scheduler::SolveOptions reference_options;
+    reference_options.algorithm = scheduler::MaxFlowAlgorithm::kEdmondsKarp;
+    const auto reference = scheduler::Solve(request, reference_options);
+
+    for (const auto& algorithm : kAlgorithms) {
+      SCOPED_TRACE(AlgorithmLabel(algorithm));
+      scheduler::SolveOptions options;
+      options.algorithm = algorithm;
+      const auto result = scheduler::Solve(request, options);
+
+      EXPECT_EQ(result.is_feasible, reference.is_feasible) << "round " << round;
+      EXPECT_EQ(result.assigned_count, reference.assigned_count) << "round " << round;
+    }
+  }
+}
+
+TEST(SolverFlow, StatsAreOptInAndLeaveTheResultUnchanged) {
+  std::mt19937 rng(20260304);
+  const std::string request = RandomRoster(rng, 10, 3, 4, 0.5, 3, 4);
 
-  for (const auto& fixture : fixtures) {
-    if (!fixture.expect_schema_valid || !fixture.has_expected_solver) {
-      continue;
+  for (const auto& algorithm : kAlgorithms) {
+    SCOPED_TRACE(AlgorithmLabel(algorithm));
+    scheduler::SolveOptions options;
+    options.algorithm = algorithm;
+    // Keep every unit on the engine so its counters have work to show.
+    options.warm_start = false;
+    const auto plain = scheduler::Solve(request, options);
+    EXPECT_FALSE(plain.stats.has_value());
+
+    options.collect_stats = true;
+    const auto measured = scheduler::Solve(request, options);
+    ASSERT_TRUE(measured.stats.has_value());
+    EXPECT_EQ(measured.assigned_count, plain.assigned_count);
+    EXPECT_EQ(measured.is_feasible, plain.is_feasible);
+
+    const scheduler::SolveStats& stats = *measured.stats;
+    EXPECT_GE(stats.components, 1);
+    EXPECT_GT(stats.nodes, 0);
+    EXPECT_GT(stats.arcs, 0);
+    EXPECT_GT(stats.max_flow.phases, 0);
+    EXPECT_GT(stats.max_flow.arcs_scanned, 0);
+    if (measured.assigned_count > 0) {
+      EXPECT_GT(stats.max_flow.augmentations, 0);
     }
+    EXPECT_GE(stats.parse_ms, 0);
+    EXPECT_GT(stats.peak_rss_kb, 0);
+  }
 
-    SCOPED_TRACE(fixture.id);
-    const auto result = scheduler::Solve(ReadFixtureFile(fixture.request_file));
+  scheduler::SolveOptions options;
+  options.collect_stats = true;
+  const auto invalid = scheduler::Solve("{invalid-json", options);
+  ASSERT_TRUE(invalid.stats.has_value());
+  EXPECT_EQ(invalid.stats->components, 0);
+}
 
-    EXPECT_EQ(result.contract_version, "1.0");
-    EXPECT_EQ(result.is_feasible, fixture.expected_is_feasible);
-    EXPECT_EQ(result.assigned_count, fixture.expected_assigned_count);
-    EXPECT_EQ(static_cast<int>(result.uncovered_days.size()), fixture.expected_uncovered_days_count);
-    validated_count += 1;
+TEST(SolverFlow, StopsOnCancellationWithATruncatedValidRoster) {
+  std::mt19937 rng(20260305);
+  const std::string request = RandomRoster(rng, 40, 3, 5, 0.5, 3, 4);
+  const auto full = scheduler::Solve(request);
+  ASSERT_GT(full.assigned_count, 0);
+
+  scheduler::CancellationToken token;
+  token.Cancel();
+  for (const auto& algorithm : kAlgorithms) {
+    SCOPED_TRACE(AlgorithmLabel(algorithm));
+    scheduler::SolveOptions options;
+    options.algorithm = algorithm;
+    options.warm_start = false;
+    options.cancellation = &token;
+    const auto result = scheduler::Solve(request, options);
+
+    EXPECT_TRUE(result.truncated);
+    EXPECT_FALSE(result.is_feasible);
+    EXPECT_LE(result.assigned_count, full.assigned_count);
+    std::set<std::pair<std::string, std::string>> doctor_periods;
+    for (const auto& assignment : result.assignments) {
+      EXPECT_TRUE(doctor_periods.emplace(assignment.doctor_id, assignment.period_id).second);
+    }
   }
 
-  EXPECT_GT(validated_count, 0);
+  scheduler::SolveOptions options;
+  options.time_budget = std::chrono::milliseconds(60000);
+  const auto unhurried = scheduler::Solve(request, options);
+  EXPECT_FALSE(unhurried.truncated);
+  EXPECT_EQ(unhurried.assigned_count, full.assigned_count);
+}
+
+TEST(SolverFlow, GreedyWarmStartSeedsAValidFlowWithoutChangingTheMaximum) {
+  std::mt19937 rng(20260306);
+
+  for (int round = 0; round < 30; ++round) {
+    const int doctors = 2 + static_cast<int>(rng() % 20);
+    const int periods = 1 + static_cast<int>(rng() % 4);
+    const int days_per_period = 1 + static_cast<int>(rng() % 5);
+    const double density = 0.2 + 0.6 * (rng() % 100) / 100.0;
+    const std::string request = RandomRoster(rng, doctors, periods, days_per_period, density, 3, 4);
+    const scheduler::ProblemInput input = scheduler::ParseProblemInput(request);
+
+    scheduler::GraphBuildResult graph = scheduler::BuildFlowGraph(input);
+    graph.network.Finalize();
+    ASSERT_TRUE(scheduler::MatchesFlowLayers(graph.network, graph.layers));
+    const int seeded = scheduler::GreedyWarmStart(graph.network, graph.layers);
+
+    // Same build, same arc layout: its residuals are the original capacities.
+    scheduler::GraphBuildResult cold = scheduler::BuildFlowGraph(input);
+    cold.network.Finalize();
+    for (int node = 0; node < graph.network.node_count(); ++node) {
+      long long outflow = 0;
+      for (int arc = graph.network.FirstArc(node); arc < graph.network.EndArc(node); ++arc) {
+        ASSERT_GE(graph.network.Residual(arc), 0);
+        outflow += cold.network.Residual(arc) - graph.network.Residual(arc);
+      }
+      const long long expected = node == graph.source ? seeded : node == graph.sink ? -seeded : 0;
+      EXPECT_EQ(outflow, expected) << "round " << round << " node " << node;
+    }
+    const int max_flow = cold.network.MaxFlow(cold.source, cold.sink);
+    EXPECT_LE(seeded, max_flow) << "round " << round;
+
+    for (const auto& algorithm : kAlgorithms) {
+      SCOPED_TRACE(AlgorithmLabel(algorithm));
+      scheduler::SolveOptions options;
+      options.algorithm = algorithm;
+      const auto warm = scheduler::Solve(request, options);
+      options.warm_start = false;
+      const auto reference = scheduler::Solve(request, options);
+      EXPECT_EQ(warm.assigned_count, reference.assigned_count) << "round " << round;
+      EXPECT_EQ(warm.is_feasible, reference.is_feasible) << "round " << round;
+    }
+  }
+}
+
+TEST(SolverFlow, ReportsTheMinCutOfInfeasibleSolvesInProblemTerms) {
+  const std::string request = R"({
+    "contractVersion": "1.0",
+    "doctors": [{"id": "a", "maxTotalDays": 2}, {"id": "b", "maxTotalDays": 1}, {"id": "c", "maxTotalDays": 1}],
+    "periods": [{"id": "p1", "dayIds": ["d1", "d2"]}, {"id": "p2", "dayIds": ["d3", "d4"]}],
+    "demands": [
+      {"dayId": "d1", "requiredDoctors": 1},
+      {"dayId": "d2", "requiredDoctors": 1},
+      {"dayId": "d3", "requiredDoctors": 1},
+      {"dayId": "d4", "requiredDoctors": 1},
+      {"dayId": "d5", "requiredDoctors": 2}
+    ],
+    "availability": [
+      {"doctorId": "a", "periodId": "p1", "dayId": "d1"},
+      {"doctorId": "a", "periodId": "p1", "dayId": "d2"},
+      {"doctorId": "a", "periodId": "p2", "dayId": "d3"},
+      {"doctorId": "b", "periodId": "p2", "dayId": "d3"},
+      {"doctorId": "c", "periodId": "p2", "dayId": "d4"}
+    ]
+  })";
+
+  const auto result = scheduler::Solve(request);
+  ASSERT_FALSE(result.is_feasible);
+  ASSERT_TRUE(result.min_cut.has_value());
+  const scheduler::MinCutReport& min_cut = *result.min_cut;
+  EXPECT_EQ(min_cut.value, result.assigned_count);
+
+  ASSERT_EQ(min_cut.period_limits.size(), 1u);
+  EXPECT_EQ(min_cut.period_limits[0].doctor_id, "a");
+  EXPECT_EQ(min_cut.period_limits[0].period_id, "p1");
+  ASSERT_EQ(min_cut.capped_doctors.size(), 1u);
+  EXPECT_EQ(min_cut.capped_doctors[0].doctor_id, "c");
+  EXPECT_EQ(min_cut.capped_doctors[0].cap, 1);
+  ASSERT_EQ(min_cut.uncoverable_days.size(), 1u);
+  EXPECT_EQ(min_cut.uncoverable_days[0].day_id, "d5");
+  EXPECT_EQ(min_cut.uncoverable_days[0].required_doctors, 2);
+
+  const std::set<std::string> reachable(min_cut.reachable_nodes.begin(), min_cut.reachable_nodes.end());
+  EXPECT_EQ(reachable, (std::set<std::string>{"source", "doctor:a", "doctor:b", "doctor-period:a:p2",
+                                              "doctor-period:b:p2", "day:d3"}));
+  int cut_capacity = 0;
+  for (const auto& edge : min_cut.cut_edges) {
+    EXPECT_TRUE(reachable.count(edge.from)) << edge.from;
+    EXPECT_FALSE(reachable.count(edge.to)) << edge.to;
+    cut_capacity += edge.capacity;
+  }
+  EXPECT_EQ(cut_capacity, min_cut.value);
+
+  scheduler::SolveOptions options;
+  options.report_min_cut = false;
+  EXPECT_FALSE(scheduler::Solve(request, options).min_cut.has_value());
+
+  // Merged classes are split back into doctors, so the value still matches the flow.
+  std::mt19937 rng(20260307);
+  for (int round = 0; round < 30; ++round) {
+    const int doctors = 2 + static_cast<int>(rng() % 20);
+    const int periods = 1 + static_cast<int>(rng() % 4);
+    const int days_per_period = 1 + static_cast<int>(rng() % 5);
+    const double density = 0.1 + 0.5 * (rng() % 100) / 100.0;
+    const auto random_result = scheduler::Solve(RandomRoster(rng, doctors, periods, days_per_period, density, 3, 3));
+    EXPECT_EQ(random_result.min_cut.has_value(), !random_result.is_feasible) << "round " << round;
+    if (random_result.min_cut) {
+      EXPECT_EQ(random_result.min_cut->value, random_result.assigned_count) << "round " << round;
+    }
+  }
+}
+
+TEST(SolverFlow, MinCutReportFindsDoctorCapsBehindAGroupLayer) {
+  // x1 and x2 are one person across two sprints, capped at 1 day overall; y
+  // sits alone in a group with a loose cap and is held by its own.
+  const scheduler::ProblemInput input = scheduler::ParseProblemInput(R"({
+    "contractVersion": "1.0",
+    "doctors": [{"id": "x1", "maxTotalDays": 2}, {"id": "x2", "maxTotalDays": 2}, {"id": "y", "maxTotalDays": 1}],
+    "periods": [{"id": "p1", "dayIds": ["d1", "d2"]}, {"id": "p2", "dayIds": ["d3"]}],
+    "demands": [
+      {"dayId": "d1", "requiredDoctors": 2},
+      {"dayId": "d2", "requiredDoctors": 1},
+      {"dayId": "d3", "requiredDoctors": 2}
+    ],
+    "availability": [
+      {"doctorId": "x1", "periodId": "p1", "dayId": "d1"},
+      {"doctorId": "x1", "periodId": "p1", "dayId": "d2"},
+      {"doctorId": "x2", "periodId": "p2", "dayId": "d3"},
+      {"doctorId": "y", "periodId": "p1", "dayId": "d1"}
+    ]
+  })");
+  scheduler::DoctorGroups groups;
+  groups.group_of_doctor = {0, 0, 1};
+  groups.group_cap = {1, 5};
+
+  std::vector<scheduler::GraphBuildResult> graphs;
+  graphs.push_back(scheduler::BuildFlowGraph(input.View(), groups));
+  EXPECT_EQ(scheduler::SolveMaxFlow(graphs[0], scheduler::SolveOptions{}), 2);
+
+  const scheduler::MinCutReport min_cut = scheduler::BuildMinCutReport(graphs, input.View());
+  ASSERT_EQ(min_cut.capped_doctors.size(), 1u);
+  EXPECT_EQ(min_cut.capped_doctors[0].doctor_id, "y");
+  EXPECT_EQ(min_cut.capped_doctors[0].cap, 1);
+  // The saturated x group arc has no problem term and is left out of the value.
+  EXPECT_EQ(min_cut.value, 1);
+}
+
+TEST(SolverFlow, SolveBatchKeepsInputOrderAndIsolatesBadItems) {
+  std::mt19937 rng(20260303);
+  std::vector<std::string> requests;
+  for (int i = 0; i < 12; ++i) {
+    requests.push_back(RandomRoster(rng, 2 + i, 2, 3, 0.5, 2, 3));
+  }
+  requests.insert(requests.begin() + 5, "{invalid-json");
+
+  const auto items = scheduler::SolveBatch(requests);
+
+  ASSERT_EQ(items.size(), requests.size());
+  for (std::size_t i = 0; i < requests.size(); ++i) {
+    SCOPED_TRACE(i);
+    const auto expected = scheduler::Solve(requests[i]);
+    EXPECT_TRUE(items[i].ok);
+    EXPECT_EQ(items[i].result.is_feasible, expected.is_feasible);
+    EXPECT_EQ(items[i].result.assigned_count, expected.assigned_count);
+    EXPECT_EQ(items[i].result.uncovered_days, expected.uncovered_days);
+  }
+  EXPECT_EQ(items[5].result.assigned_count, 0);
+  EXPECT_TRUE(scheduler::SolveBatch({}).empty());
+}
+
+TEST(SolverFlow, InternsIdsOnceAndResolvesThemForAssignments) {
+  const std::string request = R"({
+    "contractVersion": "1.0",
+    "doctors": [{"id": "d1", "maxTotalDays": 2}, {"id": "d2", "maxTotalDays": 1}],
+    "periods": [{"id": "p1", "dayIds": ["day-1", "day-2"]}],
+    "demands": [{"dayId": "day-1", "requiredDoctors": 1}, {"dayId": "day-2", "requiredDoctors": 1}],
+    "availability": [
+      {"doctorId": "d2", "periodId": "p1", "dayId": "day-2"},
+      {"doctorId": "ghost", "periodId": "p1", "dayId": "day-1"},
+      {"doctorId": "d1", "periodId": "p1", "dayId": "day-1"}
+    ]
+  })";
+
+  const scheduler::ProblemInput input = scheduler::ParseProblemInput(request);
+  EXPECT_EQ(input.doctor_ids.size(), 3u);
+  EXPECT_EQ(input.period_ids.size(), 1u);
+  EXPECT_EQ(input.day_ids.size(), 2u);
+  EXPECT_EQ(input.availability[0].day_id, input.demands[1].day_id);
+  EXPECT_EQ(input.doctor_ids.Name(input.availability[1].doctor_id), "ghost");
+  EXPECT_FALSE(input.doctor_ids.Find("d3").has_value());
+
+  const auto result = scheduler::Solve(request);
+  ASSERT_TRUE(result.is_feasible);
+  ASSERT_EQ(result.assignments.size(), 2u);
+  EXPECT_EQ(result.assignments[0].doctor_id, "d1");
+  EXPECT_EQ(result.assignments[1].doctor_id, "d2");
+  EXPECT_EQ(result.assignments[1].day_id, "day-2");
+  EXPECT_EQ(result.assignments[1].period_id, "p1");
+}
+
+TEST(SolverFlow, PresolveMergesIdenticalDoctorsWithoutChangingTheFlow) {
+  std::mt19937 rng(20260420);
+  for (int round = 0; round < 20; ++round) {
+    // Few availability templates over many doctors, so classes form.
+    nlohmann::json request = nlohmann::json::parse(RandomRoster(rng, 4, 3, 3, 0.5, 4, 3));
+    const nlohmann::json templates = request["availability"];
+    request["doctors"] = nlohmann::json::array();
+    request["availability"] = nlohmann::json::array();
+    for (int i = 0; i < 24; ++i) {
+      const std::string doctor_id = "clone-" + std::to_string(i);
+      const std::string template_id = "doc-" + std::to_string(rng() % 4);
+      request["doctors"].push_back({{"id", doctor_id}, {"maxTotalDays", static_cast<int>(rng() % 3)}});
+      for (const auto& item : templates) {
+        if (item["doctorId"] == template_id) {
+          request["availability"].push_back({{"doctorId", doctor_id}, {"periodId", item["periodId"]}, {"dayId", item["dayId"]}});
+        }
+      }
+    }
+    const std::string payload = request.dump();
+    const scheduler::ProblemInput input = scheduler::ParseProblemInput(payload);
+
+    scheduler::GraphBuildResult merged = scheduler::BuildFlowGraph(input);
+    scheduler::GraphBuildResult unmerged = scheduler::BuildFlowGraph(input, scheduler::GraphBuildOptions{false, false});
+    scheduler::GraphBuildResult dense = scheduler::BuildFlowGraph(input, scheduler::GraphBuildOptions{true});
+    EXPECT_LE(merged.network.node_count(), unmerged.network.node_count());
+    EXPECT_LT(unmerged.network.node_count(), dense.network.node_count());
+
+    const int dense_flow = scheduler::SolveMaxFlow(dense, {});
+    EXPECT_EQ(scheduler::SolveMaxFlow(merged, {}), dense_flow) << "round " << round;
+    EXPECT_EQ(scheduler::SolveMaxFlow(unmerged, {}), dense_flow) << "round " << round;
+
+    const auto result = scheduler::Solve(payload);
+    EXPECT_EQ(result.assigned_count, dense_flow);
+
+    std::set<std::tuple<std::string, std::string, std::string>> available;
+    for (const auto& item : request["availability"]) {
+      available.emplace(item["doctorId"], item["periodId"], item["dayId"]);
+    }
+    std::map<std::string, int> doctor_load;
+    std::set<std::pair<std::string, std::string>> doctor_periods;
+    for (const auto& assignment : result.assignments) {
+      EXPECT_EQ(available.count({assignment.doctor_id, assignment.period_id, assignment.day_id}), 1u);
+      EXPECT_TRUE(doctor_periods.emplace(assignment.doctor_id, assignment.period_id).second);
+      ++doctor_load[assignment.doctor_id];
+    }
+    for (const auto& doctor : request["doctors"]) {
+      EXPECT_LE(doctor_load[doctor["id"]], doctor["maxTotalDays"].get<int>());
+    }
+  }
+}
+
+TEST(SolverFlow, SolvesIndependentSitesAsComponentsInAnyThreadCount) {
+  std::mt19937 rng(20260421);
+  for (int round = 0; round < 10; ++round) {
+    // Sites share no doctors and no days; ids get a per-site prefix.
+    nlohmann::json request = {{"contractVersion", "1.0"}};
+    for (const char* section : {"doctors", "periods", "demands", "availability"}) {
+      request[section] = nlohmann::json::array();
+    }
+    const int site_count = 2 + static_cast<int>(rng() % 4);
+    int site_flow = 0;
+    for (int site = 0; site < site_count; ++site) {
+      const std::string site_request = RandomRoster(rng, 5, 2, 3, 0.6, 2, 2);
+      site_flow += scheduler::Solve(site_request).assigned_count;
+
+      std::string prefixed = site_request;
+      for (const std::string token : {"\"doc-", "\"p-", "\"day-"}) {
+        const std::string replacement = "\"s" + std::to_string(site) + "-" + token.substr(1);
+        for (std::size_t at = prefixed.find(token); at != std::string::npos;
+             at = prefixed.find(token, at + replacement.size())) {
+          prefixed.replace(at, token.size(), replacement);
+        }
+      }
+      const nlohmann::json part = nlohmann::json::parse(prefixed);
+      for (const char* section : {"doctors", "periods", "demands", "availability"}) {
+        for (const auto& item : part[section]) {
+          request[section].push_back(item);
+        }
+      }
+    }
+    request["demands"].push_back({{"dayId", "orphan-day"}, {"requiredDoctors", 1}});
+    const std::string payload = request.dump();
+
+    const scheduler::ProblemInput input = scheduler::ParseProblemInput(payload);
+    const auto graphs = scheduler::BuildComponentGraphs(input.View());
+    EXPECT_GE(static_cast<int>(graphs.size()), site_count);
+    EXPECT_EQ(graphs.back().layers.doctor_count, 0);
+    scheduler::GraphBuildResult whole = scheduler::BuildFlowGraph(input);
+    EXPECT_EQ(scheduler::SolveMaxFlow(whole, {}), site_flow) << "round " << round;
+
+    const auto sequential = scheduler::Solve(payload);
+    EXPECT_EQ(sequential.assigned_count, site_flow);
+    EXPECT_FALSE(sequential.is_feasible);
+    ASSERT_FALSE(sequential.uncovered_days.empty());
+    EXPECT_EQ(sequential.uncovered_days.back(), "orphan-day");
+
+    for (const int threads : {0, 4}) {
+      scheduler::SolveOptions options;
+      options.threads = threads;
+      const auto parallel = scheduler::Solve(payload, options);
+      EXPECT_EQ(parallel.assigned_count, sequential.assigned_count);
+      EXPECT_EQ(parallel.uncovered_days, sequential.uncovered_days);
+      ASSERT_EQ(parallel.assignments.size(), sequential.assignments.size());
+      for (std::size_t i = 0; i < parallel.assignments.size(); ++i) {
+        EXPECT_EQ(parallel.assignments[i].doctor_id, sequential.assignments[i].doctor_id);
+        EXPECT_EQ(parallel.assignments[i].day_id, sequential.assignments[i].day_id);
+      }
+    }
+  }
+}
+
+TEST(SolverFlow, StreamingParserMatchesStringParserOnRandomRosters) {
+  std::mt19937 rng(20260419);
+  for (int round = 0; round < 20; ++round) {
+    const std::string request = RandomRoster(rng, 6, 3, 4, 0.5, 2, 3);
+    std::istringstream stream(request);
+
+    const auto from_stream = scheduler::Solve(stream);
+    const auto from_string = scheduler::Solve(request);
+    EXPECT_EQ(from_stream.assigned_count, from_string.assigned_count);
+    EXPECT_EQ(from_stream.is_feasible, from_string.is_feasible);
+    EXPECT_EQ(from_stream.uncovered_days, from_string.uncovered_days);
+  }
+}
+
+TEST(SolverFlow, StreamingParserSkipsUnknownFieldsAndReportsShapeErrors) {
+  const scheduler::ProblemInput input = scheduler::ParseProblemInput(R"({
+    "meta": {"nested": [1, {"deep": [true, null]}]},
+    "contractVersion": "1.0",
+    "doctors": [{"id": "d1", "maxTotalDays": 2, "tags": ["a", {"b": 1}]}],
+    "periods": [{"id": "p1", "dayIds": ["day-1"], "label": null}],
+    "demands": [{"dayId": "day-1", "requiredDoctors": 1}],
+    "availability": [{"doctorId": "d1", "periodId": "p1", "dayId": "day-1", "note": "x"}]
+  })");
+  ASSERT_EQ(input.doctors.size(), 1u);
+  EXPECT_EQ(input.doctors[0].max_total_days, 2);
+  ASSERT_EQ(input.periods.size(), 1u);
+  EXPECT_EQ(input.periods[0].day_count, 1u);
+  EXPECT_EQ(input.availability.size(), 1u);
+
+  const std::string valid_tail = R"("periods": [], "demands": [], "availability": [])";
+  EXPECT_THROW(scheduler::ParseProblemInput(R"({"periods": [], "demands": [], "availability": []})"),
+               nlohmann::json::out_of_range);
+  EXPECT_THROW(scheduler::ParseProblemInput(R"({"doctors": [{"id": "d1"}], )" + valid_tail + "}"),
+               nlohmann::json::out_of_range);
+  EXPECT_THROW(scheduler::ParseProblemInput(R"({"doctors": [{"id": 7, "maxTotalDays": 1}], )" + valid_tail + "}"),
+               nlohmann::json::type_error);
+  EXPECT_THROW(scheduler::ParseProblemInput(R"({"doctors": [{"id": "d1", "maxTotalDays": "2"}], )" + valid_tail + "}"),
+               nlohmann::json::type_error);
+  EXPECT_THROW(scheduler::ParseProblemInput(R"({"doctors": {}, )" + valid_tail + "}"), nlohmann::json::type_error);
+  EXPECT_THROW(scheduler::ParseProblemInput("[]"), nlohmann::json::type_error);
+  EXPECT_THROW(scheduler::ParseProblemInput(R"({"doctors": [], )" + valid_tail + "} trailing"),
+               nlohmann::json::parse_error);
+}
+
+TEST(SolverFlow, StreamingParserReadsNullSectionsAsEmpty) {
+  const scheduler::ProblemInput input = scheduler::ParseProblemInput(R"({
+    "doctors": [{"id": "d1", "maxTotalDays": 2}],
+    "periods": [{"id": "p1", "dayIds": null}, {"id": "p2", "dayIds": ["day-1"]}],
+    "demands": [{"dayId": "day-1", "requiredDoctors": 1}],
+    "availability": null
+  })");
+  ASSERT_EQ(input.periods.size(), 2u);
+  EXPECT_EQ(input.periods[0].day_count, 0u);
+  EXPECT_EQ(input.periods[1].day_count, 1u);
+  EXPECT_TRUE(input.availability.empty());
+
+  const scheduler::SolveResult result =
+      scheduler::Solve(R"({"doctors": null, "periods": null, "demands": [{"dayId": "d", "requiredDoctors": 1}],
+                           "availability": null})");
+  EXPECT_FALSE(result.is_feasible);
+  EXPECT_EQ(result.assigned_count, 0);
+
+  // Null is only an empty list where a list is expected.
+  EXPECT_THROW(
+      scheduler::ParseProblemInput(R"({"doctors": [{"id": "d1", "maxTotalDays": null}], "periods": [],
+                                       "demands": [], "availability": []})"),
+      nlohmann::json::type_error);
 }
 
 TEST(SolverFlow, RejectsInvalidJsonPayload) {
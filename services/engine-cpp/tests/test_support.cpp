@@ -0,0 +1,54 @@
+#include "test_support.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "roster_generator.hpp"
+
+#ifndef DOMAIN_FIXTURES_DIR
+#define DOMAIN_FIXTURES_DIR ""
+#endif
+
+namespace scheduler::test {
+
+std::string ReadFixtureFile(const std::string& file_name) {
+  const std::string full_path = std::string(DOMAIN_FIXTURES_DIR) + "/" + file_name;
+  std::ifstream stream(full_path);
+  if (!stream.is_open()) {
+    throw std::runtime_error("Unable to open fixture file: " + full_path);
+  }
+
+  std::ostringstream buffer;
+  buffer << stream.rdbuf();
+  return buffer.str();
+}
+
+std::string RandomRoster(std::mt19937& rng,
+                         int doctors,
+                         int periods,
+                         int days_per_period,
+                         double density,
+                         int max_required,
+                         int max_total_days,
+                         int min_total_days) {
+  bench::RosterShape shape;
+  shape.doctors = doctors;
+  shape.periods = periods;
+  shape.days_per_period = days_per_period;
+  shape.density = density;
+  shape.seed = rng();
+  shape.min_total_days = min_total_days;
+  shape.max_total_days = max_total_days;
+  shape.max_required = max_required;
+  return bench::GenerateRoster(shape);
+}
+
+std::string RandomSmallRoster(std::mt19937& rng) {
+  const int doctors = 2 + static_cast<int>(rng() % 10);
+  const int periods = 1 + static_cast<int>(rng() % 3);
+  const int days_per_period = 1 + static_cast<int>(rng() % 5);
+  return RandomRoster(rng, doctors, periods, days_per_period, 0.5);
+}
+
+}  // namespace scheduler::test
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <random>
+#include <string>
+
+// Helpers shared by the engine test files.
+namespace scheduler::test {
+
+// Reads a file of packages/domain/fixtures (DOMAIN_FIXTURES_DIR); throws when
+// it cannot be opened.
+std::string ReadFixtureFile(const std::string& file_name);
+
+// SolveRequest JSON from bench/roster_generator, seeded with the next draw of
+// `rng`: doctors "doc-<i>" with caps in [min_total_days, max_total_days],
+// periods "p-<k>" of days "day-<k>-<d>" each requiring [1, max_required]
+// doctors, and every (doctor, period, day) available with probability
+// `density`.
+std::string RandomRoster(std::mt19937& rng,
+                         int doctors,
+                         int periods,
+                         int days_per_period,
+                         double density,
+                         int max_required = 2,
+                         int max_total_days = 3,
+                         int min_total_days = 0);
+
+// RandomRoster with random sizes for property tests: 2-11 doctors, 1-3
+// periods of 1-5 days and density 0.5.
+std::string RandomSmallRoster(std::mt19937& rng);
+
+}  // namespace scheduler::test